@@ -17,12 +17,14 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "tf2_ros/buffer.h"
 #include "nav_msgs/msg/path.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/geometry_utils.hpp"
 
 namespace nav2_core
 {
@@ -76,6 +78,48 @@ public:
   virtual nav_msgs::msg::Path createPlan(
     const geometry_msgs::msg::PoseStamped & start,
     const geometry_msgs::msg::PoseStamped & goal) = 0;
+
+  /**
+   * @brief Method to request that a createPlan() call ongoing in another thread returns
+   * early without a plan, and that later calls do so until cleared. Planners which cannot
+   * be interrupted may ignore it.
+   * @param cancel Whether to request cancellation, or to clear a previous request
+   */
+  virtual void cancelPlanning(const bool & cancel)
+  {
+    (void)cancel;
+  }
+
+  /**
+   * @brief Method to create plans from a starting pose to each of many goals. Planners
+   * able to answer all of them with a single search should override this, by default
+   * each goal is planned to in turn.
+   * @param start The starting pose of the robot
+   * @param goals The goal poses
+   * @param costs The cost of each plan to set, -1 if there is none. In units of the
+   * planner, by default the length of the plan in meters.
+   * @return      The plan to each goal, empty if there is none
+   */
+  virtual std::vector<nav_msgs::msg::Path> createPlans(
+    const geometry_msgs::msg::PoseStamped & start,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    std::vector<double> & costs)
+  {
+    std::vector<nav_msgs::msg::Path> plans(goals.size());
+    costs.assign(goals.size(), -1.0);
+    for (unsigned int i = 0; i != goals.size(); i++) {
+      try {
+        plans[i] = createPlan(start, goals[i]);
+      } catch (const std::exception &) {
+        continue;
+      }
+
+      if (!plans[i].poses.empty()) {
+        costs[i] = nav2_util::geometry_utils::calculate_path_length(plans[i]);
+      }
+    }
+    return plans;
+  }
 };
 
 }  // namespace nav2_core
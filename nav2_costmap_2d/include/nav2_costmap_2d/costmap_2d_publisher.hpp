@@ -40,14 +40,17 @@
 #define NAV2_COSTMAP_2D__COSTMAP_2D_PUBLISHER_HPP_
 
 #include <algorithm>
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <utility>
 
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
 #include "map_msgs/msg/occupancy_grid_update.hpp"
 #include "nav2_msgs/msg/costmap.hpp"
+#include "nav2_msgs/msg/costmap_update.hpp"
 #include "nav2_msgs/srv/get_costmap.hpp"
 #include "tf2/transform_datatypes.h"
 #include "nav2_util/lifecycle_node.hpp"
@@ -63,15 +66,25 @@ namespace nav2_costmap_2d
 class Costmap2DPublisher
 {
 public:
+  // Updates of the raw costmap published between full costmaps, which are kept for
+  // subscribers joining after the last full costmap
+  static constexpr unsigned int RAW_FULL_COSTMAP_PERIOD = 20;
+
   /**
    * @brief  Constructor for the Costmap2DPublisher
+   * @param raw_costmap_updates Publish the raw costmap in full only when its size or origin
+   * changed or every RAW_FULL_COSTMAP_PERIOD publications, with the window updated in between
+   * published on its topic with "_updates" appended
+   * @param compress_raw_costmap_updates Run-length encode the updates of the raw costmap
    */
   Costmap2DPublisher(
     const nav2_util::LifecycleNode::WeakPtr & parent,
     Costmap2D * costmap,
     std::string global_frame,
     std::string topic_name,
-    bool always_send_full_costmap = false);
+    bool always_send_full_costmap = false,
+    bool raw_costmap_updates = false,
+    bool compress_raw_costmap_updates = false);
 
   /**
    * @brief  Destructor
@@ -91,6 +104,7 @@ public:
     costmap_pub_->on_activate();
     costmap_update_pub_->on_activate();
     costmap_raw_pub_->on_activate();
+    costmap_raw_update_pub_->on_activate();
   }
 
   /**
@@ -101,6 +115,7 @@ public:
     costmap_pub_->on_deactivate();
     costmap_update_pub_->on_deactivate();
     costmap_raw_pub_->on_deactivate();
+    costmap_raw_update_pub_->on_deactivate();
   }
 
   /**
@@ -108,6 +123,14 @@ public:
    */
   void on_cleanup() {}
 
+  /**
+   * @brief Get the fully qualified name of the topic the raw costmap is published on
+   */
+  std::string getRawTopicName() const
+  {
+    return costmap_raw_pub_->get_topic_name();
+  }
+
   /** @brief Include the given bounds in the changed-rectangle. */
   void updateBounds(unsigned int x0, unsigned int xn, unsigned int y0, unsigned int yn)
   {
@@ -131,14 +154,46 @@ public:
     return active_;
   }
 
+  /**
+   * @brief Translate costs into occupancy grid values with cost_translation_table_,
+   * vectorized where the target supports it. The table is set up by the first publisher
+   * constructed.
+   * @param costs Costs to translate
+   * @param translated Occupancy grid values to set
+   * @param size Number of costs
+   */
+  static void translateCosts(
+    const unsigned char * costs, int8_t * translated, const unsigned int & size);
+
 private:
   /** @brief Prepare grid_ message for publication. */
   void prepareGrid();
   void prepareCostmap();
-
+  /** @brief Prepare costmap_raw_update_ message of the updated window for publication. */
+  void prepareCostmapUpdate();
+  /** @brief Publish the raw costmap, in full or as an update of the last full one. */
+  void publishRawCostmap();
+  /** @brief Prepare grid_update_ message of the updated window for publication. */
+  void prepareGridUpdate();
   /** @brief Publish the latest full costmap to the new subscriber. */
   // void onNewSubscription(const ros::SingleSubscriberPublisher& pub);
 
+  /**
+   * @brief Publish a message kept between publications. Publishing by reference makes a
+   * copy for intra-process subscriptions, so when there are any the message is moved out
+   * instead, and its data reallocated by the next publication.
+   */
+  template<typename MessageT>
+  void publishKeptMessage(
+    rclcpp_lifecycle::LifecyclePublisher<MessageT> & publisher, MessageT & msg)
+  {
+    if (publisher.get_intra_process_subscription_count() > 0) {
+      publisher.publish(std::make_unique<MessageT>(std::move(msg)));
+    } else {
+      publisher.publish(msg);
+    }
+  }
+
   /** @brief GetCostmap callback service */
   void costmap_service_callback(
     const std::shared_ptr<rmw_request_id_t> request_header,
@@ -156,6 +211,8 @@ private:
   double saved_origin_y_;
   bool active_;
   bool always_send_full_costmap_;
+  bool raw_costmap_updates_;
+  bool compress_raw_costmap_updates_;
 
   // Publisher for translated costmap values as msg::OccupancyGrid used in visualization
   rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::OccupancyGrid>::SharedPtr costmap_pub_;
@@ -164,14 +221,25 @@ private:
 
   // Publisher for raw costmap values as msg::Costmap from layered costmap
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::Costmap>::SharedPtr costmap_raw_pub_;
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CostmapUpdate>::SharedPtr
+    costmap_raw_update_pub_;
 
   // Service for getting the costmaps
   rclcpp::Service<nav2_msgs::srv::GetCostmap>::SharedPtr costmap_service_;
 
   float grid_resolution;
   unsigned int grid_width, grid_height;
-  std::unique_ptr<nav_msgs::msg::OccupancyGrid> grid_;
-  std::unique_ptr<nav2_msgs::msg::Costmap> costmap_raw_;
+  // Messages kept between publications, so that their data is not reallocated each time
+  // unless moved out to intra-process subscriptions
+  nav_msgs::msg::OccupancyGrid grid_;
+  map_msgs::msg::OccupancyGridUpdate grid_update_;
+  nav2_msgs::msg::Costmap costmap_raw_;
+  nav2_msgs::msg::CostmapUpdate costmap_raw_update_;
+  // The last full raw costmap published, which updates apply to
+  unsigned int raw_size_x_, raw_size_y_;
+  double raw_resolution_, raw_origin_x_, raw_origin_y_;
+  uint32_t raw_epoch_;
+  unsigned int raw_updates_count_;
   // Translate from 0-255 values in costmap to -1 to 100 values in message.
   static char * cost_translation_table_;
 };
@@ -45,6 +45,7 @@
 #include "geometry_msgs/msg/polygon.h"
 #include "geometry_msgs/msg/polygon_stamped.h"
 #include "nav2_costmap_2d/costmap_2d_publisher.hpp"
+#include "nav2_costmap_2d/costmap_snapshot_source.hpp"
 #include "nav2_costmap_2d/footprint.hpp"
 #include "nav2_costmap_2d/clear_costmap_service.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
@@ -197,6 +198,16 @@ public:
     return layered_costmap_->getCostmap();
   }
 
+  /**
+   * @brief Get an immutable snapshot of the master costmap, as of its last update.
+   *
+   * Snapshots are taken after each update once one was requested, so that
+   * they can be read without copying or locking the costmap. The same snapshots
+   * are shared with costmap subscribers of this costmap in the same process.
+   * Null if the costmap is not configured.
+   */
+  std::shared_ptr<const Costmap2D> getCostmapSnapshot();
+
   /**
    * @brief  Returns the global frame of the costmap
    * @return The global frame of the costmap
@@ -301,6 +312,7 @@ protected:
   rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::PolygonStamped>::SharedPtr
     footprint_pub_;
   std::unique_ptr<Costmap2DPublisher> costmap_publisher_{nullptr};
+  std::shared_ptr<CostmapSnapshotSource> snapshot_source_{nullptr};
 
   rclcpp::Subscription<geometry_msgs::msg::Polygon>::SharedPtr footprint_sub_;
   rclcpp::Subscription<rcl_interfaces::msg::ParameterEvent>::SharedPtr parameter_sub_;
@@ -331,9 +343,12 @@ protected:
    */
   void getParameters();
   bool always_send_full_costmap_{false};
+  bool raw_costmap_updates_{false};
+  bool compress_raw_costmap_updates_{false};
   std::string footprint_;
   float footprint_padding_{0};
   std::string global_frame_;       ///< The global frame for the costmap
+  int layer_threads_{1};          ///< Threads updating order independent plugins
   int map_height_meters_{0};
   double map_publish_frequency_{0};
   double map_update_frequency_{0};
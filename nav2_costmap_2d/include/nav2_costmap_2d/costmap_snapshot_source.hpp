@@ -0,0 +1,88 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COSTMAP_SNAPSHOT_SOURCE_HPP_
+#define NAV2_COSTMAP_2D__COSTMAP_SNAPSHOT_SOURCE_HPP_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace nav2_costmap_2d
+{
+/**
+ * @class CostmapSnapshotSource
+ * @brief Immutable, reference counted snapshots of a costmap for consumers in the same
+ * process, which read a consistent frame without copying it or locking the costmap.
+ * Sources are found by the topic their costmap is published on, so subscribers to it
+ * in the same process may use them instead.
+ */
+class CostmapSnapshotSource
+{
+public:
+  /**
+   * @brief A constructor
+   */
+  CostmapSnapshotSource();
+
+  /**
+   * @brief Take a snapshot of the costmap, reusing a frame no consumer holds anymore
+   * @param costmap Costmap to copy, locked by the caller
+   */
+  void update(const Costmap2D & costmap);
+
+  /**
+   * @brief Get the latest snapshot, marking the source as in use
+   * @return Snapshot, or nullptr if none was taken yet
+   */
+  std::shared_ptr<const Costmap2D> getSnapshot();
+
+  /**
+   * @brief If a snapshot was ever requested, so that they should be taken on updates
+   */
+  bool isRequested() const
+  {
+    return requested_;
+  }
+
+  /**
+   * @brief Make a source findable by the topic of its costmap, for as long as it exists
+   * @param topic_name Fully qualified name of the topic
+   * @param source Source of snapshots of the costmap published on it
+   */
+  static void advertise(
+    const std::string & topic_name, const std::shared_ptr<CostmapSnapshotSource> & source);
+
+  /**
+   * @brief Find the source of the costmap published on a topic in this process
+   * @param topic_name Fully qualified name of the topic
+   * @return Source, or nullptr if the costmap is not published in this process
+   */
+  static std::shared_ptr<CostmapSnapshotSource> find(const std::string & topic_name);
+
+protected:
+  std::mutex mutex_;
+  std::shared_ptr<const Costmap2D> snapshot_;
+  // Frames snapshots are taken into, all held here and consumers holding some
+  std::vector<std::shared_ptr<Costmap2D>> frames_;
+  std::atomic<bool> requested_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COSTMAP_SNAPSHOT_SOURCE_HPP_
@@ -17,17 +17,22 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_snapshot_source.hpp"
 #include "nav2_msgs/msg/costmap.hpp"
+#include "nav2_msgs/msg/costmap_update.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 
 namespace nav2_costmap_2d
 {
 /**
  * @class CostmapSubscriber
- * @brief Subscribes to the costmap via a ros topic
+ * @brief Subscribes to the costmap via a ros topic, and to the updates of it published
+ * on the topic with "_updates" appended, if any
  */
 class CostmapSubscriber
 {
@@ -56,21 +61,59 @@ public:
    */
   std::shared_ptr<Costmap2D> getCostmap();
 
+  /**
+   * @brief Get an immutable snapshot of the costmap, shared without copying by the
+   * costmap publisher if in the same process, or else converted from the topic
+   */
+  std::shared_ptr<const Costmap2D> getCostmapSnapshot();
+
 protected:
   /**
    * @brief Convert an occ grid message into a costmap object
    */
   void toCostmap2D();
+  /**
+   * @brief Apply the received updates which follow those already applied to the costmap,
+   * in sequence. Once one is missing or malformed, the later ones are dropped until the
+   * next full costmap.
+   */
+  void applyUpdates();
+  /**
+   * @brief Copy the window of an update into the costmap, row by row
+   * @return false if the update is malformed, in which case it is not applied
+   */
+  bool applyUpdate(const nav2_msgs::msg::CostmapUpdate & update);
+  /**
+   * @brief Whether a costmap epoch is later than another, allowing for wrap around
+   */
+  static bool isLaterEpoch(const uint32_t & epoch, const uint32_t & other);
   /**
    * @brief Callback for the costmap topic
    */
   void costmapCallback(const nav2_msgs::msg::Costmap::SharedPtr msg);
+  /**
+   * @brief Callback for the costmap updates topic
+   */
+  void costmapUpdateCallback(const nav2_msgs::msg::CostmapUpdate::SharedPtr msg);
 
   std::shared_ptr<Costmap2D> costmap_;
+  // Source of snapshots of the costmap, if published in this process
+  std::weak_ptr<CostmapSnapshotSource> snapshot_source_;
+  // Snapshot of costmap_, taken again once messages were received since
+  std::shared_ptr<const Costmap2D> snapshot_;
+  bool snapshot_outdated_{true};
+  // Full costmap not yet converted into costmap_
   nav2_msgs::msg::Costmap::SharedPtr costmap_msg_;
+  // Updates not yet applied, and the full costmap and number of updates costmap_ is at
+  std::vector<nav2_msgs::msg::CostmapUpdate::SharedPtr> update_msgs_;
+  uint32_t costmap_epoch_{0};
+  unsigned int updates_count_{0};
+  bool updates_lost_{false};
+  std::mutex msgs_mutex_;
   std::string topic_name_;
   bool costmap_received_{false};
   rclcpp::Subscription<nav2_msgs::msg::Costmap>::SharedPtr costmap_sub_;
+  rclcpp::Subscription<nav2_msgs::msg::CostmapUpdate>::SharedPtr costmap_update_sub_;
 };
 
 }  // namespace nav2_costmap_2d
@@ -41,6 +41,9 @@
 #include <map>
 #include <vector>
 #include <mutex>
+#include <algorithm>
+#include <string>
+#include <cstdint>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/layer.hpp"
@@ -73,6 +76,66 @@ public:
   unsigned int src_x_, src_y_;
 };
 
+/**
+ * @class InflationWavefront
+ * @brief Storage for a wavefront inflating obstacles over a region of the costmap, kept
+ * between updates so that it is neither reallocated nor fully cleared every cycle
+ */
+class InflationWavefront
+{
+public:
+  /**
+   * @brief  Start a new wavefront, with every cell of its region unvisited
+   * @param  min_i The x min map coord of the region cells may be visited in
+   * @param  min_j The y min map coord of the region cells may be visited in
+   * @param  size_x The x size of the region
+   * @param  size_y The y size of the region
+   */
+  void reset(unsigned int min_i, unsigned int min_j, unsigned int size_x, unsigned int size_y)
+  {
+    min_i_ = min_i;
+    min_j_ = min_j;
+    size_x_ = size_x;
+    if (seen_.size() < size_x * size_y) {
+      seen_.resize(size_x * size_y, 0);
+    }
+
+    // Cells are seen if marked with the current epoch, so only clear when it wraps around
+    if (++epoch_ == 0) {
+      std::fill(seen_.begin(), seen_.end(), 0);
+      epoch_ = 1;
+    }
+  }
+
+  /**
+   * @brief  Whether a cell was visited by this wavefront
+   * @param  mx The x coordinate of the cell in the cost map
+   * @param  my The y coordinate of the cell in the cost map
+   */
+  inline bool isSeen(unsigned int mx, unsigned int my) const
+  {
+    return seen_[(my - min_j_) * size_x_ + mx - min_i_] == epoch_;
+  }
+
+  /**
+   * @brief  Mark a cell as visited by this wavefront
+   * @param  mx The x coordinate of the cell in the cost map
+   * @param  my The y coordinate of the cell in the cost map
+   */
+  inline void see(unsigned int mx, unsigned int my)
+  {
+    seen_[(my - min_j_) * size_x_ + mx - min_i_] = epoch_;
+  }
+
+  // Cells to visit, in a list per distance to the nearest obstacle
+  std::vector<std::vector<CellData>> cells_;
+
+private:
+  unsigned int min_i_{0}, min_j_{0}, size_x_{0};
+  std::vector<unsigned char> seen_;
+  unsigned char epoch_{0};
+};
+
 /**
  * @class InflationLayer
  * @brief Layer to convolve costmap by robot's radius or footprint to prevent
@@ -81,6 +144,13 @@ public:
 class InflationLayer : public Layer
 {
 public:
+  enum class InflationMethod
+  {
+    WAVEFRONT,
+    DISTANCE_TRANSFORM,
+    INCREMENTAL_DISTANCE_TRANSFORM
+  };
+
   /**
     * @brief A constructor
     */
@@ -231,24 +301,139 @@ private:
     return layered_costmap_->getCostmap()->cellDistance(world_dist);
   }
 
+  /**
+   * @brief Start a wavefront from the obstacles which may affect the costs of a window
+   * @param master_grid The master costmap grid to inflate
+   * @param wavefront Wavefront to start
+   * @param min_i X min map coord of the window to update
+   * @param min_j Y min map coord of the window to update
+   * @param max_i X max map coord of the window to update
+   * @param max_j Y max map coord of the window to update
+   */
+  void enqueueObstacles(
+    const nav2_costmap_2d::Costmap2D & master_grid, InflationWavefront & wavefront,
+    int min_i, int min_j, int max_i, int max_j);
+
+  /**
+   * @brief Propagate a wavefront by increasing distance, updating the costs of a window
+   * @param master_grid The master costmap grid to update
+   * @param wavefront Wavefront started by enqueueObstacles() with the same window
+   * @param min_i X min map coord of the window to update
+   * @param min_j Y min map coord of the window to update
+   * @param max_i X max map coord of the window to update
+   * @param max_j Y max map coord of the window to update
+   */
+  void propagateCosts(
+    nav2_costmap_2d::Costmap2D & master_grid, InflationWavefront & wavefront,
+    int min_i, int min_j, int max_i, int max_j);
+
+  /**
+   * @brief Update the costs of a window from the exact Euclidean distance of each of its cells
+   * to the nearest obstacle, by a separable distance transform linear in the window's size
+   * @param master_grid The master costmap grid to update
+   * @param min_i X min map coord of the window to update
+   * @param min_j Y min map coord of the window to update
+   * @param max_i X max map coord of the window to update
+   * @param max_j Y max map coord of the window to update
+   */
+  void inflateByDistanceTransform(
+    nav2_costmap_2d::Costmap2D & master_grid,
+    int min_i, int min_j, int max_i, int max_j);
+
+  /**
+   * @brief Update the costs of a window as the distance transform does, but from costs kept
+   * between updates and only recomputed around the obstacles which changed since the last
+   * @param master_grid The master costmap grid to update
+   * @param min_i X min map coord of the window to update
+   * @param min_j Y min map coord of the window to update
+   * @param max_i X max map coord of the window to update
+   * @param max_j Y max map coord of the window to update
+   */
+  void inflateIncrementally(
+    nav2_costmap_2d::Costmap2D & master_grid,
+    int min_i, int min_j, int max_i, int max_j);
+
+  /**
+   * @brief Exact distance transform of the obstacles around a window, given row by row as
+   * the costs of its cells
+   * @param size_x Size of the map in X
+   * @param size_y Size of the map in Y
+   * @param min_i X min map coord of the window
+   * @param min_j Y min map coord of the window
+   * @param max_i X max map coord of the window
+   * @param max_j Y max map coord of the window
+   * @param is_obstacle Whether the cell of a map index is an obstacle
+   * @param apply_row Called with each row of the window and its costs, concurrently
+   * for different rows
+   */
+  template<typename IsObstacleT, typename ApplyRowT>
+  void distanceTransform(
+    const int size_x, const int size_y, int min_i, int min_j, int max_i, int max_j,
+    const IsObstacleT & is_obstacle, const ApplyRowT & apply_row);
+
+  /**
+   * @brief Shift a map sized grid as the map's origin moved by whole cells, zeroing
+   * the cells which entered it
+   * @param grid Grid to shift
+   * @param size_x Size of the map in X
+   * @param size_y Size of the map in Y
+   * @param dx Cells the origin moved in X
+   * @param dy Cells the origin moved in Y
+   */
+  void shiftGrid(
+    std::vector<unsigned char> & grid, int size_x, int size_y, int dx, int dy);
+
+  /**
+   * @brief Combine inflated costs into a row of the master grid, with the same rule
+   * for unknown cells as the wavefront, branch free so it vectorizes
+   * @param master_row Row of the master grid to update
+   * @param costs Inflated costs of its cells
+   * @param size Number of cells
+   */
+  inline void applyCosts(unsigned char * master_row, const unsigned char * costs, int size)
+  {
+    const unsigned char unknown_threshold =
+      inflate_unknown_ ? FREE_SPACE + 1 : INSCRIBED_INFLATED_OBSTACLE;
+    for (int i = 0; i < size; i++) {
+      const unsigned char cost = costs[i];
+      const unsigned char old_cost = master_row[i];
+      master_row[i] = (old_cost == NO_INFORMATION && cost >= unknown_threshold) ?
+        cost : std::max(old_cost, cost);
+    }
+  }
+
   /**
    * @brief Enqueue new cells in cache distance update search
    */
   inline void enqueue(
-    unsigned int index, unsigned int mx, unsigned int my,
+    InflationWavefront & wavefront, unsigned int index, unsigned int mx, unsigned int my,
     unsigned int src_x, unsigned int src_y);
 
   double inflation_radius_, inscribed_radius_, cost_scaling_factor_;
   bool inflate_unknown_, inflate_around_unknown_;
   unsigned int cell_inflation_radius_;
   unsigned int cached_cell_inflation_radius_;
-  std::vector<std::vector<CellData>> inflation_cells_;
+  int inflation_threads_;
+  InflationMethod inflation_method_;
+  // One per thread, the first is used when inflating serially
+  std::vector<InflationWavefront> wavefronts_;
 
   double resolution_;
 
-  std::vector<bool> seen_;
-
   std::vector<unsigned char> cached_costs_;
+  // Cost by squared distance in cells, 0 beyond the inflation radius
+  std::vector<unsigned char> squared_distance_costs_;
+  // Distance to the nearest obstacle in the same column, for the distance transform
+  std::vector<uint16_t> column_distances_;
+  // Incremental inflation: obstacles and costs of every cell as of the last update, when
+  // the map's origin was last_origin_, and the tiles to recompute
+  static constexpr int TILE_SIZE = 32;
+  std::vector<unsigned char> obstacles_;
+  std::vector<unsigned char> inflated_costs_;
+  std::vector<unsigned char> changed_tiles_;
+  std::vector<unsigned char> dirty_tiles_;
+  std::vector<unsigned char> shift_buffer_;
+  double last_origin_x_, last_origin_y_;
   std::vector<double> cached_distances_;
   std::vector<std::vector<int>> distance_matrix_;
   unsigned int cache_length_;
@@ -90,6 +90,13 @@ public:
    */
   virtual bool isClearable() = 0;
 
+  /**
+   * @brief If this layer may be updated concurrently with neighboring such layers. Its
+   *        updateBounds() must only expand the bounds, and its updateCosts() only raise
+   *        costs as CostmapLayer::updateWithMax() does, without reading the master grid.
+   */
+  virtual bool isOrderIndependent() {return false;}
+
   /**
    * @brief This is called by the LayeredCostmap to poll this plugin as to how
    *        much of the costmap it needs to update. Each layer can increase
@@ -38,6 +38,7 @@
 #ifndef NAV2_COSTMAP_2D__LAYERED_COSTMAP_HPP_
 #define NAV2_COSTMAP_2D__LAYERED_COSTMAP_HPP_
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -57,6 +58,17 @@ class Layer;
 class LayeredCostmap
 {
 public:
+  /**
+   * @brief Time a layer took in the last update, in seconds
+   */
+  struct LayerTiming
+  {
+    std::string name;
+    double update_bounds_time;
+    // Including merging its own grid, when updated concurrently
+    double update_costs_time;
+  };
+
   /**
    * @brief  Constructor for a costmap
    */
@@ -178,6 +190,24 @@ public:
     *yn = byn_;
   }
 
+  /**
+   * @brief Set the number of threads updating plugins. With more than one, consecutive
+   * order independent plugins are updated concurrently, each into its own grid, which are
+   * then merged in order into the costmap.
+   */
+  void setLayerThreads(int layer_threads)
+  {
+    layer_threads_ = std::max(layer_threads, 1);
+  }
+
+  /**
+   * @brief Get the time each plugin, then each filter, took in the last update
+   */
+  const std::vector<LayerTiming> & getLayerTimings() const
+  {
+    return layer_timings_;
+  }
+
   /**
    * @brief if the costmap is initialized
    */
@@ -213,6 +243,30 @@ public:
   bool isOutofBounds(double robot_x, double robot_y);
 
 private:
+  /**
+   * @brief Update the bounds of a layer, warning if it shrunk them, and time it
+   */
+  void updateLayerBounds(
+    Layer & layer, const char * kind, double robot_x, double robot_y, double robot_yaw,
+    double * minx, double * miny, double * maxx, double * maxy, LayerTiming & timing);
+
+  /**
+   * @brief Get the end of the group of plugins from first which are updated concurrently
+   */
+  size_t getPluginGroupEnd(size_t first);
+
+  /**
+   * @brief Run tasks concurrently on the layer threads, rethrowing the first exception
+   */
+  template<typename TaskT>
+  void runConcurrently(size_t num_tasks, const TaskT & task);
+
+  /**
+   * @brief Merge the window of a grid into the costmap as CostmapLayer::updateWithMax() does
+   */
+  static void mergeWithMax(
+    Costmap2D & master_grid, const Costmap2D & grid, int min_i, int min_j, int max_i, int max_j);
+
   // primary_costmap_ is a bottom costmap used by plugins when costmap filters were enabled.
   // combined_costmap_ is a final costmap where all results produced by plugins and filters (if any)
   // to be merged.
@@ -234,6 +288,11 @@ private:
   bool size_locked_;
   double circumscribed_radius_, inscribed_radius_;
   std::vector<geometry_msgs::msg::Point> footprint_;
+
+  int layer_threads_;
+  std::vector<LayerTiming> layer_timings_;
+  // Grids of the plugins updated concurrently, by index of the plugin
+  std::vector<std::unique_ptr<Costmap2D>> plugin_grids_;
 };
 
 }  // namespace nav2_costmap_2d
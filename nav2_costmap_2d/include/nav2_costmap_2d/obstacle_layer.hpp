@@ -131,6 +131,11 @@ public:
    */
   virtual bool isClearable() {return true;}
 
+  /**
+   * @brief If this layer may be updated concurrently with others, when not overwriting
+   */
+  virtual bool isOrderIndependent() {return combination_method_ != 0;}
+
   /**
    * @brief triggers the update of observations buffer
    */
@@ -123,6 +123,11 @@ public:
    */
   virtual bool isClearable() {return true;}
 
+  /**
+   * @brief If this layer may be updated concurrently with others
+   */
+  virtual bool isOrderIndependent() {return true;}
+
   /**
    * @brief Handle an incoming Range message to populate into costmap
    */
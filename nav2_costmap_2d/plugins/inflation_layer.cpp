@@ -37,10 +37,14 @@
  *********************************************************************/
 #include "nav2_costmap_2d/inflation_layer.hpp"
 
+#include <omp.h>
+
+#include <cmath>
 #include <limits>
 #include <map>
 #include <vector>
 #include <algorithm>
+#include <string>
 #include <utility>
 
 #include "nav2_costmap_2d/costmap_math.hpp"
@@ -65,7 +69,11 @@ InflationLayer::InflationLayer()
   inflate_around_unknown_(false),
   cell_inflation_radius_(0),
   cached_cell_inflation_radius_(0),
+  inflation_threads_(1),
+  inflation_method_(InflationMethod::WAVEFRONT),
   resolution_(0),
+  last_origin_x_(0.0),
+  last_origin_y_(0.0),
   cache_length_(0),
   last_min_x_(std::numeric_limits<double>::lowest()),
   last_min_y_(std::numeric_limits<double>::lowest()),
@@ -88,6 +96,8 @@ InflationLayer::onInitialize()
   declareParameter("cost_scaling_factor", rclcpp::ParameterValue(10.0));
   declareParameter("inflate_unknown", rclcpp::ParameterValue(false));
   declareParameter("inflate_around_unknown", rclcpp::ParameterValue(false));
+  declareParameter("inflation_threads", rclcpp::ParameterValue(1));
+  declareParameter("inflation_method", rclcpp::ParameterValue(std::string("WAVEFRONT")));
 
   {
     auto node = node_.lock();
@@ -99,10 +109,30 @@ InflationLayer::onInitialize()
     node->get_parameter(name_ + "." + "cost_scaling_factor", cost_scaling_factor_);
     node->get_parameter(name_ + "." + "inflate_unknown", inflate_unknown_);
     node->get_parameter(name_ + "." + "inflate_around_unknown", inflate_around_unknown_);
+    node->get_parameter(name_ + "." + "inflation_threads", inflation_threads_);
+
+    std::string inflation_method_name;
+    node->get_parameter(name_ + "." + "inflation_method", inflation_method_name);
+    std::transform(
+      inflation_method_name.begin(), inflation_method_name.end(),
+      inflation_method_name.begin(), ::toupper);
+    if (inflation_method_name == "WAVEFRONT") {
+      inflation_method_ = InflationMethod::WAVEFRONT;
+    } else if (inflation_method_name == "DISTANCE_TRANSFORM") {
+      inflation_method_ = InflationMethod::DISTANCE_TRANSFORM;
+    } else if (inflation_method_name == "INCREMENTAL_DISTANCE_TRANSFORM") {
+      inflation_method_ = InflationMethod::INCREMENTAL_DISTANCE_TRANSFORM;
+    } else {
+      RCLCPP_ERROR(
+        logger_, "%s: Invalid inflation method: %s. Defaulting to WAVEFRONT.",
+        name_.c_str(), inflation_method_name.c_str());
+      inflation_method_ = InflationMethod::WAVEFRONT;
+    }
   }
 
   current_ = true;
-  seen_.clear();
+  wavefronts_.clear();
+  wavefronts_.resize(std::max(inflation_threads_, 1));
   cached_distances_.clear();
   cached_costs_.clear();
   need_reinflation_ = false;
@@ -117,7 +147,6 @@ InflationLayer::matchSize()
   resolution_ = costmap->getResolution();
   cell_inflation_radius_ = cellDistance(inflation_radius_);
   computeCaches();
-  seen_ = std::vector<bool>(costmap->getSizeInCellsX() * costmap->getSizeInCellsY(), false);
 }
 
 void
@@ -174,44 +203,369 @@ InflationLayer::updateCosts(
 {
   std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
   if (!enabled_ || (cell_inflation_radius_ == 0)) {
+    // Obstacles will not be tracked meanwhile
+    obstacles_.clear();
     return;
   }
 
-  // make sure the inflation list is empty at the beginning of the cycle (should always be true)
-  for (auto & dist : inflation_cells_) {
-    RCLCPP_FATAL_EXPRESSION(
-      logger_,
-      !dist.empty(), "The inflation list must be empty at the beginning of inflation");
+  min_i = std::max(0, min_i);
+  min_j = std::max(0, min_j);
+  max_i = std::min(static_cast<int>(master_grid.getSizeInCellsX()), max_i);
+  max_j = std::min(static_cast<int>(master_grid.getSizeInCellsY()), max_j);
+  if (min_i >= max_i || min_j >= max_j) {
+    current_ = true;
+    return;
+  }
+
+  if (inflation_method_ == InflationMethod::DISTANCE_TRANSFORM) {
+    inflateByDistanceTransform(master_grid, min_i, min_j, max_i, max_j);
+    current_ = true;
+    return;
+  }
+
+  if (inflation_method_ == InflationMethod::INCREMENTAL_DISTANCE_TRANSFORM) {
+    inflateIncrementally(master_grid, min_i, min_j, max_i, max_j);
+    current_ = true;
+    return;
   }
 
+  // Split the window into bands of rows inflated concurrently, each from the obstacles
+  // within the inflation radius of it, when they are tall enough for that halo to pay off.
+  // The wavefronts claim cells first come, first served, so obstacles beyond a band's halo
+  // that the serial wavefront lets claim a halo cell first may, rarely, leave a band cell
+  // with the cost of another obstacle within the radius than in the serial update.
+  const int radius = static_cast<int>(cell_inflation_radius_);
+  const int num_bands = std::min(
+    static_cast<int>(wavefronts_.size()), (max_j - min_j) / radius);
+
+  if (num_bands <= 1) {
+    enqueueObstacles(master_grid, wavefronts_[0], min_i, min_j, max_i, max_j);
+    propagateCosts(master_grid, wavefronts_[0], min_i, min_j, max_i, max_j);
+  } else {
+    #pragma omp parallel num_threads(num_bands)
+    {
+      // Fewer threads than requested may be given
+      const int band = omp_get_thread_num();
+      const int band_height = (max_j - min_j + omp_get_num_threads() - 1) / omp_get_num_threads();
+      const int band_min_j = std::min(min_j + band * band_height, max_j);
+      const int band_max_j = std::min(band_min_j + band_height, max_j);
+      InflationWavefront & wavefront = wavefronts_[band];
+
+      // Bands only write their own cells, but all obstacles must be found before any
+      // unknown cell in another's halo may be overwritten
+      if (band_min_j < band_max_j) {
+        enqueueObstacles(master_grid, wavefront, min_i, band_min_j, max_i, band_max_j);
+      }
+      #pragma omp barrier
+      if (band_min_j < band_max_j) {
+        propagateCosts(master_grid, wavefront, min_i, band_min_j, max_i, band_max_j);
+      }
+    }
+  }
+
+  current_ = true;
+}
+
+void
+InflationLayer::inflateByDistanceTransform(
+  nav2_costmap_2d::Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j)
+{
   unsigned char * master_array = master_grid.getCharMap();
-  unsigned int size_x = master_grid.getSizeInCellsX(), size_y = master_grid.getSizeInCellsY();
+  const unsigned int size_x = master_grid.getSizeInCellsX();
+
+  distanceTransform(
+    master_grid.getSizeInCellsX(), master_grid.getSizeInCellsY(), min_i, min_j, max_i, max_j,
+    [&](const unsigned int & index) {
+      return master_array[index] == LETHAL_OBSTACLE ||
+      (inflate_around_unknown_ && master_array[index] == NO_INFORMATION);
+    },
+    [&](const int & j, const unsigned char * costs) {
+      applyCosts(master_array + j * size_x + min_i, costs, max_i - min_i);
+    });
+}
+
+void
+InflationLayer::inflateIncrementally(
+  nav2_costmap_2d::Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j)
+{
+  unsigned char * master_array = master_grid.getCharMap();
+  const int size_x = static_cast<int>(master_grid.getSizeInCellsX());
+  const int size_y = static_cast<int>(master_grid.getSizeInCellsY());
+  const int radius = static_cast<int>(cell_inflation_radius_);
+  const int tiles_x = (size_x + TILE_SIZE - 1) / TILE_SIZE;
+  const int tiles_y = (size_y + TILE_SIZE - 1) / TILE_SIZE;
+  changed_tiles_.assign(tiles_x * tiles_y, 0);
+  auto markChanged = [&](int cells_min_i, int cells_min_j, int cells_max_i, int cells_max_j) {
+      for (int ty = cells_min_j / TILE_SIZE; ty <= (cells_max_j - 1) / TILE_SIZE; ty++) {
+        for (int tx = cells_min_i / TILE_SIZE; tx <= (cells_max_i - 1) / TILE_SIZE; tx++) {
+          changed_tiles_[ty * tiles_x + tx] = 1;
+        }
+      }
+    };
+
+  // Only obstacles within the inflation radius of the window may have changed since the
+  // last update, unless the whole map is new or has moved
+  int check_min_i = std::max(0, min_i - radius);
+  int check_min_j = std::max(0, min_j - radius);
+  int check_max_i = std::min(size_x, max_i + radius);
+  int check_max_j = std::min(size_y, max_j + radius);
+  const double origin_x = master_grid.getOriginX();
+  const double origin_y = master_grid.getOriginY();
+
+  if (obstacles_.size() != static_cast<size_t>(size_x * size_y)) {
+    obstacles_.assign(size_x * size_y, 0);
+    inflated_costs_.assign(size_x * size_y, 0);
+    check_min_i = check_min_j = 0;
+    check_max_i = size_x;
+    check_max_j = size_y;
+  } else if (origin_x != last_origin_x_ || origin_y != last_origin_y_) {
+    // Rolling windows move by whole cells, as the master grid copying its overlap
+    const int dx = static_cast<int>(std::lround((origin_x - last_origin_x_) / resolution_));
+    const int dy = static_cast<int>(std::lround((origin_y - last_origin_y_) / resolution_));
+    shiftGrid(obstacles_, size_x, size_y, dx, dy);
+    shiftGrid(inflated_costs_, size_x, size_y, dx, dy);
+
+    // Obstacles left the map and cells entered it along its edges
+    if (dx != 0) {
+      const int width = std::min(std::abs(dx), size_x);
+      markChanged(0, 0, width, size_y);
+      markChanged(size_x - width, 0, size_x, size_y);
+    }
+    if (dy != 0) {
+      const int height = std::min(std::abs(dy), size_y);
+      markChanged(0, 0, size_x, height);
+      markChanged(0, size_y - height, size_x, size_y);
+    }
+    check_min_i = check_min_j = 0;
+    check_max_i = size_x;
+    check_max_j = size_y;
+  }
+  last_origin_x_ = origin_x;
+  last_origin_y_ = origin_y;
+
+  // Update obstacles from the master grid, noting the tiles in which any changed
+  for (int j = check_min_j; j < check_max_j; j++) {
+    const unsigned char * costs = master_array + j * size_x;
+    unsigned char * obstacles = &obstacles_[j * size_x];
+    for (int i = check_min_i; i < check_max_i; i++) {
+      const unsigned char obstacle = costs[i] == LETHAL_OBSTACLE ||
+        (inflate_around_unknown_ && costs[i] == NO_INFORMATION);
+      if (obstacle != obstacles[i]) {
+        obstacles[i] = obstacle;
+        changed_tiles_[(j / TILE_SIZE) * tiles_x + i / TILE_SIZE] = 1;
+      }
+    }
+  }
+
+  // Costs may only have changed within the inflation radius of those tiles
+  const int tile_radius = (radius + TILE_SIZE - 1) / TILE_SIZE;
+  dirty_tiles_.assign(tiles_x * tiles_y, 0);
+  for (int ty = 0; ty < tiles_y; ty++) {
+    for (int tx = 0; tx < tiles_x; tx++) {
+      if (!changed_tiles_[ty * tiles_x + tx]) {
+        continue;
+      }
+      for (int y = std::max(0, ty - tile_radius); y <= std::min(tiles_y - 1, ty + tile_radius);
+        y++)
+      {
+        std::fill(
+          dirty_tiles_.begin() + y * tiles_x + std::max(0, tx - tile_radius),
+          dirty_tiles_.begin() + y * tiles_x + std::min(tiles_x - 1, tx + tile_radius) + 1, 1);
+      }
+    }
+  }
 
-  if (seen_.size() != size_x * size_y) {
-    RCLCPP_WARN(
-      logger_, "InflationLayer::updateCosts(): seen_ vector size is wrong");
-    seen_ = std::vector<bool>(size_x * size_y, false);
+  // Recompute them over rectangles of dirty tiles, grown down from runs along rows of tiles
+  for (int ty = 0; ty < tiles_y; ty++) {
+    int tx = 0;
+    while (tx < tiles_x) {
+      if (!dirty_tiles_[ty * tiles_x + tx]) {
+        tx++;
+        continue;
+      }
+      const int run_min_tx = tx;
+      while (tx < tiles_x && dirty_tiles_[ty * tiles_x + tx]) {
+        tx++;
+      }
+      const int run_max_tx = tx;
+
+      int run_max_ty = ty + 1;
+      while (run_max_ty < tiles_y &&
+        std::all_of(
+          dirty_tiles_.begin() + run_max_ty * tiles_x + run_min_tx,
+          dirty_tiles_.begin() + run_max_ty * tiles_x + run_max_tx,
+          [](const unsigned char & dirty) {return dirty;}))
+      {
+        std::fill(
+          dirty_tiles_.begin() + run_max_ty * tiles_x + run_min_tx,
+          dirty_tiles_.begin() + run_max_ty * tiles_x + run_max_tx, 0);
+        run_max_ty++;
+      }
+
+      const int rect_min_i = run_min_tx * TILE_SIZE;
+      const int rect_max_i = std::min(run_max_tx * TILE_SIZE, size_x);
+      distanceTransform(
+        size_x, size_y, rect_min_i, ty * TILE_SIZE, rect_max_i,
+        std::min(run_max_ty * TILE_SIZE, size_y),
+        [&](const unsigned int & index) {return obstacles_[index];},
+        [&](const int & j, const unsigned char * costs) {
+          std::copy(
+            costs, costs + rect_max_i - rect_min_i, &inflated_costs_[j * size_x + rect_min_i]);
+        });
+    }
   }
 
-  std::fill(begin(seen_), end(seen_), false);
+  // The window was reset by the layered costmap, so all of its costs are written
+  for (int j = min_j; j < max_j; j++) {
+    applyCosts(
+      master_array + j * size_x + min_i, &inflated_costs_[j * size_x + min_i], max_i - min_i);
+  }
+}
+
+void
+InflationLayer::shiftGrid(
+  std::vector<unsigned char> & grid, int size_x, int size_y, int dx, int dy)
+{
+  // Cell (i, j) now holds what was at (i + dx, j + dy), or 0 if that was off the map
+  shift_buffer_.assign(size_x * size_y, 0);
+  const int min_i = std::max(0, -dx);
+  const int max_i = std::min(size_x, size_x - dx);
+  for (int j = std::max(0, -dy); j < std::min(size_y, size_y - dy); j++) {
+    if (min_i < max_i) {
+      std::copy(
+        grid.begin() + (j + dy) * size_x + min_i + dx,
+        grid.begin() + (j + dy) * size_x + max_i + dx,
+        shift_buffer_.begin() + j * size_x + min_i);
+    }
+  }
+  grid.swap(shift_buffer_);
+}
+
+template<typename IsObstacleT, typename ApplyRowT>
+void
+InflationLayer::distanceTransform(
+  const int size_x, const int size_y, int min_i, int min_j, int max_i, int max_j,
+  const IsObstacleT & is_obstacle, const ApplyRowT & apply_row)
+{
+  const int radius = static_cast<int>(cell_inflation_radius_);
+
+  // Only obstacles within the inflation radius of the window may affect its costs
+  const int obs_min_i = std::max(0, min_i - radius);
+  const int obs_min_j = std::max(0, min_j - radius);
+  const int obs_size_x = std::min(size_x, max_i + radius) - obs_min_i;
+  const int obs_size_y = std::min(size_y, max_j + radius) - obs_min_j;
+  column_distances_.resize(obs_size_x * obs_size_y);
+
+  // Distances beyond the radius are all equivalent, so are capped just past it
+  const uint16_t max_distance = static_cast<uint16_t>(std::min(radius + 1, 0x7FFF));
+  const int max_squared_distance = radius * radius + 1;
+  const int num_threads = std::max(inflation_threads_, 1);
+  const int num_columns_blocks = std::min(num_threads, obs_size_x);
+
+  #pragma omp parallel num_threads(num_threads) if (num_threads > 1)
+  {
+    // Distance to the nearest obstacle above then below in each column, with a pass down
+    // and one up the rows, which threads split by blocks of columns
+    #pragma omp for schedule(static)
+    for (int block = 0; block < num_columns_blocks; block++) {
+      const int block_min_i = block * obs_size_x / num_columns_blocks;
+      const int block_max_i = (block + 1) * obs_size_x / num_columns_blocks;
+      for (int j = 0; j < obs_size_y; j++) {
+        const unsigned int row_index = (obs_min_j + j) * size_x + obs_min_i;
+        uint16_t * distances = &column_distances_[j * obs_size_x];
+        const uint16_t * above = j > 0 ? distances - obs_size_x : nullptr;
+        for (int i = block_min_i; i < block_max_i; i++) {
+          distances[i] = is_obstacle(row_index + i) ? 0 :
+            (above ? std::min<uint16_t>(above[i] + 1, max_distance) : max_distance);
+        }
+      }
+      for (int j = obs_size_y - 2; j >= 0; j--) {
+        uint16_t * distances = &column_distances_[j * obs_size_x];
+        const uint16_t * below = distances + obs_size_x;
+        for (int i = block_min_i; i < block_max_i; i++) {
+          distances[i] = std::min<uint16_t>(distances[i], below[i] + 1);
+        }
+      }
+    }
+
+    // Squared distance to the nearest obstacle along each row, from the lower envelope
+    // of the parabolas rooted at each column (Felzenszwalb and Huttenlocher)
+    std::vector<int> parabolas(obs_size_x);
+    std::vector<double> boundaries(obs_size_x + 1);
+    std::vector<unsigned char> row_costs(max_i - min_i);
+    #pragma omp for schedule(static)
+    for (int j = min_j; j < max_j; j++) {
+      const uint16_t * distances = &column_distances_[(j - obs_min_j) * obs_size_x];
+      auto height = [&](const int & q) {
+          return static_cast<int>(distances[q]) * distances[q] + q * q;
+        };
+
+      int k = 0;
+      parabolas[0] = 0;
+      boundaries[0] = -std::numeric_limits<double>::max();
+      boundaries[1] = std::numeric_limits<double>::max();
+      for (int q = 1; q < obs_size_x; q++) {
+        double s = (height(q) - height(parabolas[k])) / (2.0 * (q - parabolas[k]));
+        while (s <= boundaries[k]) {
+          k--;
+          s = (height(q) - height(parabolas[k])) / (2.0 * (q - parabolas[k]));
+        }
+        k++;
+        parabolas[k] = q;
+        boundaries[k] = s;
+        boundaries[k + 1] = std::numeric_limits<double>::max();
+      }
+
+      k = 0;
+      for (int i = min_i; i < max_i; i++) {
+        const int q = i - obs_min_i;
+        while (boundaries[k + 1] < q) {
+          k++;
+        }
+        const int dx = q - parabolas[k];
+        const int dy = distances[parabolas[k]];
+        row_costs[i - min_i] =
+          squared_distance_costs_[std::min(dx * dx + dy * dy, max_squared_distance)];
+      }
+
+      apply_row(j, row_costs.data());
+    }
+  }
+}
+
+void
+InflationLayer::enqueueObstacles(
+  const nav2_costmap_2d::Costmap2D & master_grid, InflationWavefront & wavefront,
+  int min_i, int min_j, int max_i, int max_j)
+{
+  // make sure the inflation list is empty at the beginning of the cycle (should always be true)
+  for (auto & dist : wavefront.cells_) {
+    RCLCPP_FATAL_EXPRESSION(
+      logger_,
+      !dist.empty(), "The inflation list must be empty at the beginning of inflation");
+  }
+
+  const unsigned char * master_array = master_grid.getCharMap();
+  const int size_x = static_cast<int>(master_grid.getSizeInCellsX());
+  const int size_y = static_cast<int>(master_grid.getSizeInCellsY());
+  const int radius = static_cast<int>(cell_inflation_radius_);
 
   // We need to include in the inflation cells outside the bounding
   // box min_i...max_j, by the amount cell_inflation_radius_.  Cells
   // up to that distance outside the box can still influence the costs
   // stored in cells inside the box.
-  const int base_min_i = min_i;
-  const int base_min_j = min_j;
-  const int base_max_i = max_i;
-  const int base_max_j = max_j;
-  min_i -= static_cast<int>(cell_inflation_radius_);
-  min_j -= static_cast<int>(cell_inflation_radius_);
-  max_i += static_cast<int>(cell_inflation_radius_);
-  max_j += static_cast<int>(cell_inflation_radius_);
-
-  min_i = std::max(0, min_i);
-  min_j = std::max(0, min_j);
-  max_i = std::min(static_cast<int>(size_x), max_i);
-  max_j = std::min(static_cast<int>(size_y), max_j);
+  min_i = std::max(0, min_i - radius);
+  min_j = std::max(0, min_j - radius);
+  max_i = std::min(size_x, max_i + radius);
+  max_j = std::min(size_y, max_j + radius);
+
+  // Cells are only visited within the inflation radius of those obstacles
+  const int region_min_i = std::max(0, min_i - radius);
+  const int region_min_j = std::max(0, min_j - radius);
+  wavefront.reset(
+    region_min_i, region_min_j,
+    std::min(size_x, max_i + radius) - region_min_i,
+    std::min(size_y, max_j + radius) - region_min_j);
 
   // Inflation list; we append cells to visit in a list associated with
   // its distance to the nearest obstacle
@@ -219,7 +573,7 @@ InflationLayer::updateCosts(
   // with a notable performance boost
 
   // Start with lethal obstacles: by definition distance is 0.0
-  auto & obs_bin = inflation_cells_[0];
+  auto & obs_bin = wavefront.cells_[0];
   for (int j = min_j; j < max_j; j++) {
     for (int i = min_i; i < max_i; i++) {
       int index = static_cast<int>(master_grid.getIndex(i, j));
@@ -229,40 +583,49 @@ InflationLayer::updateCosts(
       }
     }
   }
+}
+
+void
+InflationLayer::propagateCosts(
+  nav2_costmap_2d::Costmap2D & master_grid, InflationWavefront & wavefront,
+  int min_i, int min_j, int max_i, int max_j)
+{
+  unsigned char * master_array = master_grid.getCharMap();
+  unsigned int size_x = master_grid.getSizeInCellsX(), size_y = master_grid.getSizeInCellsY();
 
   // Process cells by increasing distance; new cells are appended to the
   // corresponding distance bin, so they
   // can overtake previously inserted but farther away cells
-  for (const auto & dist_bin : inflation_cells_) {
+  for (const auto & dist_bin : wavefront.cells_) {
     for (std::size_t i = 0; i < dist_bin.size(); ++i) {
       // Do not use iterator or for-range based loops to
       // iterate though dist_bin, since it's size might
       // change when a new cell is enqueued, invalidating all iterators
       unsigned int index = dist_bin[i].index_;
+      unsigned int mx = dist_bin[i].x_;
+      unsigned int my = dist_bin[i].y_;
 
       // ignore if already visited
-      if (seen_[index]) {
+      if (wavefront.isSeen(mx, my)) {
         continue;
       }
 
-      seen_[index] = true;
+      wavefront.see(mx, my);
 
-      unsigned int mx = dist_bin[i].x_;
-      unsigned int my = dist_bin[i].y_;
       unsigned int sx = dist_bin[i].src_x_;
       unsigned int sy = dist_bin[i].src_y_;
 
-      // assign the cost associated with the distance from an obstacle to the cell
-      unsigned char cost = costLookup(mx, my, sx, sy);
-      unsigned char old_cost = master_array[index];
       // In order to avoid artifacts appeared out of boundary areas
       // when some layer is going after inflation_layer,
       // we need to apply inflation_layer only to inside of given bounds
-      if (static_cast<int>(mx) >= base_min_i &&
-        static_cast<int>(my) >= base_min_j &&
-        static_cast<int>(mx) < base_max_i &&
-        static_cast<int>(my) < base_max_j)
+      if (static_cast<int>(mx) >= min_i &&
+        static_cast<int>(my) >= min_j &&
+        static_cast<int>(mx) < max_i &&
+        static_cast<int>(my) < max_j)
       {
+        // assign the cost associated with the distance from an obstacle to the cell
+        unsigned char cost = costLookup(mx, my, sx, sy);
+        unsigned char old_cost = master_array[index];
         if (old_cost == NO_INFORMATION &&
           (inflate_unknown_ ? (cost > FREE_SPACE) : (cost >= INSCRIBED_INFLATED_OBSTACLE)))
         {
@@ -274,31 +637,29 @@ InflationLayer::updateCosts(
 
       // attempt to put the neighbors of the current cell onto the inflation list
       if (mx > 0) {
-        enqueue(index - 1, mx - 1, my, sx, sy);
+        enqueue(wavefront, index - 1, mx - 1, my, sx, sy);
       }
       if (my > 0) {
-        enqueue(index - size_x, mx, my - 1, sx, sy);
+        enqueue(wavefront, index - size_x, mx, my - 1, sx, sy);
       }
       if (mx < size_x - 1) {
-        enqueue(index + 1, mx + 1, my, sx, sy);
+        enqueue(wavefront, index + 1, mx + 1, my, sx, sy);
       }
       if (my < size_y - 1) {
-        enqueue(index + size_x, mx, my + 1, sx, sy);
+        enqueue(wavefront, index + size_x, mx, my + 1, sx, sy);
       }
     }
   }
 
-  for (auto & dist : inflation_cells_) {
+  for (auto & dist : wavefront.cells_) {
     dist.clear();
     dist.reserve(200);
   }
-
-  current_ = true;
 }
 
 /**
  * @brief  Given an index of a cell in the costmap, place it into a list pending for obstacle inflation
- * @param  grid The costmap
+ * @param  wavefront The wavefront to place it in
  * @param  index The index of the cell
  * @param  mx The x coordinate of the cell (can be computed from the index, but saves time to store it)
  * @param  my The y coordinate of the cell (can be computed from the index, but saves time to store it)
@@ -307,26 +668,24 @@ InflationLayer::updateCosts(
  */
 void
 InflationLayer::enqueue(
-  unsigned int index, unsigned int mx, unsigned int my,
+  InflationWavefront & wavefront, unsigned int index, unsigned int mx, unsigned int my,
   unsigned int src_x, unsigned int src_y)
 {
-  if (!seen_[index]) {
-    // we compute our distance table one cell further than the
-    // inflation radius dictates so we can make the check below
-    double distance = distanceLookup(mx, my, src_x, src_y);
-
-    // we only want to put the cell in the list if it is within
-    // the inflation radius of the obstacle point
-    if (distance > cell_inflation_radius_) {
-      return;
-    }
-
-    const unsigned int r = cell_inflation_radius_ + 2;
+  // we compute our distance table one cell further than the
+  // inflation radius dictates so we can make the check below
+  double distance = distanceLookup(mx, my, src_x, src_y);
 
-    // push the cell data onto the inflation list and mark
-    inflation_cells_[distance_matrix_[mx - src_x + r][my - src_y + r]].emplace_back(
-      index, mx, my, src_x, src_y);
+  // we only want to put the cell in the list if it is within
+  // the inflation radius of the obstacle point
+  if (distance > cell_inflation_radius_ || wavefront.isSeen(mx, my)) {
+    return;
   }
+
+  const unsigned int r = cell_inflation_radius_ + 2;
+
+  // push the cell data onto the inflation list and mark
+  wavefront.cells_[distance_matrix_[mx - src_x + r][my - src_y + r]].emplace_back(
+    index, mx, my, src_x, src_y);
 }
 
 void
@@ -359,11 +718,27 @@ InflationLayer::computeCaches()
     }
   }
 
+  // Same costs by squared distance, for cells within the radius as the wavefront visits
+  const unsigned int max_squared_distance = cell_inflation_radius_ * cell_inflation_radius_;
+  squared_distance_costs_.assign(max_squared_distance + 2, 0);
+  for (unsigned int i = 0; i <= cell_inflation_radius_; ++i) {
+    for (unsigned int j = 0; j <= cell_inflation_radius_; ++j) {
+      if (i * i + j * j <= max_squared_distance) {
+        squared_distance_costs_[i * i + j * j] = cached_costs_[i * cache_length_ + j];
+      }
+    }
+  }
+
+  // Costs of obstacles tracked incrementally must all be recomputed
+  obstacles_.clear();
+
   int max_dist = generateIntegerDistances();
-  inflation_cells_.clear();
-  inflation_cells_.resize(max_dist + 1);
-  for (auto & dist : inflation_cells_) {
-    dist.reserve(200);
+  for (auto & wavefront : wavefronts_) {
+    wavefront.cells_.clear();
+    wavefront.cells_.resize(max_dist + 1);
+    for (auto & dist : wavefront.cells_) {
+      dist.reserve(200);
+    }
   }
 }
 
@@ -38,9 +38,16 @@
  *********************************************************************/
 #include "nav2_costmap_2d/costmap_2d_publisher.hpp"
 
+#include <algorithm>
 #include <string>
 #include <memory>
-#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "nav2_costmap_2d/cost_values.hpp"
 
@@ -49,17 +56,69 @@ namespace nav2_costmap_2d
 
 char * Costmap2DPublisher::cost_translation_table_ = NULL;
 
+namespace
+{
+// Translate costs in 16 bit lanes as cost_translation_table_ does. Costs of 1 to 252 are
+// scaled to 1 to 98, dividing by 251 exactly as multiplying by 33421 / 2^23 at this range.
+#if defined(__AVX2__)
+inline __m256i translateLanes(const __m256i & c)
+{
+  const __m256i scaled = _mm256_mullo_epi16(
+    _mm256_subs_epu16(c, _mm256_set1_epi16(1)), _mm256_set1_epi16(97));
+  __m256i t = _mm256_add_epi16(
+    _mm256_srli_epi16(_mm256_mulhi_epu16(scaled, _mm256_set1_epi16(-32115)), 7),
+    _mm256_set1_epi16(1));
+
+  // 0 stays 0, 253 and 254 become 99 and 100, and 255 becomes -1
+  const __m256i special = _mm256_cmpgt_epi16(c, _mm256_set1_epi16(252));
+  t = _mm256_blendv_epi8(t, _mm256_sub_epi16(c, _mm256_set1_epi16(154)), special);
+  t = _mm256_andnot_si256(_mm256_cmpeq_epi16(c, _mm256_setzero_si256()), t);
+  t = _mm256_or_si256(t, _mm256_cmpeq_epi16(c, _mm256_set1_epi16(255)));
+  return _mm256_and_si256(t, _mm256_set1_epi16(0x00FF));
+}
+#elif defined(__SSE2__)
+inline __m128i translateLanes(const __m128i & c)
+{
+  const __m128i scaled = _mm_mullo_epi16(
+    _mm_subs_epu16(c, _mm_set1_epi16(1)), _mm_set1_epi16(97));
+  __m128i t = _mm_add_epi16(
+    _mm_srli_epi16(_mm_mulhi_epu16(scaled, _mm_set1_epi16(-32115)), 7),
+    _mm_set1_epi16(1));
+
+  // 0 stays 0, 253 and 254 become 99 and 100, and 255 becomes -1
+  const __m128i special = _mm_cmpgt_epi16(c, _mm_set1_epi16(252));
+  t = _mm_or_si128(
+    _mm_andnot_si128(special, t),
+    _mm_and_si128(special, _mm_sub_epi16(c, _mm_set1_epi16(154))));
+  t = _mm_andnot_si128(_mm_cmpeq_epi16(c, _mm_setzero_si128()), t);
+  t = _mm_or_si128(t, _mm_cmpeq_epi16(c, _mm_set1_epi16(255)));
+  return _mm_and_si128(t, _mm_set1_epi16(0x00FF));
+}
+#endif
+}  // namespace
+
 Costmap2DPublisher::Costmap2DPublisher(
   const nav2_util::LifecycleNode::WeakPtr & parent,
   Costmap2D * costmap,
   std::string global_frame,
   std::string topic_name,
-  bool always_send_full_costmap)
+  bool always_send_full_costmap,
+  bool raw_costmap_updates,
+  bool compress_raw_costmap_updates)
 : costmap_(costmap),
   global_frame_(global_frame),
   topic_name_(topic_name),
   active_(false),
-  always_send_full_costmap_(always_send_full_costmap)
+  always_send_full_costmap_(always_send_full_costmap),
+  raw_costmap_updates_(raw_costmap_updates),
+  compress_raw_costmap_updates_(compress_raw_costmap_updates),
+  raw_size_x_(0),
+  raw_size_y_(0),
+  raw_resolution_(0.0),
+  raw_origin_x_(0.0),
+  raw_origin_y_(0.0),
+  raw_epoch_(0),
+  raw_updates_count_(RAW_FULL_COSTMAP_PERIOD)
 {
   auto node = parent.lock();
   clock_ = node->get_clock();
@@ -76,6 +135,9 @@ Costmap2DPublisher::Costmap2DPublisher(
     custom_qos);
   costmap_update_pub_ = node->create_publisher<map_msgs::msg::OccupancyGridUpdate>(
     topic_name + "_updates", custom_qos);
+  costmap_raw_update_pub_ = node->create_publisher<nav2_msgs::msg::CostmapUpdate>(
+    topic_name + "_raw_updates",
+    rclcpp::QoS(rclcpp::KeepLast(RAW_FULL_COSTMAP_PERIOD)).transient_local().reliable());
 
   // Create a service that will use the callback function to handle requests.
   costmap_service_ = node->create_service<nav2_msgs::srv::GetCostmap>(
@@ -115,6 +177,34 @@ void Costmap2DPublisher::onNewSubscription(const ros::SingleSubscriberPublisher&
   pub.publish(grid_);
 } */
 
+void Costmap2DPublisher::translateCosts(
+  const unsigned char * costs, int8_t * translated, const unsigned int & size)
+{
+  unsigned int i = 0;
+#if defined(__AVX2__)
+  const __m256i zero = _mm256_setzero_si256();
+  for (; i + 32 <= size; i += 32) {
+    // Unpacking and packing are both within 128 bit lanes, so the order is kept
+    const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(costs + i));
+    const __m256i low = translateLanes(_mm256_unpacklo_epi8(c, zero));
+    const __m256i high = translateLanes(_mm256_unpackhi_epi8(c, zero));
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i *>(translated + i), _mm256_packus_epi16(low, high));
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= size; i += 16) {
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(costs + i));
+    const __m128i low = translateLanes(_mm_unpacklo_epi8(c, zero));
+    const __m128i high = translateLanes(_mm_unpackhi_epi8(c, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(translated + i), _mm_packus_epi16(low, high));
+  }
+#endif
+  for (; i < size; i++) {
+    translated[i] = cost_translation_table_[costs[i]];
+  }
+}
+
 // prepare grid_ message for publication.
 void Costmap2DPublisher::prepareGrid()
 {
@@ -123,30 +213,47 @@ void Costmap2DPublisher::prepareGrid()
   grid_width = costmap_->getSizeInCellsX();
   grid_height = costmap_->getSizeInCellsY();
 
-  grid_ = std::make_unique<nav_msgs::msg::OccupancyGrid>();
+  grid_.header.frame_id = global_frame_;
+  grid_.header.stamp = rclcpp::Time();
 
-  grid_->header.frame_id = global_frame_;
-  grid_->header.stamp = rclcpp::Time();
+  grid_.info.resolution = grid_resolution;
 
-  grid_->info.resolution = grid_resolution;
-
-  grid_->info.width = grid_width;
-  grid_->info.height = grid_height;
+  grid_.info.width = grid_width;
+  grid_.info.height = grid_height;
 
   double wx, wy;
   costmap_->mapToWorld(0, 0, wx, wy);
-  grid_->info.origin.position.x = wx - grid_resolution / 2;
-  grid_->info.origin.position.y = wy - grid_resolution / 2;
-  grid_->info.origin.position.z = 0.0;
-  grid_->info.origin.orientation.w = 1.0;
+  grid_.info.origin.position.x = wx - grid_resolution / 2;
+  grid_.info.origin.position.y = wy - grid_resolution / 2;
+  grid_.info.origin.position.z = 0.0;
+  grid_.info.origin.orientation.w = 1.0;
   saved_origin_x_ = costmap_->getOriginX();
   saved_origin_y_ = costmap_->getOriginY();
 
-  grid_->data.resize(grid_->info.width * grid_->info.height);
+  grid_.data.resize(grid_.info.width * grid_.info.height);
+  translateCosts(costmap_->getCharMap(), grid_.data.data(), grid_.data.size());
+}
 
-  unsigned char * data = costmap_->getCharMap();
-  for (unsigned int i = 0; i < grid_->data.size(); i++) {
-    grid_->data[i] = cost_translation_table_[data[i]];
+void Costmap2DPublisher::prepareGridUpdate()
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+  const unsigned int size_x = costmap_->getSizeInCellsX();
+  const unsigned int xn = std::min(xn_, size_x);
+  const unsigned int yn = std::min(yn_, costmap_->getSizeInCellsY());
+
+  grid_update_.header.stamp = rclcpp::Time();
+  grid_update_.header.frame_id = global_frame_;
+  grid_update_.x = x0_;
+  grid_update_.y = y0_;
+  grid_update_.width = xn - x0_;
+  grid_update_.height = yn - y0_;
+  grid_update_.data.resize(grid_update_.width * grid_update_.height);
+
+  const unsigned char * data = costmap_->getCharMap();
+  for (unsigned int y = y0_; y < yn; y++) {
+    translateCosts(
+      data + y * size_x + x0_,
+      grid_update_.data.data() + (y - y0_) * grid_update_.width, grid_update_.width);
   }
 }
 
@@ -155,37 +262,117 @@ void Costmap2DPublisher::prepareCostmap()
   std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
   double resolution = costmap_->getResolution();
 
-  costmap_raw_ = std::make_unique<nav2_msgs::msg::Costmap>();
-
-  costmap_raw_->header.frame_id = global_frame_;
-  costmap_raw_->header.stamp = clock_->now();
+  costmap_raw_.header.frame_id = global_frame_;
+  costmap_raw_.header.stamp = clock_->now();
 
-  costmap_raw_->metadata.layer = "master";
-  costmap_raw_->metadata.resolution = resolution;
+  costmap_raw_.metadata.layer = "master";
+  costmap_raw_.metadata.resolution = resolution;
 
-  costmap_raw_->metadata.size_x = costmap_->getSizeInCellsX();
-  costmap_raw_->metadata.size_y = costmap_->getSizeInCellsY();
+  costmap_raw_.metadata.size_x = costmap_->getSizeInCellsX();
+  costmap_raw_.metadata.size_y = costmap_->getSizeInCellsY();
 
   double wx, wy;
   costmap_->mapToWorld(0, 0, wx, wy);
-  costmap_raw_->metadata.origin.position.x = wx - resolution / 2;
-  costmap_raw_->metadata.origin.position.y = wy - resolution / 2;
-  costmap_raw_->metadata.origin.position.z = 0.0;
-  costmap_raw_->metadata.origin.orientation.w = 1.0;
+  costmap_raw_.metadata.origin.position.x = wx - resolution / 2;
+  costmap_raw_.metadata.origin.position.y = wy - resolution / 2;
+  costmap_raw_.metadata.origin.position.z = 0.0;
+  costmap_raw_.metadata.origin.orientation.w = 1.0;
+  costmap_raw_.epoch = ++raw_epoch_;
+  raw_size_x_ = costmap_raw_.metadata.size_x;
+  raw_size_y_ = costmap_raw_.metadata.size_y;
+  raw_resolution_ = resolution;
+  raw_origin_x_ = costmap_->getOriginX();
+  raw_origin_y_ = costmap_->getOriginY();
+
+  costmap_raw_.data.resize(costmap_raw_.metadata.size_x * costmap_raw_.metadata.size_y);
+
+  const unsigned char * data = costmap_->getCharMap();
+  std::copy(data, data + costmap_raw_.data.size(), costmap_raw_.data.begin());
+}
 
-  costmap_raw_->data.resize(costmap_raw_->metadata.size_x * costmap_raw_->metadata.size_y);
+void Costmap2DPublisher::prepareCostmapUpdate()
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+  const unsigned int size_x = costmap_->getSizeInCellsX();
+  const unsigned int xn = std::min(xn_, size_x);
+  const unsigned int yn = std::min(yn_, costmap_->getSizeInCellsY());
+
+  costmap_raw_update_.header.frame_id = global_frame_;
+  costmap_raw_update_.header.stamp = clock_->now();
+  costmap_raw_update_.epoch = raw_epoch_;
+  costmap_raw_update_.sequence = raw_updates_count_;
+
+  costmap_raw_update_.x = x0_;
+  costmap_raw_update_.y = y0_;
+  costmap_raw_update_.width = xn - x0_;
+  costmap_raw_update_.height = yn - y0_;
+
+  const unsigned char * data = costmap_->getCharMap();
+  std::vector<uint8_t> & update_data = costmap_raw_update_.data;
+  if (!compress_raw_costmap_updates_) {
+    costmap_raw_update_.compression = nav2_msgs::msg::CostmapUpdate::COMPRESSION_NONE;
+    update_data.resize(costmap_raw_update_.width * costmap_raw_update_.height);
+    for (unsigned int y = y0_; y < yn; y++) {
+      std::copy(
+        data + y * size_x + x0_, data + y * size_x + xn,
+        update_data.begin() + (y - y0_) * costmap_raw_update_.width);
+    }
+    return;
+  }
 
-  unsigned char * data = costmap_->getCharMap();
-  for (unsigned int i = 0; i < costmap_raw_->data.size(); i++) {
-    costmap_raw_->data[i] = data[i];
+  // Runs do not cross rows, so that each is decoded independently
+  costmap_raw_update_.compression = nav2_msgs::msg::CostmapUpdate::COMPRESSION_RLE;
+  update_data.clear();
+  for (unsigned int y = y0_; y < yn; y++) {
+    const unsigned char * row = data + y * size_x;
+    unsigned int x = x0_;
+    while (x < xn) {
+      const unsigned char cost = row[x];
+      unsigned int run_end = x + 1;
+      while (run_end < xn && run_end - x < 255 && row[run_end] == cost) {
+        run_end++;
+      }
+      update_data.push_back(static_cast<uint8_t>(run_end - x));
+      update_data.push_back(cost);
+      x = run_end;
+    }
+  }
+}
+
+void Costmap2DPublisher::publishRawCostmap()
+{
+  if (costmap_raw_pub_->get_subscription_count() == 0 &&
+    costmap_raw_update_pub_->get_subscription_count() == 0)
+  {
+    // Updated windows are not tracked meanwhile, so the next must be in full
+    raw_updates_count_ = RAW_FULL_COSTMAP_PERIOD;
+    return;
+  }
+
+  if (raw_updates_count_ >= RAW_FULL_COSTMAP_PERIOD ||
+    raw_size_x_ != costmap_->getSizeInCellsX() ||
+    raw_size_y_ != costmap_->getSizeInCellsY() ||
+    raw_resolution_ != costmap_->getResolution() ||
+    raw_origin_x_ != costmap_->getOriginX() ||
+    raw_origin_y_ != costmap_->getOriginY())
+  {
+    prepareCostmap();
+    raw_updates_count_ = 0;
+    publishKeptMessage(*costmap_raw_pub_, costmap_raw_);
+  } else if (x0_ < xn_ && y0_ < yn_) {
+    raw_updates_count_++;
+    prepareCostmapUpdate();
+    publishKeptMessage(*costmap_raw_update_pub_, costmap_raw_update_);
   }
 }
 
 void Costmap2DPublisher::publishCostmap()
 {
-  if (costmap_raw_pub_->get_subscription_count() > 0) {
+  if (raw_costmap_updates_) {
+    publishRawCostmap();
+  } else if (costmap_raw_pub_->get_subscription_count() > 0) {
     prepareCostmap();
-    costmap_raw_pub_->publish(std::move(costmap_raw_));
+    publishKeptMessage(*costmap_raw_pub_, costmap_raw_);
   }
   float resolution = costmap_->getResolution();
 
@@ -197,28 +384,13 @@ void Costmap2DPublisher::publishCostmap()
   {
     if (costmap_pub_->get_subscription_count() > 0) {
       prepareGrid();
-      costmap_pub_->publish(std::move(grid_));
+      publishKeptMessage(*costmap_pub_, grid_);
     }
   } else if (x0_ < xn_) {
     if (costmap_update_pub_->get_subscription_count() > 0) {
-      std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
       // Publish Just an Update
-      auto update = std::make_unique<map_msgs::msg::OccupancyGridUpdate>();
-      update->header.stamp = rclcpp::Time();
-      update->header.frame_id = global_frame_;
-      update->x = x0_;
-      update->y = y0_;
-      update->width = xn_ - x0_;
-      update->height = yn_ - y0_;
-      update->data.resize(update->width * update->height);
-      unsigned int i = 0;
-      for (unsigned int y = y0_; y < yn_; y++) {
-        for (unsigned int x = x0_; x < xn_; x++) {
-          unsigned char cost = costmap_->getCost(x, y);
-          update->data[i++] = cost_translation_table_[cost];
-        }
-      }
-      costmap_update_pub_->publish(std::move(update));
+      prepareGridUpdate();
+      publishKeptMessage(*costmap_update_pub_, grid_update_);
     }
   }
 
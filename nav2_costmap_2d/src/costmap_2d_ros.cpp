@@ -88,10 +88,12 @@ Costmap2DROS::Costmap2DROS(
   std::vector<std::string> clearable_layers{"obstacle_layer", "voxel_layer", "range_layer"};
 
   declare_parameter("always_send_full_costmap", rclcpp::ParameterValue(false));
+  declare_parameter("compress_raw_costmap_updates", rclcpp::ParameterValue(false));
   declare_parameter("footprint_padding", rclcpp::ParameterValue(0.01f));
   declare_parameter("footprint", rclcpp::ParameterValue(std::string("[]")));
   declare_parameter("global_frame", rclcpp::ParameterValue(std::string("map")));
   declare_parameter("height", rclcpp::ParameterValue(5));
+  declare_parameter("layer_threads", rclcpp::ParameterValue(1));
   declare_parameter("width", rclcpp::ParameterValue(5));
   declare_parameter("lethal_cost_threshold", rclcpp::ParameterValue(100));
   declare_parameter(
@@ -103,6 +105,7 @@ Costmap2DROS::Costmap2DROS(
   declare_parameter("plugins", rclcpp::ParameterValue(default_plugins_));
   declare_parameter("filters", rclcpp::ParameterValue(std::vector<std::string>()));
   declare_parameter("publish_frequency", rclcpp::ParameterValue(1.0));
+  declare_parameter("raw_costmap_updates", rclcpp::ParameterValue(false));
   declare_parameter("resolution", rclcpp::ParameterValue(0.1));
   declare_parameter("robot_base_frame", rclcpp::ParameterValue(std::string("base_link")));
   declare_parameter("robot_radius", rclcpp::ParameterValue(0.1));
@@ -129,6 +132,7 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
   // Create the costmap itself
   layered_costmap_ = std::make_unique<LayeredCostmap>(
     global_frame_, rolling_window_, track_unknown_space_);
+  layered_costmap_->setLayerThreads(layer_threads_);
 
   if (!layered_costmap_->isSizeLocked()) {
     layered_costmap_->resizeMap(
@@ -184,7 +188,11 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
   costmap_publisher_ = std::make_unique<Costmap2DPublisher>(
     shared_from_this(),
     layered_costmap_->getCostmap(), global_frame_,
-    "costmap", always_send_full_costmap_);
+    "costmap", always_send_full_costmap_, raw_costmap_updates_,
+    compress_raw_costmap_updates_);
+
+  snapshot_source_ = std::make_shared<CostmapSnapshotSource>();
+  CostmapSnapshotSource::advertise(costmap_publisher_->getRawTopicName(), snapshot_source_);
 
   // Set the footprint
   if (use_radius_) {
@@ -279,6 +287,7 @@ Costmap2DROS::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   footprint_pub_.reset();
 
   costmap_publisher_.reset();
+  snapshot_source_.reset();
   clear_costmap_service_.reset();
 
   return nav2_util::CallbackReturn::SUCCESS;
@@ -298,13 +307,16 @@ Costmap2DROS::getParameters()
 
   // Get all of the required parameters
   get_parameter("always_send_full_costmap", always_send_full_costmap_);
+  get_parameter("compress_raw_costmap_updates", compress_raw_costmap_updates_);
   get_parameter("footprint", footprint_);
   get_parameter("footprint_padding", footprint_padding_);
   get_parameter("global_frame", global_frame_);
   get_parameter("height", map_height_meters_);
+  get_parameter("layer_threads", layer_threads_);
   get_parameter("origin_x", origin_x_);
   get_parameter("origin_y", origin_y_);
   get_parameter("publish_frequency", map_publish_frequency_);
+  get_parameter("raw_costmap_updates", raw_costmap_updates_);
   get_parameter("resolution", resolution_);
   get_parameter("robot_base_frame", robot_base_frame_);
   get_parameter("robot_radius", robot_radius_);
@@ -456,6 +468,17 @@ Costmap2DROS::updateMap()
       const double & y = pose.pose.position.y;
       const double yaw = tf2::getYaw(pose.pose.orientation);
       layered_costmap_->updateMap(x, y, yaw);
+      for (const auto & timing : layered_costmap_->getLayerTimings()) {
+        RCLCPP_DEBUG(
+          get_logger(), "Layer %s updated bounds in %.6f s and costs in %.6f s",
+          timing.name.c_str(), timing.update_bounds_time, timing.update_costs_time);
+      }
+
+      if (snapshot_source_->isRequested()) {
+        Costmap2D * master = layered_costmap_->getCostmap();
+        std::unique_lock<Costmap2D::mutex_t> lock(*(master->getMutex()));
+        snapshot_source_->update(*master);
+      }
 
       auto footprint = std::make_unique<geometry_msgs::msg::PolygonStamped>();
       footprint->header.frame_id = global_frame_;
@@ -469,6 +492,24 @@ Costmap2DROS::updateMap()
   }
 }
 
+std::shared_ptr<const Costmap2D>
+Costmap2DROS::getCostmapSnapshot()
+{
+  if (!snapshot_source_) {
+    return nullptr;
+  }
+
+  auto snapshot = snapshot_source_->getSnapshot();
+  if (!snapshot) {
+    // Not updated since snapshots were first requested
+    Costmap2D * master = layered_costmap_->getCostmap();
+    std::unique_lock<Costmap2D::mutex_t> lock(*(master->getMutex()));
+    snapshot_source_->update(*master);
+    snapshot = snapshot_source_->getSnapshot();
+  }
+  return snapshot;
+}
+
 void
 Costmap2DROS::start()
 {
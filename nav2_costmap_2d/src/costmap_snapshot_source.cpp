@@ -0,0 +1,85 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/costmap_snapshot_source.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace nav2_costmap_2d
+{
+
+namespace
+{
+// Sources of the costmaps published in this process, by topic
+std::mutex g_sources_mutex;
+std::map<std::string, std::weak_ptr<CostmapSnapshotSource>> g_sources;
+}  // namespace
+
+CostmapSnapshotSource::CostmapSnapshotSource()
+: requested_(false)
+{
+}
+
+void CostmapSnapshotSource::update(const Costmap2D & costmap)
+{
+  // A frame held only here is in no consumer's hands, nor the latest snapshot
+  std::shared_ptr<Costmap2D> frame;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto & candidate : frames_) {
+      if (candidate.use_count() == 1) {
+        frame = candidate;
+        break;
+      }
+    }
+    if (!frame) {
+      frame = std::make_shared<Costmap2D>();
+      frames_.push_back(frame);
+    }
+  }
+
+  *frame = costmap;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  snapshot_ = frame;
+}
+
+std::shared_ptr<const Costmap2D> CostmapSnapshotSource::getSnapshot()
+{
+  requested_ = true;
+  std::lock_guard<std::mutex> lock(mutex_);
+  return snapshot_;
+}
+
+void CostmapSnapshotSource::advertise(
+  const std::string & topic_name, const std::shared_ptr<CostmapSnapshotSource> & source)
+{
+  std::lock_guard<std::mutex> lock(g_sources_mutex);
+  g_sources[topic_name] = source;
+}
+
+std::shared_ptr<CostmapSnapshotSource> CostmapSnapshotSource::find(const std::string & topic_name)
+{
+  std::lock_guard<std::mutex> lock(g_sources_mutex);
+  auto source = g_sources.find(topic_name);
+  if (source == g_sources.end()) {
+    return nullptr;
+  }
+  return source->second.lock();
+}
+
+}  // namespace nav2_costmap_2d
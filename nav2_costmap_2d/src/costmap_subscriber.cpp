@@ -12,10 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "nav2_costmap_2d/costmap_subscriber.hpp"
+#include "nav2_costmap_2d/costmap_2d_publisher.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -30,6 +34,11 @@ CostmapSubscriber::CostmapSubscriber(
     topic_name_,
     rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
     std::bind(&CostmapSubscriber::costmapCallback, this, std::placeholders::_1));
+  costmap_update_sub_ = node->create_subscription<nav2_msgs::msg::CostmapUpdate>(
+    topic_name_ + "_updates",
+    rclcpp::QoS(rclcpp::KeepLast(Costmap2DPublisher::RAW_FULL_COSTMAP_PERIOD))
+    .transient_local().reliable(),
+    std::bind(&CostmapSubscriber::costmapUpdateCallback, this, std::placeholders::_1));
 }
 
 CostmapSubscriber::CostmapSubscriber(
@@ -42,6 +51,11 @@ CostmapSubscriber::CostmapSubscriber(
     topic_name_,
     rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
     std::bind(&CostmapSubscriber::costmapCallback, this, std::placeholders::_1));
+  costmap_update_sub_ = node->create_subscription<nav2_msgs::msg::CostmapUpdate>(
+    topic_name_ + "_updates",
+    rclcpp::QoS(rclcpp::KeepLast(Costmap2DPublisher::RAW_FULL_COSTMAP_PERIOD))
+    .transient_local().reliable(),
+    std::bind(&CostmapSubscriber::costmapUpdateCallback, this, std::placeholders::_1));
 }
 
 std::shared_ptr<Costmap2D> CostmapSubscriber::getCostmap()
@@ -49,10 +63,45 @@ std::shared_ptr<Costmap2D> CostmapSubscriber::getCostmap()
   if (!costmap_received_) {
     throw std::runtime_error("Costmap is not available");
   }
-  toCostmap2D();
+  std::lock_guard<std::mutex> lock(msgs_mutex_);
+  if (costmap_msg_) {
+    toCostmap2D();
+    costmap_epoch_ = costmap_msg_->epoch;
+    updates_count_ = 0;
+    updates_lost_ = false;
+    costmap_msg_.reset();
+  }
+  applyUpdates();
   return costmap_;
 }
 
+std::shared_ptr<const Costmap2D> CostmapSubscriber::getCostmapSnapshot()
+{
+  auto source = snapshot_source_.lock();
+  if (!source) {
+    source = CostmapSnapshotSource::find(costmap_sub_->get_topic_name());
+    snapshot_source_ = source;
+  }
+  if (source) {
+    auto snapshot = source->getSnapshot();
+    if (snapshot) {
+      return snapshot;
+    }
+  }
+
+  // Copied, as the costmap converted from the topic is updated in place
+  bool outdated;
+  {
+    std::lock_guard<std::mutex> lock(msgs_mutex_);
+    outdated = snapshot_outdated_;
+    snapshot_outdated_ = false;
+  }
+  if (outdated || !snapshot_) {
+    snapshot_ = std::make_shared<const Costmap2D>(*getCostmap());
+  }
+  return snapshot_;
+}
+
 void CostmapSubscriber::toCostmap2D()
 {
   if (costmap_ == nullptr) {
@@ -74,22 +123,130 @@ void CostmapSubscriber::toCostmap2D()
       costmap_msg_->metadata.origin.position.y);
   }
 
+  std::copy(costmap_msg_->data.begin(), costmap_msg_->data.end(), costmap_->getCharMap());
+}
+
+void CostmapSubscriber::applyUpdates()
+{
+  // Received out of order, such as across callback groups, they still apply in sequence
+  std::stable_sort(
+    update_msgs_.begin(), update_msgs_.end(),
+    [](const nav2_msgs::msg::CostmapUpdate::SharedPtr & a,
+    const nav2_msgs::msg::CostmapUpdate::SharedPtr & b) {
+      return a->sequence < b->sequence;
+    });
+
+  std::vector<nav2_msgs::msg::CostmapUpdate::SharedPtr> pending;
+  for (const auto & update : update_msgs_) {
+    if (isLaterEpoch(update->epoch, costmap_epoch_)) {
+      // Of a full costmap not received yet
+      pending.push_back(update);
+    } else if (update->epoch == costmap_epoch_ && !updates_lost_) {
+      if (update->sequence == updates_count_ + 1) {
+        if (!applyUpdate(*update)) {
+          RCLCPP_WARN(
+            rclcpp::get_logger("nav2_costmap_2d"),
+            "Costmap update %u on topic %s malformed, waiting for the next full costmap",
+            update->sequence, topic_name_.c_str());
+          updates_lost_ = true;
+        }
+        updates_count_++;
+      } else if (update->sequence > updates_count_ + 1) {
+        // None of the later updates of this costmap apply either
+        RCLCPP_WARN(
+          rclcpp::get_logger("nav2_costmap_2d"),
+          "Costmap update %u on topic %s lost, waiting for the next full costmap",
+          updates_count_ + 1, topic_name_.c_str());
+        updates_lost_ = true;
+      }
+    }
+  }
+  update_msgs_.swap(pending);
+}
+
+bool CostmapSubscriber::applyUpdate(const nav2_msgs::msg::CostmapUpdate & update)
+{
+  const unsigned int size_x = costmap_->getSizeInCellsX();
+  if (update.x + update.width > size_x ||
+    update.y + update.height > costmap_->getSizeInCellsY())
+  {
+    return false;
+  }
+
   unsigned char * master_array = costmap_->getCharMap();
+  if (update.compression == nav2_msgs::msg::CostmapUpdate::COMPRESSION_NONE) {
+    if (update.data.size() != update.width * update.height) {
+      return false;
+    }
+    for (unsigned int y = 0; y < update.height; y++) {
+      std::memcpy(
+        master_array + (update.y + y) * size_x + update.x,
+        update.data.data() + y * update.width, update.width);
+    }
+    return true;
+  }
+
+  if (update.compression != nav2_msgs::msg::CostmapUpdate::COMPRESSION_RLE) {
+    return false;
+  }
+
+  // Runs of each row, which they do not cross. Checked to cover the window first,
+  // so that a truncated payload is not applied in part.
   unsigned int index = 0;
-  for (unsigned int i = 0; i < costmap_msg_->metadata.size_x; ++i) {
-    for (unsigned int j = 0; j < costmap_msg_->metadata.size_y; ++j) {
-      master_array[index] = costmap_msg_->data[index];
-      ++index;
+  for (unsigned int y = 0; y < update.height; y++) {
+    unsigned int x = 0;
+    while (x < update.width) {
+      if (index + 1 >= update.data.size()) {
+        return false;
+      }
+      x += std::min<unsigned int>(update.data[index], update.width - x);
+      index += 2;
     }
   }
+
+  index = 0;
+  for (unsigned int y = 0; y < update.height; y++) {
+    unsigned char * row = master_array + (update.y + y) * size_x + update.x;
+    unsigned int x = 0;
+    while (x < update.width) {
+      const unsigned int length = std::min<unsigned int>(update.data[index], update.width - x);
+      std::memset(row + x, update.data[index + 1], length);
+      x += length;
+      index += 2;
+    }
+  }
+  return true;
+}
+
+bool CostmapSubscriber::isLaterEpoch(const uint32_t & epoch, const uint32_t & other)
+{
+  return static_cast<int32_t>(epoch - other) > 0;
 }
 
 void CostmapSubscriber::costmapCallback(const nav2_msgs::msg::Costmap::SharedPtr msg)
 {
+  std::lock_guard<std::mutex> lock(msgs_mutex_);
   costmap_msg_ = msg;
+  snapshot_outdated_ = true;
+
+  // Updates of earlier costmaps no longer apply
+  update_msgs_.erase(
+    std::remove_if(
+      update_msgs_.begin(), update_msgs_.end(),
+      [&msg](const nav2_msgs::msg::CostmapUpdate::SharedPtr & update) {
+        return update->epoch != msg->epoch && !isLaterEpoch(update->epoch, msg->epoch);
+      }), update_msgs_.end());
   if (!costmap_received_) {
     costmap_received_ = true;
   }
 }
 
+void CostmapSubscriber::costmapUpdateCallback(
+  const nav2_msgs::msg::CostmapUpdate::SharedPtr msg)
+{
+  std::lock_guard<std::mutex> lock(msgs_mutex_);
+  update_msgs_.push_back(msg);
+  snapshot_outdated_ = true;
+}
+
 }  // namespace nav2_costmap_2d
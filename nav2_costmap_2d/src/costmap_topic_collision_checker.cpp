@@ -75,7 +75,7 @@ double CostmapTopicCollisionChecker::scorePose(
   const geometry_msgs::msg::Pose2D & pose)
 {
   try {
-    collision_checker_.setCostmap(costmap_sub_.getCostmap());
+    collision_checker_.setCostmap(costmap_sub_.getCostmapSnapshot());
   } catch (const std::runtime_error & e) {
     throw CollisionCheckerException(e.what());
   }
@@ -139,5 +139,6 @@ double FootprintCollisionChecker<CostmapT>::footprintCostAtPose(
 // declare our valid template parameters
 template class FootprintCollisionChecker<std::shared_ptr<nav2_costmap_2d::Costmap2D>>;
 template class FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>;
+template class FootprintCollisionChecker<std::shared_ptr<const nav2_costmap_2d::Costmap2D>>;
 
 }  // namespace nav2_costmap_2d
@@ -38,7 +38,10 @@
 #include "nav2_costmap_2d/layered_costmap.hpp"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdio>
+#include <exception>
 #include <memory>
 #include <string>
 #include <vector>
@@ -68,7 +71,8 @@ LayeredCostmap::LayeredCostmap(std::string global_frame, bool rolling_window, bo
   initialized_(false),
   size_locked_(false),
   circumscribed_radius_(1.0),
-  inscribed_radius_(0.1)
+  inscribed_radius_(0.1),
+  layer_threads_(1)
 {
   if (track_unknown) {
     primary_costmap_.setDefaultValue(255);
@@ -145,41 +149,43 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
   minx_ = miny_ = std::numeric_limits<double>::max();
   maxx_ = maxy_ = std::numeric_limits<double>::lowest();
 
-  for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
-    plugin != plugins_.end(); ++plugin)
-  {
-    double prev_minx = minx_;
-    double prev_miny = miny_;
-    double prev_maxx = maxx_;
-    double prev_maxy = maxy_;
-    (*plugin)->updateBounds(robot_x, robot_y, robot_yaw, &minx_, &miny_, &maxx_, &maxy_);
-    if (minx_ > prev_minx || miny_ > prev_miny || maxx_ < prev_maxx || maxy_ < prev_maxy) {
-      RCLCPP_WARN(
-        rclcpp::get_logger(
-          "nav2_costmap_2d"), "Illegal bounds change, was [tl: (%f, %f), br: (%f, %f)], but "
-        "is now [tl: (%f, %f), br: (%f, %f)]. The offending layer is %s",
-        prev_minx, prev_miny, prev_maxx, prev_maxy,
-        minx_, miny_, maxx_, maxy_,
-        (*plugin)->getName().c_str());
-    }
+  layer_timings_.resize(plugins_.size() + filters_.size());
+  for (size_t i = 0; i < plugins_.size(); i++) {
+    layer_timings_[i] = {plugins_[i]->getName(), 0.0, 0.0};
   }
-  for (vector<std::shared_ptr<Layer>>::iterator filter = filters_.begin();
-    filter != filters_.end(); ++filter)
-  {
-    double prev_minx = minx_;
-    double prev_miny = miny_;
-    double prev_maxx = maxx_;
-    double prev_maxy = maxy_;
-    (*filter)->updateBounds(robot_x, robot_y, robot_yaw, &minx_, &miny_, &maxx_, &maxy_);
-    if (minx_ > prev_minx || miny_ > prev_miny || maxx_ < prev_maxx || maxy_ < prev_maxy) {
-      RCLCPP_WARN(
-        rclcpp::get_logger(
-          "nav2_costmap_2d"), "Illegal bounds change, was [tl: (%f, %f), br: (%f, %f)], but "
-        "is now [tl: (%f, %f), br: (%f, %f)]. The offending filter is %s",
-        prev_minx, prev_miny, prev_maxx, prev_maxy,
-        minx_, miny_, maxx_, maxy_,
-        (*filter)->getName().c_str());
+  for (size_t i = 0; i < filters_.size(); i++) {
+    layer_timings_[plugins_.size() + i] = {filters_[i]->getName(), 0.0, 0.0};
+  }
+
+  for (size_t first = 0; first < plugins_.size(); ) {
+    const size_t last = getPluginGroupEnd(first);
+    if (last - first == 1) {
+      updateLayerBounds(
+        *plugins_[first], "layer", robot_x, robot_y, robot_yaw,
+        &minx_, &miny_, &maxx_, &maxy_, layer_timings_[first]);
+    } else {
+      // Each plugin of the group expands its own copy of the bounds, joined after
+      std::vector<std::array<double, 4>> bounds(last - first, {minx_, miny_, maxx_, maxy_});
+      runConcurrently(
+        last - first, [&](size_t k) {
+          updateLayerBounds(
+            *plugins_[first + k], "layer", robot_x, robot_y, robot_yaw,
+            &bounds[k][0], &bounds[k][1], &bounds[k][2], &bounds[k][3],
+            layer_timings_[first + k]);
+        });
+      for (const auto & plugin_bounds : bounds) {
+        minx_ = std::min(minx_, plugin_bounds[0]);
+        miny_ = std::min(miny_, plugin_bounds[1]);
+        maxx_ = std::max(maxx_, plugin_bounds[2]);
+        maxy_ = std::max(maxy_, plugin_bounds[3]);
+      }
     }
+    first = last;
+  }
+  for (size_t i = 0; i < filters_.size(); i++) {
+    updateLayerBounds(
+      *filters_[i], "filter", robot_x, robot_y, robot_yaw,
+      &minx_, &miny_, &maxx_, &maxy_, layer_timings_[plugins_.size() + i]);
   }
 
   int x0, xn, y0, yn;
@@ -199,23 +205,61 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
     return;
   }
 
-  if (filters_.size() == 0) {
-    // If there are no filters enabled just update costmap sequentially by each plugin
-    combined_costmap_.resetMap(x0, y0, xn, yn);
-    for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
-      plugin != plugins_.end(); ++plugin)
-    {
-      (*plugin)->updateCosts(combined_costmap_, x0, y0, xn, yn);
+  // If there are no filters enabled just update costmap by each plugin,
+  // otherwise (1.) the primary costmap that filters are applied over
+  Costmap2D & plugins_costmap = filters_.size() == 0 ? combined_costmap_ : primary_costmap_;
+  plugins_costmap.resetMap(x0, y0, xn, yn);
+  plugin_grids_.resize(plugins_.size());
+  for (size_t first = 0; first < plugins_.size(); ) {
+    const size_t last = getPluginGroupEnd(first);
+    if (last - first == 1) {
+      auto start = std::chrono::steady_clock::now();
+      plugins_[first]->updateCosts(plugins_costmap, x0, y0, xn, yn);
+      layer_timings_[first].update_costs_time =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      first = last;
+      continue;
     }
-  } else {
-    // Costmap Filters enabled
-    // 1. Update costmap by plugins
-    primary_costmap_.resetMap(x0, y0, xn, yn);
-    for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
-      plugin != plugins_.end(); ++plugin)
-    {
-      (*plugin)->updateCosts(primary_costmap_, x0, y0, xn, yn);
+
+    // Plugins of the group update their own unknown grid, merged in order after
+    runConcurrently(
+      last - first, [&](size_t k) {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<Costmap2D> & grid = plugin_grids_[first + k];
+        if (!grid) {
+          grid = std::make_unique<Costmap2D>();
+          grid->setDefaultValue(NO_INFORMATION);
+        }
+        // Rolling windows move the origin every cycle, follow it as the costmap does
+        // rather than reallocating the grid
+        if (grid->getSizeInCellsX() != plugins_costmap.getSizeInCellsX() ||
+        grid->getSizeInCellsY() != plugins_costmap.getSizeInCellsY() ||
+        grid->getResolution() != plugins_costmap.getResolution())
+        {
+          grid->resizeMap(
+            plugins_costmap.getSizeInCellsX(), plugins_costmap.getSizeInCellsY(),
+            plugins_costmap.getResolution(),
+            plugins_costmap.getOriginX(), plugins_costmap.getOriginY());
+        } else if (grid->getOriginX() != plugins_costmap.getOriginX() ||
+        grid->getOriginY() != plugins_costmap.getOriginY())
+        {
+          grid->updateOrigin(plugins_costmap.getOriginX(), plugins_costmap.getOriginY());
+        }
+        grid->resetMap(x0, y0, xn, yn);
+        plugins_[first + k]->updateCosts(*grid, x0, y0, xn, yn);
+        layer_timings_[first + k].update_costs_time =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      });
+    for (size_t i = first; i < last; i++) {
+      auto start = std::chrono::steady_clock::now();
+      mergeWithMax(plugins_costmap, *plugin_grids_[i], x0, y0, xn, yn);
+      layer_timings_[i].update_costs_time +=
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
+    first = last;
+  }
+
+  if (filters_.size() != 0) {
 
     // 2. Copy processed costmap window to a final costmap.
     // primary_costmap_ remain to be untouched for further usage by plugins.
@@ -229,10 +273,11 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
 
     // 3. Apply filters over the plugins in order to make filters' work
     // not being considered by plugins on next updateMap() calls
-    for (vector<std::shared_ptr<Layer>>::iterator filter = filters_.begin();
-      filter != filters_.end(); ++filter)
-    {
-      (*filter)->updateCosts(combined_costmap_, x0, y0, xn, yn);
+    for (size_t i = 0; i < filters_.size(); i++) {
+      auto start = std::chrono::steady_clock::now();
+      filters_[i]->updateCosts(combined_costmap_, x0, y0, xn, yn);
+      layer_timings_[plugins_.size() + i].update_costs_time =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
   }
 
@@ -244,6 +289,84 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
   initialized_ = true;
 }
 
+void LayeredCostmap::updateLayerBounds(
+  Layer & layer, const char * kind, double robot_x, double robot_y, double robot_yaw,
+  double * minx, double * miny, double * maxx, double * maxy, LayerTiming & timing)
+{
+  auto start = std::chrono::steady_clock::now();
+  double prev_minx = *minx;
+  double prev_miny = *miny;
+  double prev_maxx = *maxx;
+  double prev_maxy = *maxy;
+  layer.updateBounds(robot_x, robot_y, robot_yaw, minx, miny, maxx, maxy);
+  if (*minx > prev_minx || *miny > prev_miny || *maxx < prev_maxx || *maxy < prev_maxy) {
+    RCLCPP_WARN(
+      rclcpp::get_logger(
+        "nav2_costmap_2d"), "Illegal bounds change, was [tl: (%f, %f), br: (%f, %f)], but "
+      "is now [tl: (%f, %f), br: (%f, %f)]. The offending %s is %s",
+      prev_minx, prev_miny, prev_maxx, prev_maxy,
+      *minx, *miny, *maxx, *maxy,
+      kind, layer.getName().c_str());
+  }
+  timing.update_bounds_time =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t LayeredCostmap::getPluginGroupEnd(size_t first)
+{
+  size_t last = first + 1;
+  if (layer_threads_ > 1 && plugins_[first]->isOrderIndependent()) {
+    while (last < plugins_.size() && plugins_[last]->isOrderIndependent()) {
+      last++;
+    }
+  }
+  return last;
+}
+
+template<typename TaskT>
+void LayeredCostmap::runConcurrently(size_t num_tasks, const TaskT & task)
+{
+  // Exceptions may not leave the parallel region, so are rethrown after it
+  std::vector<std::exception_ptr> exceptions(num_tasks);
+  const int num_threads = std::min(layer_threads_, static_cast<int>(num_tasks));
+
+  #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+  for (int k = 0; k < static_cast<int>(num_tasks); k++) {
+    try {
+      task(k);
+    } catch (...) {
+      exceptions[k] = std::current_exception();
+    }
+  }
+
+  for (const auto & exception : exceptions) {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+}
+
+void LayeredCostmap::mergeWithMax(
+  Costmap2D & master_grid, const Costmap2D & grid, int min_i, int min_j, int max_i, int max_j)
+{
+  unsigned char * master_array = master_grid.getCharMap();
+  const unsigned char * grid_array = grid.getCharMap();
+  const unsigned int span = master_grid.getSizeInCellsX();
+
+  // Branch free so it vectorizes
+  for (int j = min_j; j < max_j; j++) {
+    unsigned char * master_row = master_array + j * span;
+    const unsigned char * grid_row = grid_array + j * span;
+    for (int i = min_i; i < max_i; i++) {
+      const unsigned char cost = grid_row[i];
+      const unsigned char old_cost = master_row[i];
+      master_row[i] =
+        (cost != NO_INFORMATION && (old_cost == NO_INFORMATION || old_cost < cost)) ?
+        cost : old_cost;
+    }
+  }
+}
+
 bool LayeredCostmap::isCurrent()
 {
   current_ = true;
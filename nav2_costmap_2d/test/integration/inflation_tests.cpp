@@ -33,10 +33,15 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <map>
 #include <memory>
+#include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "nav2_costmap_2d/costmap_2d.hpp"
@@ -75,6 +80,13 @@ public:
     std::shared_ptr<nav2_costmap_2d::InflationLayer> & ilayer,
     double inflation_radius);
 
+  void validateParallelInflation(
+    const nav2_costmap_2d::Costmap2D & obstacles,
+    const nav2_costmap_2d::Costmap2D & serial,
+    const nav2_costmap_2d::Costmap2D & parallel,
+    std::shared_ptr<nav2_costmap_2d::InflationLayer> & ilayer,
+    int radius);
+
   void initNode(std::vector<rclcpp::Parameter> parameters);
   void initNode(double inflation_radius);
 
@@ -176,6 +188,48 @@ void TestNode::validatePointInflation(
   delete[] seen;
 }
 
+// Test that parallel inflation costs differ from the serial ones only by which obstacle
+// within the radius claimed a cell first, and then rarely
+void TestNode::validateParallelInflation(
+  const nav2_costmap_2d::Costmap2D & obstacles,
+  const nav2_costmap_2d::Costmap2D & serial,
+  const nav2_costmap_2d::Costmap2D & parallel,
+  std::shared_ptr<nav2_costmap_2d::InflationLayer> & ilayer,
+  int radius)
+{
+  const int size_x = static_cast<int>(obstacles.getSizeInCellsX());
+  const int size_y = static_cast<int>(obstacles.getSizeInCellsY());
+  unsigned int num_different = 0;
+  for (int j = 0; j < size_y; j++) {
+    for (int i = 0; i < size_x; i++) {
+      const unsigned char serial_cost = serial.getCost(i, j);
+      const unsigned char parallel_cost = parallel.getCost(i, j);
+      if (serial_cost == parallel_cost) {
+        continue;
+      }
+      num_different++;
+
+      bool serial_found = false, parallel_found = false;
+      for (int y = std::max(0, j - radius); y <= std::min(size_y - 1, j + radius); y++) {
+        for (int x = std::max(0, i - radius); x <= std::min(size_x - 1, i + radius); x++) {
+          const double distance = std::hypot(x - i, y - j);
+          const unsigned char obstacle_cost = obstacles.getCost(x, y);
+          if (distance > radius || (obstacle_cost != nav2_costmap_2d::LETHAL_OBSTACLE &&
+            obstacle_cost != nav2_costmap_2d::NO_INFORMATION))
+          {
+            continue;
+          }
+          const unsigned char cost = ilayer->computeCost(distance);
+          serial_found = serial_found || cost == serial_cost;
+          parallel_found = parallel_found || cost == parallel_cost;
+        }
+      }
+      EXPECT_TRUE(serial_found && parallel_found) << "at " << i << ", " << j;
+    }
+  }
+  EXPECT_LE(num_different, size_x * size_y / 200u);
+}
+
 void TestNode::initNode(std::vector<rclcpp::Parameter> parameters)
 {
   auto options = rclcpp::NodeOptions();
@@ -600,3 +654,282 @@ TEST_F(TestNode, testInflation3)
   ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::LETHAL_OBSTACLE), 1u);
   ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE), 4u);
 }
+
+/**
+ * Test that inflating bands of rows in parallel gives the costs of inflating serially
+ */
+TEST_F(TestNode, testParallelInflation)
+{
+  std::vector<rclcpp::Parameter> parameters;
+  for (const std::string name : {"inflation", "parallel_inflation"}) {
+    parameters.push_back(rclcpp::Parameter(name + ".cost_scaling_factor", 1.0));
+    parameters.push_back(rclcpp::Parameter(name + ".inflation_radius", 4.1));
+    parameters.push_back(rclcpp::Parameter(name + ".inflate_around_unknown", true));
+  }
+  parameters.push_back(rclcpp::Parameter("parallel_inflation.inflation_threads", 4));
+  initNode(parameters);
+
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(100, 100, 1, 0, 0);
+
+  std::shared_ptr<nav2_costmap_2d::InflationLayer> ilayer = nullptr;
+  addInflationLayer(layers, tf, node_, ilayer);
+  auto parallel_ilayer = std::make_shared<nav2_costmap_2d::InflationLayer>();
+  parallel_ilayer->initialize(&layers, "parallel_inflation", &tf, node_, nullptr, nullptr);
+  layers.addPlugin(parallel_ilayer);
+
+  // Footprint with inscribed radius = 2.1
+  // circumscribed radius = 3.1
+  setRadii(layers, 2.1, 2.3);
+
+  // Scattered obstacles and unknown cells
+  nav2_costmap_2d::Costmap2D serial(100, 100, 1, 0, 0);
+  srand(1);
+  for (unsigned int j = 0; j < 100; j++) {
+    for (unsigned int i = 0; i < 100; i++) {
+      const int r = rand() % 100;
+      if (r < 2) {
+        serial.setCost(i, j, nav2_costmap_2d::LETHAL_OBSTACLE);
+      } else if (r < 3) {
+        serial.setCost(i, j, nav2_costmap_2d::NO_INFORMATION);
+      }
+    }
+  }
+  nav2_costmap_2d::Costmap2D parallel(serial);
+  const nav2_costmap_2d::Costmap2D obstacles(serial);
+  const int radius = static_cast<int>(layers.getCostmap()->cellDistance(4.1));
+
+  ilayer->updateCosts(serial, 0, 0, 100, 100);
+  parallel_ilayer->updateCosts(parallel, 0, 0, 100, 100);
+  validateParallelInflation(obstacles, serial, parallel, ilayer, radius);
+  ilayer->updateCosts(serial, 10, 20, 80, 90);
+  parallel_ilayer->updateCosts(parallel, 10, 20, 80, 90);
+  validateParallelInflation(obstacles, serial, parallel, ilayer, radius);
+}
+
+/**
+ * Test parallel inflation against the serial one on small cells, with sparse to dense obstacles
+ */
+TEST_F(TestNode, testParallelInflationManyObstacles)
+{
+  std::vector<rclcpp::Parameter> parameters;
+  for (const std::string name : {"inflation", "parallel_inflation"}) {
+    parameters.push_back(rclcpp::Parameter(name + ".cost_scaling_factor", 3.0));
+    parameters.push_back(rclcpp::Parameter(name + ".inflation_radius", 0.8));
+  }
+  parameters.push_back(rclcpp::Parameter("parallel_inflation.inflation_threads", 4));
+  initNode(parameters);
+
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(150, 150, 0.05, 0, 0);
+
+  std::shared_ptr<nav2_costmap_2d::InflationLayer> ilayer = nullptr;
+  addInflationLayer(layers, tf, node_, ilayer);
+  auto parallel_ilayer = std::make_shared<nav2_costmap_2d::InflationLayer>();
+  parallel_ilayer->initialize(&layers, "parallel_inflation", &tf, node_, nullptr, nullptr);
+  layers.addPlugin(parallel_ilayer);
+  setRadii(layers, 0.15, 0.2);
+
+  const int size = 150;
+  const int radius = static_cast<int>(layers.getCostmap()->cellDistance(0.8));
+  std::mt19937 random(7);
+  for (const double density : {0.005, 0.02, 0.1}) {
+    SCOPED_TRACE("with obstacle density " + std::to_string(density));
+    std::bernoulli_distribution is_obstacle(density);
+    nav2_costmap_2d::Costmap2D serial(size, size, 0.05, 0, 0);
+    for (int j = 0; j < size; j++) {
+      for (int i = 0; i < size; i++) {
+        if (is_obstacle(random)) {
+          serial.setCost(i, j, nav2_costmap_2d::LETHAL_OBSTACLE);
+        }
+      }
+    }
+    nav2_costmap_2d::Costmap2D parallel(serial);
+    const nav2_costmap_2d::Costmap2D obstacles(serial);
+
+    ilayer->updateCosts(serial, 0, 0, size, size);
+    parallel_ilayer->updateCosts(parallel, 0, 0, size, size);
+    validateParallelInflation(obstacles, serial, parallel, ilayer, radius);
+  }
+}
+
+/**
+ * Test the distance transform against the wavefront and the exact distances to obstacles
+ */
+TEST_F(TestNode, testDistanceTransformInflation)
+{
+  const double inflation_radius = 4.1;
+  std::vector<rclcpp::Parameter> parameters;
+  for (const std::string name : {"inflation", "edt_inflation"}) {
+    parameters.push_back(rclcpp::Parameter(name + ".cost_scaling_factor", 1.0));
+    parameters.push_back(rclcpp::Parameter(name + ".inflation_radius", inflation_radius));
+    parameters.push_back(rclcpp::Parameter(name + ".inflate_around_unknown", true));
+  }
+  parameters.push_back(
+    rclcpp::Parameter("edt_inflation.inflation_method", std::string("distance_transform")));
+  initNode(parameters);
+
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(100, 100, 1, 0, 0);
+
+  std::shared_ptr<nav2_costmap_2d::InflationLayer> ilayer = nullptr;
+  addInflationLayer(layers, tf, node_, ilayer);
+  auto edt_ilayer = std::make_shared<nav2_costmap_2d::InflationLayer>();
+  edt_ilayer->initialize(&layers, "edt_inflation", &tf, node_, nullptr, nullptr);
+  layers.addPlugin(edt_ilayer);
+
+  // Footprint with inscribed radius = 2.1
+  // circumscribed radius = 3.1
+  setRadii(layers, 2.1, 2.3);
+
+  // Obstacles and unknown cells farther apart than twice the inflation radius,
+  // including on the map's edges, inflate identically cell for cell
+  nav2_costmap_2d::Costmap2D wavefront(100, 100, 1, 0, 0);
+  for (unsigned int j = 0; j < 100; j += 11) {
+    for (unsigned int i = (j / 11) % 3; i < 100; i += 13) {
+      wavefront.setCost(
+        i, j, (i + j) % 2 ? nav2_costmap_2d::LETHAL_OBSTACLE : nav2_costmap_2d::NO_INFORMATION);
+    }
+  }
+  nav2_costmap_2d::Costmap2D edt(wavefront);
+
+  ilayer->updateCosts(wavefront, 0, 0, 100, 100);
+  edt_ilayer->updateCosts(edt, 0, 0, 100, 100);
+  ilayer->updateCosts(wavefront, 10, 20, 80, 90);
+  edt_ilayer->updateCosts(edt, 10, 20, 80, 90);
+
+  for (unsigned int j = 0; j < 100; j++) {
+    for (unsigned int i = 0; i < 100; i++) {
+      ASSERT_EQ(wavefront.getCost(i, j), edt.getCost(i, j));
+    }
+  }
+
+  // With dense obstacles, where the wavefronts of nearby obstacles may underestimate
+  // costs, they are those of the exact distance to the nearest obstacle
+  nav2_costmap_2d::Costmap2D dense(100, 100, 1, 0, 0);
+  std::vector<std::pair<int, int>> obstacles;
+  srand(1);
+  for (int j = 0; j < 100; j++) {
+    for (int i = 0; i < 100; i++) {
+      if (rand() % 100 < 3) {
+        dense.setCost(i, j, nav2_costmap_2d::LETHAL_OBSTACLE);
+        obstacles.emplace_back(i, j);
+      }
+    }
+  }
+  wavefront = dense;
+  edt = dense;
+  ilayer->updateCosts(wavefront, 0, 0, 100, 100);
+  edt_ilayer->updateCosts(edt, 0, 0, 100, 100);
+
+  for (int j = 0; j < 100; j++) {
+    for (int i = 0; i < 100; i++) {
+      double distance = std::numeric_limits<double>::max();
+      for (const auto & obstacle : obstacles) {
+        distance = std::min(distance, std::hypot(i - obstacle.first, j - obstacle.second));
+      }
+      // the inflation radius is rounded up to 5 cells
+      const unsigned char expected_cost = distance <= 5.0 ? ilayer->computeCost(distance) : 0;
+      ASSERT_EQ(edt.getCost(i, j), expected_cost);
+      ASSERT_GE(edt.getCost(i, j), wavefront.getCost(i, j));
+    }
+  }
+}
+
+TEST_F(TestNode, testIncrementalInflation)
+{
+  std::vector<rclcpp::Parameter> parameters;
+  for (const std::string name : {"edt_inflation", "incremental_inflation"}) {
+    parameters.push_back(rclcpp::Parameter(name + ".cost_scaling_factor", 1.0));
+    parameters.push_back(rclcpp::Parameter(name + ".inflation_radius", 4.1));
+    parameters.push_back(rclcpp::Parameter(name + ".inflate_around_unknown", true));
+  }
+  parameters.push_back(
+    rclcpp::Parameter("edt_inflation.inflation_method", std::string("distance_transform")));
+  parameters.push_back(
+    rclcpp::Parameter(
+      "incremental_inflation.inflation_method", std::string("incremental_distance_transform")));
+  initNode(parameters);
+
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(100, 100, 1, 0, 0);
+
+  auto edt_ilayer = std::make_shared<nav2_costmap_2d::InflationLayer>();
+  edt_ilayer->initialize(&layers, "edt_inflation", &tf, node_, nullptr, nullptr);
+  layers.addPlugin(edt_ilayer);
+  auto incremental_ilayer = std::make_shared<nav2_costmap_2d::InflationLayer>();
+  incremental_ilayer->initialize(&layers, "incremental_inflation", &tf, node_, nullptr, nullptr);
+  layers.addPlugin(incremental_ilayer);
+
+  // Footprint with inscribed radius = 2.1
+  // circumscribed radius = 3.1
+  setRadii(layers, 2.1, 2.3);
+
+  // Obstacles and unknown cells as the layers below the inflation layer set them,
+  // which the layered costmap copies into each window before inflating it
+  nav2_costmap_2d::Costmap2D obstacles(100, 100, 1, 0, 0);
+  nav2_costmap_2d::Costmap2D edt(100, 100, 1, 0, 0);
+  nav2_costmap_2d::Costmap2D incremental(100, 100, 1, 0, 0);
+  auto update = [&](int min_i, int min_j, int max_i, int max_j) {
+      for (int j = min_j; j < max_j; j++) {
+        for (int i = min_i; i < max_i; i++) {
+          edt.setCost(i, j, obstacles.getCost(i, j));
+          incremental.setCost(i, j, obstacles.getCost(i, j));
+        }
+      }
+      edt_ilayer->updateCosts(edt, min_i, min_j, max_i, max_j);
+      incremental_ilayer->updateCosts(incremental, min_i, min_j, max_i, max_j);
+    };
+  auto addRandomObstacles = [&](int min_i, int min_j, int max_i, int max_j) {
+      for (int j = min_j; j < max_j; j++) {
+        for (int i = min_i; i < max_i; i++) {
+          const int r = rand() % 100;
+          obstacles.setCost(
+            i, j, r < 3 ? nav2_costmap_2d::LETHAL_OBSTACLE :
+            (r < 5 ? nav2_costmap_2d::NO_INFORMATION : nav2_costmap_2d::FREE_SPACE));
+        }
+      }
+    };
+
+  srand(2);
+  addRandomObstacles(0, 0, 100, 100);
+  update(0, 0, 100, 100);
+
+  // Costs stay those of the full distance transform as obstacles change in small windows,
+  // including where their inflation reaches past the window, and as the map moves
+  for (int step = 0; step < 40; step++) {
+    if (step % 10 == 9) {
+      const double dx = (rand() % 21) - 10;
+      const double dy = (rand() % 21) - 10;
+      const double origin_x = obstacles.getOriginX() + dx;
+      const double origin_y = obstacles.getOriginY() + dy;
+      obstacles.updateOrigin(origin_x, origin_y);
+      edt.updateOrigin(origin_x, origin_y);
+      incremental.updateOrigin(origin_x, origin_y);
+      addRandomObstacles(0, 0, 100, std::abs(dy));
+      addRandomObstacles(0, 100 - std::abs(dy), 100, 100);
+      addRandomObstacles(0, 0, std::abs(dx), 100);
+      addRandomObstacles(100 - std::abs(dx), 0, 100, 100);
+      update(0, 0, 100, 100);
+    } else {
+      const int min_i = rand() % 90;
+      const int min_j = rand() % 90;
+      const int max_i = min_i + 1 + rand() % 10;
+      const int max_j = min_j + 1 + rand() % 10;
+      addRandomObstacles(min_i, min_j, max_i, max_j);
+      update(
+        std::max(0, min_i - 5), std::max(0, min_j - 5),
+        std::min(100, max_i + 5), std::min(100, max_j + 5));
+    }
+
+    for (unsigned int j = 0; j < 100; j++) {
+      for (unsigned int i = 0; i < 100; i++) {
+        ASSERT_EQ(edt.getCost(i, j), incremental.getCost(i, j));
+      }
+    }
+  }
+}
@@ -407,3 +407,86 @@ TEST_F(TestNode, testRaytracing) {
   ASSERT_EQ(lethal_count, 1);
 
 }
+
+/**
+ * Test that obstacle layers updated concurrently give the same costmap as sequentially
+ */
+TEST_F(TestNode, testConcurrentLayers) {
+  tf2_ros::Buffer tf(node_->get_clock());
+
+  nav2_costmap_2d::LayeredCostmap sequential("frame", false, false);
+  nav2_costmap_2d::LayeredCostmap concurrent("frame", false, false);
+  concurrent.setLayerThreads(2);
+
+  for (auto layers : {&sequential, &concurrent}) {
+    layers->resizeMap(10, 10, 1, 0, 0);
+
+    std::shared_ptr<nav2_costmap_2d::StaticLayer> slayer = nullptr;
+    addStaticLayer(*layers, tf, node_, slayer);
+    std::shared_ptr<nav2_costmap_2d::ObstacleLayer> olayer = nullptr;
+    addObstacleLayer(*layers, tf, node_, olayer);
+    auto olayer2 = std::make_shared<nav2_costmap_2d::ObstacleLayer>();
+    olayer2->initialize(layers, "obstacles2", &tf, node_, nullptr, nullptr);
+    layers->addPlugin(std::shared_ptr<nav2_costmap_2d::Layer>(olayer2));
+
+    addObservation(olayer, 5.0, 5.0, MAX_Z / 2, 0, 0, MAX_Z / 2);
+    addObservation(olayer2, 2.0, 7.0, MAX_Z / 2, 0, 0, MAX_Z / 2);
+    addObservation(olayer2, 5.0, 5.0, MAX_Z / 2, 0, 0, MAX_Z / 2);
+    layers->updateMap(0, 0, 0);
+  }
+
+  ASSERT_EQ(countValues(*(concurrent.getCostmap()), nav2_costmap_2d::LETHAL_OBSTACLE), 2);
+  for (unsigned int j = 0; j < 10; j++) {
+    for (unsigned int i = 0; i < 10; i++) {
+      ASSERT_EQ(sequential.getCostmap()->getCost(i, j), concurrent.getCostmap()->getCost(i, j));
+    }
+  }
+
+  // Each layer was timed, in order
+  const auto & timings = concurrent.getLayerTimings();
+  ASSERT_EQ(timings.size(), 3u);
+  ASSERT_EQ(timings[0].name, "static");
+  ASSERT_EQ(timings[1].name, "obstacles");
+  ASSERT_EQ(timings[2].name, "obstacles2");
+  for (const auto & timing : timings) {
+    ASSERT_GE(timing.update_bounds_time, 0.0);
+    ASSERT_GE(timing.update_costs_time, 0.0);
+  }
+}
+
+/**
+ * Test that concurrently updated layers follow a rolling window as it moves
+ */
+TEST_F(TestNode, testConcurrentLayersRolling) {
+  tf2_ros::Buffer tf(node_->get_clock());
+
+  nav2_costmap_2d::LayeredCostmap sequential("frame", true, false);
+  nav2_costmap_2d::LayeredCostmap concurrent("frame", true, false);
+  concurrent.setLayerThreads(2);
+
+  for (auto layers : {&sequential, &concurrent}) {
+    layers->resizeMap(10, 10, 1, 0, 0);
+
+    std::shared_ptr<nav2_costmap_2d::ObstacleLayer> olayer = nullptr;
+    addObstacleLayer(*layers, tf, node_, olayer);
+    auto olayer2 = std::make_shared<nav2_costmap_2d::ObstacleLayer>();
+    olayer2->initialize(layers, "obstacles2", &tf, node_, nullptr, nullptr);
+    layers->addPlugin(std::shared_ptr<nav2_costmap_2d::Layer>(olayer2));
+
+    addObservation(olayer, 3.0, 2.0, MAX_Z / 2, 0, 0, MAX_Z / 2);
+    addObservation(olayer2, 1.0, 4.0, MAX_Z / 2, 0, 0, MAX_Z / 2);
+    layers->updateMap(0, 0, 0);
+    addObservation(olayer, 5.0, 6.0, MAX_Z / 2, 0, 0, MAX_Z / 2);
+    layers->updateMap(2.0, 3.0, 0);
+  }
+
+  auto & costmap = *(concurrent.getCostmap());
+  ASSERT_EQ(costmap.getOriginX(), sequential.getCostmap()->getOriginX());
+  ASSERT_EQ(costmap.getOriginY(), sequential.getCostmap()->getOriginY());
+  ASSERT_GT(countValues(costmap, nav2_costmap_2d::LETHAL_OBSTACLE), 0u);
+  for (unsigned int j = 0; j < 10; j++) {
+    for (unsigned int i = 0; i < 10; i++) {
+      ASSERT_EQ(sequential.getCostmap()->getCost(i, j), costmap.getCost(i, j));
+    }
+  }
+}
@@ -50,3 +50,27 @@ TEST(CopyWindow, copyInvalidWindow)
   ASSERT_FALSE(dst.copyWindow(src, 0, 0, 1, 1, 5, 5));
   ASSERT_FALSE(dst.copyWindow(src, 0, 0, 6, 6, 0, 0));
 }
+
+TEST(CopyWindow, copyAssign)
+{
+  nav2_costmap_2d::Costmap2D src(10, 10, 0.1, 1.0, 2.0);
+  nav2_costmap_2d::Costmap2D dst(10, 10, 0.2, 0.0, 0.0);
+  src.setCost(2, 2, 100);
+
+  // Same size, the allocation is reused but contents and geometry copied
+  const unsigned char * charmap = dst.getCharMap();
+  dst = src;
+  ASSERT_EQ(dst.getCharMap(), charmap);
+  ASSERT_EQ(dst.getCost(2, 2), 100);
+  ASSERT_EQ(dst.getResolution(), 0.1);
+  ASSERT_EQ(dst.getOriginX(), 1.0);
+  ASSERT_EQ(dst.getOriginY(), 2.0);
+
+  // Different size
+  nav2_costmap_2d::Costmap2D larger(20, 5, 0.1, 0.0, 0.0);
+  larger.setCost(19, 4, 200);
+  dst = larger;
+  ASSERT_EQ(dst.getSizeInCellsX(), 20u);
+  ASSERT_EQ(dst.getSizeInCellsY(), 5u);
+  ASSERT_EQ(dst.getCost(19, 4), 200);
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_2d_publisher.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+// The occupancy grid value of a cost, as cost_translation_table_ is defined
+int8_t translateCost(const unsigned int & cost)
+{
+  if (cost == 0) {
+    return 0;
+  } else if (cost == 253) {
+    return 99;
+  } else if (cost == 254) {
+    return 100;
+  } else if (cost == 255) {
+    return -1;
+  }
+  return static_cast<int8_t>(1 + (97 * (cost - 1)) / 251);
+}
+
+class CostTranslationTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // The translation table is set up by the first publisher constructed
+    node_ = std::make_shared<nav2_util::LifecycleNode>("cost_translation_test");
+    costmap_ = std::make_unique<nav2_costmap_2d::Costmap2D>(10, 10, 0.05, 0.0, 0.0);
+    publisher_ = std::make_unique<nav2_costmap_2d::Costmap2DPublisher>(
+      node_, costmap_.get(), "map", "costmap");
+  }
+
+  nav2_util::LifecycleNode::SharedPtr node_;
+  std::unique_ptr<nav2_costmap_2d::Costmap2D> costmap_;
+  std::unique_ptr<nav2_costmap_2d::Costmap2DPublisher> publisher_;
+};
+
+TEST_F(CostTranslationTest, allCosts)
+{
+  std::vector<unsigned char> costs(256);
+  for (unsigned int i = 0; i != costs.size(); i++) {
+    costs[i] = static_cast<unsigned char>(i);
+  }
+
+  std::vector<int8_t> translated(costs.size());
+  nav2_costmap_2d::Costmap2DPublisher::translateCosts(
+    costs.data(), translated.data(), costs.size());
+  for (unsigned int i = 0; i != costs.size(); i++) {
+    EXPECT_EQ(translated[i], translateCost(i)) << "cost " << i;
+  }
+}
+
+TEST_F(CostTranslationTest, unalignedLengthsAndOffsets)
+{
+  // Each cost at every position of the vector lanes, with a leftover tail
+  std::vector<unsigned char> costs(600);
+  for (unsigned int i = 0; i != costs.size(); i++) {
+    costs[i] = static_cast<unsigned char>(i * 7 + 3);
+  }
+
+  // Lengths and offsets not multiples of the 16 or 32 costs translated at once, and no
+  // values written past either end
+  const int8_t sentinel = 55;
+  std::vector<int8_t> translated(costs.size());
+  for (unsigned int offset = 0; offset != 40; offset++) {
+    for (unsigned int size = 0; size <= 300; size++) {
+      std::fill(translated.begin(), translated.end(), sentinel);
+      nav2_costmap_2d::Costmap2DPublisher::translateCosts(
+        costs.data() + offset, translated.data() + offset, size);
+      for (unsigned int i = 0; i != translated.size(); i++) {
+        const int8_t expected =
+          i >= offset && i < offset + size ? translateCost(costs[i]) : sentinel;
+        ASSERT_EQ(translated[i], expected) << "offset " << offset << ", size " << size <<
+          ", index " << i;
+      }
+    }
+  }
+}
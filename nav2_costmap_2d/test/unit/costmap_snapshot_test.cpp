@@ -0,0 +1,94 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_snapshot_source.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+TEST(CostmapSnapshot, snapshotsAreImmutable)
+{
+  nav2_costmap_2d::Costmap2D costmap(10, 10, 0.1, 0.0, 0.0);
+  nav2_costmap_2d::CostmapSnapshotSource source;
+  EXPECT_FALSE(source.isRequested());
+  EXPECT_EQ(source.getSnapshot(), nullptr);
+  EXPECT_TRUE(source.isRequested());
+
+  costmap.setCost(2, 2, 100);
+  source.update(costmap);
+  auto first = source.getSnapshot();
+  ASSERT_NE(first, nullptr);
+
+  // Held snapshots keep their costs as the costmap and later snapshots change
+  costmap.setCost(2, 2, 200);
+  costmap.resizeMap(20, 20, 0.05, 1.0, 1.0);
+  source.update(costmap);
+  auto second = source.getSnapshot();
+  ASSERT_NE(second, first);
+  EXPECT_EQ(first->getCost(2, 2), 100);
+  EXPECT_EQ(first->getSizeInCellsX(), 10u);
+  EXPECT_EQ(second->getCost(2, 2), 0);
+  EXPECT_EQ(second->getSizeInCellsX(), 20u);
+  EXPECT_DOUBLE_EQ(second->getOriginX(), 1.0);
+}
+
+TEST(CostmapSnapshot, releasedFramesAreReused)
+{
+  nav2_costmap_2d::Costmap2D costmap(10, 10, 0.1, 0.0, 0.0);
+  nav2_costmap_2d::CostmapSnapshotSource source;
+
+  source.update(costmap);
+  const nav2_costmap_2d::Costmap2D * first = source.getSnapshot().get();
+  source.update(costmap);
+  const nav2_costmap_2d::Costmap2D * second = source.getSnapshot().get();
+  EXPECT_NE(first, second);
+
+  // The first frame is neither held nor the latest snapshot anymore
+  costmap.setCost(5, 5, 254);
+  source.update(costmap);
+  auto third = source.getSnapshot();
+  EXPECT_EQ(third.get(), first);
+  EXPECT_EQ(third->getCost(5, 5), 254);
+
+  // Held by a consumer, so taken into the other frame
+  source.update(costmap);
+  EXPECT_EQ(source.getSnapshot().get(), second);
+  EXPECT_EQ(third->getCost(5, 5), 254);
+}
+
+TEST(CostmapSnapshot, sourcesAreFoundByTopic)
+{
+  EXPECT_EQ(nav2_costmap_2d::CostmapSnapshotSource::find("/snapshot_test/costmap_raw"), nullptr);
+
+  auto source = std::make_shared<nav2_costmap_2d::CostmapSnapshotSource>();
+  nav2_costmap_2d::CostmapSnapshotSource::advertise("/snapshot_test/costmap_raw", source);
+  EXPECT_EQ(
+    nav2_costmap_2d::CostmapSnapshotSource::find("/snapshot_test/costmap_raw"), source);
+  EXPECT_EQ(nav2_costmap_2d::CostmapSnapshotSource::find("/other/costmap_raw"), nullptr);
+
+  // Not found once destroyed
+  source.reset();
+  EXPECT_EQ(nav2_costmap_2d::CostmapSnapshotSource::find("/snapshot_test/costmap_raw"), nullptr);
+}
@@ -0,0 +1,298 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_2d_publisher.hpp"
+#include "nav2_costmap_2d/costmap_subscriber.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+
+using namespace std::chrono_literals;
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+// Subscriber fed the recorded messages by the test, in any order or with some dropped
+class CostmapSubscriberWrapper : public nav2_costmap_2d::CostmapSubscriber
+{
+public:
+  using nav2_costmap_2d::CostmapSubscriber::CostmapSubscriber;
+
+  void receiveCostmap(const nav2_msgs::msg::Costmap::SharedPtr msg)
+  {
+    costmapCallback(msg);
+  }
+
+  void receiveUpdate(const nav2_msgs::msg::CostmapUpdate::SharedPtr msg)
+  {
+    costmapUpdateCallback(msg);
+  }
+};
+
+class CostmapUpdatesTest : public ::testing::TestWithParam<bool>
+{
+protected:
+  void SetUp() override
+  {
+    node_ = std::make_shared<nav2_util::LifecycleNode>("costmap_updates_test");
+    costmap_ = std::make_unique<nav2_costmap_2d::Costmap2D>(300, 40, 0.05, 1.0, -2.0);
+    publisher_ = std::make_unique<nav2_costmap_2d::Costmap2DPublisher>(
+      node_, costmap_.get(), "map", "costmap", false, true, GetParam());
+    publisher_->on_activate();
+
+    costmap_sub_ = node_->create_subscription<nav2_msgs::msg::Costmap>(
+      "costmap_raw", rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+      [this](const nav2_msgs::msg::Costmap::SharedPtr msg) {costmaps_.push_back(msg);});
+    update_sub_ = node_->create_subscription<nav2_msgs::msg::CostmapUpdate>(
+      "costmap_raw_updates",
+      rclcpp::QoS(rclcpp::KeepLast(nav2_costmap_2d::Costmap2DPublisher::RAW_FULL_COSTMAP_PERIOD))
+      .transient_local().reliable(),
+      [this](const nav2_msgs::msg::CostmapUpdate::SharedPtr msg) {updates_.push_back(msg);});
+
+    // Not subscribed to the published topics, only fed what the test chooses
+    subscriber_ = std::make_unique<CostmapSubscriberWrapper>(node_, "unused_costmap_raw");
+
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (node_->count_subscribers("costmap_raw") == 0 &&
+      std::chrono::steady_clock::now() < deadline)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+
+  void TearDown() override
+  {
+    publisher_->on_deactivate();
+  }
+
+  // Set random costs within a window, then publish the costmap and wait for its message
+  void changeAndPublish(
+    const unsigned int & x0, const unsigned int & xn,
+    const unsigned int & y0, const unsigned int & yn)
+  {
+    std::uniform_int_distribution<int> cost(0, 255);
+    std::uniform_int_distribution<int> run(1, 400);
+    const unsigned int size_x = costmap_->getSizeInCellsX();
+    const unsigned int size_y = costmap_->getSizeInCellsY();
+    for (unsigned int y = y0; y < std::min(yn, size_y); y++) {
+      // Runs of equal costs, some longer than a single run-length encoded pair
+      unsigned int x = x0;
+      while (x < std::min(xn, size_x)) {
+        const unsigned char value = static_cast<unsigned char>(cost(random_));
+        const unsigned int run_end = std::min({x + run(random_), xn, size_x});
+        for (; x < run_end; x++) {
+          costmap_->setCost(x, y, value);
+        }
+      }
+    }
+    publisher_->updateBounds(x0, xn, y0, yn);
+    publish();
+  }
+
+  void publish()
+  {
+    const size_t num_messages = costmaps_.size() + updates_.size();
+    publisher_->publishCostmap();
+
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (costmaps_.size() + updates_.size() == num_messages &&
+      std::chrono::steady_clock::now() < deadline)
+    {
+      rclcpp::spin_some(node_->get_node_base_interface());
+      std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_EQ(costmaps_.size() + updates_.size(), num_messages + 1);
+  }
+
+  void expectMatches(const nav2_costmap_2d::Costmap2D & costmap)
+  {
+    auto received = subscriber_->getCostmap();
+    ASSERT_EQ(received->getSizeInCellsX(), costmap.getSizeInCellsX());
+    ASSERT_EQ(received->getSizeInCellsY(), costmap.getSizeInCellsY());
+    EXPECT_DOUBLE_EQ(received->getResolution(), costmap.getResolution());
+    for (unsigned int y = 0; y < costmap.getSizeInCellsY(); y++) {
+      for (unsigned int x = 0; x < costmap.getSizeInCellsX(); x++) {
+        ASSERT_EQ(received->getCost(x, y), costmap.getCost(x, y)) << "at " << x << ", " << y;
+      }
+    }
+  }
+
+  std::mt19937 random_{42};
+  nav2_util::LifecycleNode::SharedPtr node_;
+  std::unique_ptr<nav2_costmap_2d::Costmap2D> costmap_;
+  std::unique_ptr<nav2_costmap_2d::Costmap2DPublisher> publisher_;
+  std::unique_ptr<CostmapSubscriberWrapper> subscriber_;
+  rclcpp::Subscription<nav2_msgs::msg::Costmap>::SharedPtr costmap_sub_;
+  rclcpp::Subscription<nav2_msgs::msg::CostmapUpdate>::SharedPtr update_sub_;
+  std::vector<nav2_msgs::msg::Costmap::SharedPtr> costmaps_;
+  std::vector<nav2_msgs::msg::CostmapUpdate::SharedPtr> updates_;
+};
+
+TEST_P(CostmapUpdatesTest, updatesMatchSource)
+{
+  // The first publication is in full, the following ones of the changed window
+  changeAndPublish(0, 300, 0, 40);
+  ASSERT_EQ(costmaps_.size(), 1u);
+  subscriber_->receiveCostmap(costmaps_.back());
+  expectMatches(*costmap_);
+
+  // Windows inside, along the edges of, and reaching past the costmap
+  changeAndPublish(10, 20, 5, 9);
+  changeAndPublish(0, 300, 0, 1);
+  changeAndPublish(299, 300, 0, 40);
+  changeAndPublish(280, 310, 35, 45);
+  changeAndPublish(0, 300, 0, 40);
+  ASSERT_EQ(costmaps_.size(), 1u);
+  ASSERT_EQ(updates_.size(), 5u);
+  EXPECT_EQ(updates_[3]->width, 20u);
+  EXPECT_EQ(updates_[3]->height, 5u);
+  const uint8_t compression = GetParam() ?
+    nav2_msgs::msg::CostmapUpdate::COMPRESSION_RLE :
+    nav2_msgs::msg::CostmapUpdate::COMPRESSION_NONE;
+  for (unsigned int i = 0; i != updates_.size(); i++) {
+    EXPECT_EQ(updates_[i]->sequence, i + 1);
+    EXPECT_EQ(updates_[i]->epoch, costmaps_.back()->epoch);
+    EXPECT_EQ(updates_[i]->compression, compression);
+  }
+
+  // Applied in sequence even if received out of order
+  subscriber_->receiveUpdate(updates_[1]);
+  subscriber_->receiveUpdate(updates_[0]);
+  subscriber_->receiveUpdate(updates_[2]);
+  subscriber_->receiveUpdate(updates_[4]);
+  subscriber_->receiveUpdate(updates_[3]);
+  expectMatches(*costmap_);
+
+  // Updates already applied are ignored if received again
+  subscriber_->receiveUpdate(updates_[2]);
+  expectMatches(*costmap_);
+}
+
+TEST_P(CostmapUpdatesTest, droppedUpdate)
+{
+  changeAndPublish(0, 300, 0, 40);
+  subscriber_->receiveCostmap(costmaps_.back());
+  changeAndPublish(0, 100, 0, 20);
+  const nav2_costmap_2d::Costmap2D after_first_update(*costmap_);
+  changeAndPublish(50, 250, 10, 30);
+  changeAndPublish(200, 300, 20, 40);
+  ASSERT_EQ(updates_.size(), 3u);
+
+  // The costmap stays as of the last update before the lost one, even once that arrives late
+  subscriber_->receiveUpdate(updates_[0]);
+  subscriber_->receiveUpdate(updates_[2]);
+  expectMatches(after_first_update);
+  subscriber_->receiveUpdate(updates_[1]);
+  expectMatches(after_first_update);
+
+  // Resynchronized by the next full costmap, which updates of the previous one do not apply to
+  const unsigned int period = nav2_costmap_2d::Costmap2DPublisher::RAW_FULL_COSTMAP_PERIOD;
+  for (unsigned int i = 3; i != period; i++) {
+    changeAndPublish(0, 10, 0, 10);
+  }
+  ASSERT_EQ(costmaps_.size(), 1u);
+  changeAndPublish(0, 10, 0, 10);
+  ASSERT_EQ(costmaps_.size(), 2u);
+  subscriber_->receiveCostmap(costmaps_.back());
+  subscriber_->receiveUpdate(updates_[3]);
+  expectMatches(*costmap_);
+
+  changeAndPublish(100, 200, 0, 40);
+  subscriber_->receiveUpdate(updates_.back());
+  expectMatches(*costmap_);
+}
+
+TEST_P(CostmapUpdatesTest, malformedUpdate)
+{
+  changeAndPublish(0, 300, 0, 40);
+  subscriber_->receiveCostmap(costmaps_.back());
+  const nav2_costmap_2d::Costmap2D before_updates(*costmap_);
+  changeAndPublish(0, 300, 0, 40);
+  changeAndPublish(0, 300, 0, 40);
+  ASSERT_EQ(updates_.size(), 2u);
+
+  // A truncated update is not applied and lost, along with the later ones
+  auto truncated = std::make_shared<nav2_msgs::msg::CostmapUpdate>(*updates_[0]);
+  truncated->data.resize(truncated->data.size() - 2);
+  subscriber_->receiveUpdate(truncated);
+  subscriber_->receiveUpdate(updates_[1]);
+  expectMatches(before_updates);
+}
+
+TEST_P(CostmapUpdatesTest, sameStampCostmaps)
+{
+  changeAndPublish(0, 300, 0, 40);
+  changeAndPublish(0, 100, 0, 40);
+  ASSERT_EQ(updates_.size(), 1u);
+
+  // Updates refer to the epoch of their full costmap, not its stamp
+  costmap_->resizeMap(120, 80, 0.1, 0.0, 0.0);
+  changeAndPublish(0, 120, 0, 80);
+  ASSERT_EQ(costmaps_.size(), 2u);
+  EXPECT_NE(costmaps_[0]->epoch, costmaps_[1]->epoch);
+  costmaps_[1]->header.stamp = costmaps_[0]->header.stamp;
+  subscriber_->receiveCostmap(costmaps_[1]);
+  subscriber_->receiveUpdate(updates_[0]);
+  expectMatches(*costmap_);
+}
+
+TEST_P(CostmapUpdatesTest, resize)
+{
+  changeAndPublish(0, 300, 0, 40);
+  subscriber_->receiveCostmap(costmaps_.back());
+  changeAndPublish(0, 50, 0, 40);
+  subscriber_->receiveUpdate(updates_.back());
+  expectMatches(*costmap_);
+
+  // A change of size or origin is published in full, which the subscriber resizes to
+  costmap_->resizeMap(120, 80, 0.1, 0.0, 0.0);
+  changeAndPublish(0, 120, 0, 80);
+  ASSERT_EQ(costmaps_.size(), 2u);
+  subscriber_->receiveCostmap(costmaps_.back());
+  expectMatches(*costmap_);
+
+  changeAndPublish(100, 120, 60, 80);
+  ASSERT_EQ(costmaps_.size(), 2u);
+  subscriber_->receiveUpdate(updates_.back());
+  expectMatches(*costmap_);
+
+  costmap_->updateOrigin(1.0, 1.0);
+  changeAndPublish(0, 120, 0, 80);
+  ASSERT_EQ(costmaps_.size(), 3u);
+  subscriber_->receiveCostmap(costmaps_.back());
+  auto received = subscriber_->getCostmap();
+  EXPECT_DOUBLE_EQ(received->getOriginX(), costmap_->getOriginX());
+  EXPECT_DOUBLE_EQ(received->getOriginY(), costmap_->getOriginY());
+  expectMatches(*costmap_);
+}
+
+INSTANTIATE_TEST_CASE_P(
+  CompressionTests,
+  CostmapUpdatesTest,
+  ::testing::Values(false, true));
@@ -19,6 +19,8 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <future>
+#include <mutex>
 #include <unordered_map>
 
 #include "geometry_msgs/msg/point.hpp"
@@ -27,7 +29,9 @@
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_msgs/action/compute_path_to_pose.hpp"
 #include "nav2_msgs/action/compute_path_through_poses.hpp"
+#include "nav2_msgs/action/compute_paths_to_poses.hpp"
 #include "nav2_msgs/msg/costmap.hpp"
+#include "nav2_msgs/msg/planner_portfolio_statistics.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/simple_action_server.hpp"
 #include "visualization_msgs/msg/marker.hpp"
@@ -70,6 +74,20 @@ public:
     const geometry_msgs::msg::PoseStamped & goal,
     const std::string & planner_id);
 
+  /**
+   * @brief Method to get plans to many goals from the desired plugin
+   * @param start starting pose
+   * @param goals goal poses
+   * @param planner_id planner to use
+   * @param costs cost of each path to set, -1 if there is none
+   * @return Path to each goal, empty if there is none
+   */
+  std::vector<nav_msgs::msg::Path> getPlans(
+    const geometry_msgs::msg::PoseStamped & start,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    const std::string & planner_id,
+    std::vector<double> & costs);
+
 protected:
   /**
    * @brief Configure member variables and initializes planner
@@ -106,6 +124,8 @@ protected:
   using ActionThroughPoses = nav2_msgs::action::ComputePathThroughPoses;
   using ActionServerToPose = nav2_util::SimpleActionServer<ActionToPose>;
   using ActionServerThroughPoses = nav2_util::SimpleActionServer<ActionThroughPoses>;
+  using ActionToPoses = nav2_msgs::action::ComputePathsToPoses;
+  using ActionServerToPoses = nav2_util::SimpleActionServer<ActionToPoses>;
 
   /**
    * @brief Check if an action server is valid / active
@@ -185,6 +205,7 @@ protected:
   // Our action server implements the ComputePathToPose action
   std::unique_ptr<ActionServerToPose> action_server_pose_;
   std::unique_ptr<ActionServerThroughPoses> action_server_poses_;
+  std::unique_ptr<ActionServerToPoses> action_server_to_poses_;
 
   /**
    * @brief The action server callback which calls planner to get the path
@@ -198,6 +219,44 @@ protected:
    */
   void computePlanThroughPoses();
 
+  /**
+   * @brief The action server callback which calls planner to get the paths
+   * ComputePathsToPoses
+   */
+  void computePlansToPoses();
+
+  /**
+   * @brief Race the portfolio's planners against each other on separate threads, using the
+   * first valid plan or, if a deadline is set, the shortest found before it. The others are
+   * canceled and left to return in the background, sitting out later races until they do.
+   * @param start starting pose
+   * @param goal goal request
+   * @return Path
+   */
+  nav_msgs::msg::Path getPortfolioPlan(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal);
+
+  /**
+   * @brief Check if a planner is still running from a previous portfolio race, clearing
+   * its cancellation if it has since returned. portfolio_mutex_ must be held.
+   * @param planner_id Planner to check
+   * @return bool If the planner is still running
+   */
+  bool isPortfolioRacerBusy(const std::string & planner_id);
+
+  /**
+   * @brief Wait for a planner still running from a previous portfolio race to return,
+   * so it is not called concurrently, and clear its cancellation
+   * @param planner_id Planner to wait for
+   */
+  void waitForPortfolioRacer(const std::string & planner_id);
+
+  /**
+   * @brief Wait for all planners still running from previous portfolio races to return
+   */
+  void waitForPortfolioRacers();
+
   /**
    * @brief Publish a path for visualization purposes
    * @param path Reference to Global Path
@@ -214,6 +273,17 @@ protected:
   double max_planner_duration_;
   std::string planner_ids_concat_;
 
+  // Portfolio of planners to race against each other
+  std::string portfolio_id_;
+  std::vector<std::string> portfolio_planners_;
+  double portfolio_deadline_;
+  std::unordered_map<std::string, std::shared_future<void>> portfolio_racers_;
+  std::mutex portfolio_mutex_;
+  std::mutex portfolio_statistics_mutex_;
+  nav2_msgs::msg::PlannerPortfolioStatistics portfolio_statistics_;
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::PlannerPortfolioStatistics>::SharedPtr
+    portfolio_statistics_publisher_;
+
   // Clock
   rclcpp::Clock steady_clock_{RCL_STEADY_TIME};
 
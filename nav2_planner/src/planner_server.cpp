@@ -13,13 +13,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <utility>
@@ -27,6 +30,7 @@
 #include "builtin_interfaces/msg/duration.hpp"
 #include "nav2_util/costmap.hpp"
 #include "nav2_util/node_utils.hpp"
+#include "nav2_util/geometry_utils.hpp"
 #include "nav2_costmap_2d/cost_values.hpp"
 
 #include "nav2_planner/planner_server.hpp"
@@ -48,6 +52,9 @@ PlannerServer::PlannerServer()
   // Declare this node's parameters
   declare_parameter("planner_plugins", default_ids_);
   declare_parameter("expected_planner_frequency", 1.0);
+  declare_parameter("portfolio_id", std::string("Portfolio"));
+  declare_parameter("portfolio_planners", std::vector<std::string>());
+  declare_parameter("portfolio_deadline", 0.0);
 
   get_parameter("planner_plugins", planner_ids_);
   if (planner_ids_ == default_ids_) {
@@ -115,6 +122,27 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & state)
     get_logger(),
     "Planner Server has %s planners available.", planner_ids_concat_.c_str());
 
+  // Planners raced against each other when the portfolio is requested
+  get_parameter("portfolio_id", portfolio_id_);
+  get_parameter("portfolio_planners", portfolio_planners_);
+  get_parameter("portfolio_deadline", portfolio_deadline_);
+  for (const auto & planner_id : portfolio_planners_) {
+    if (planners_.find(planner_id) == planners_.end()) {
+      RCLCPP_FATAL(
+        get_logger(), "Portfolio planner %s is not a valid planner. Planner names are: %s",
+        planner_id.c_str(), planner_ids_concat_.c_str());
+      return nav2_util::CallbackReturn::FAILURE;
+    }
+  }
+
+  portfolio_statistics_ = nav2_msgs::msg::PlannerPortfolioStatistics();
+  portfolio_statistics_.planner_ids = portfolio_planners_;
+  portfolio_statistics_.attempts.assign(portfolio_planners_.size(), 0);
+  portfolio_statistics_.successes.assign(portfolio_planners_.size(), 0);
+  portfolio_statistics_.wins.assign(portfolio_planners_.size(), 0);
+  portfolio_statistics_.last_latencies.assign(portfolio_planners_.size(), -1.0);
+  portfolio_statistics_.mean_latencies.assign(portfolio_planners_.size(), 0.0);
+
   double expected_planner_frequency;
   get_parameter("expected_planner_frequency", expected_planner_frequency);
   if (expected_planner_frequency > 0) {
@@ -129,6 +157,8 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & state)
 
   // Initialize pubs & subs
   plan_publisher_ = create_publisher<nav_msgs::msg::Path>("plan", 1);
+  portfolio_statistics_publisher_ =
+    create_publisher<nav2_msgs::msg::PlannerPortfolioStatistics>("portfolio_statistics", 1);
 
   // Create the action servers for path planning to a pose and through poses
   action_server_pose_ = std::make_unique<ActionServerToPose>(
@@ -141,6 +171,11 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & state)
     "compute_path_through_poses",
     std::bind(&PlannerServer::computePlanThroughPoses, this));
 
+  action_server_to_poses_ = std::make_unique<ActionServerToPoses>(
+    rclcpp_node_,
+    "compute_paths_to_poses",
+    std::bind(&PlannerServer::computePlansToPoses, this));
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -150,8 +185,10 @@ PlannerServer::on_activate(const rclcpp_lifecycle::State & state)
   RCLCPP_INFO(get_logger(), "Activating");
 
   plan_publisher_->on_activate();
+  portfolio_statistics_publisher_->on_activate();
   action_server_pose_->activate();
   action_server_poses_->activate();
+  action_server_to_poses_->activate();
   costmap_ros_->on_activate(state);
 
   PlannerMap::iterator it;
@@ -172,7 +209,9 @@ PlannerServer::on_deactivate(const rclcpp_lifecycle::State & state)
 
   action_server_pose_->deactivate();
   action_server_poses_->deactivate();
+  action_server_to_poses_->deactivate();
   plan_publisher_->on_deactivate();
+  portfolio_statistics_publisher_->on_deactivate();
   costmap_ros_->on_deactivate(state);
 
   PlannerMap::iterator it;
@@ -193,7 +232,10 @@ PlannerServer::on_cleanup(const rclcpp_lifecycle::State & state)
 
   action_server_pose_.reset();
   action_server_poses_.reset();
+  action_server_to_poses_.reset();
   plan_publisher_.reset();
+  portfolio_statistics_publisher_.reset();
+  waitForPortfolioRacers();
   tf_.reset();
   costmap_ros_->on_cleanup(state);
 
@@ -464,6 +506,81 @@ PlannerServer::computePlan()
   }
 }
 
+void
+PlannerServer::computePlansToPoses()
+{
+  auto start_time = steady_clock_.now();
+
+  // Initialize the ComputePathsToPoses goal and result
+  auto goal = action_server_to_poses_->get_current_goal();
+  auto result = std::make_shared<ActionToPoses::Result>();
+
+  try {
+    if (isServerInactive(action_server_to_poses_) || isCancelRequested(action_server_to_poses_)) {
+      return;
+    }
+
+    waitForCostmap();
+
+    getPreemptedGoalIfRequested(action_server_to_poses_, goal);
+
+    if (goal->goals.size() == 0) {
+      RCLCPP_WARN(
+        get_logger(),
+        "Compute paths to poses requested plans with no goal poses, returning.");
+      action_server_to_poses_->terminate_current();
+      return;
+    }
+
+    // Use start pose if provided otherwise use current robot pose
+    geometry_msgs::msg::PoseStamped start;
+    if (!getStartPose(action_server_to_poses_, goal, start)) {
+      return;
+    }
+
+    // Transform them into the global frame
+    std::vector<geometry_msgs::msg::PoseStamped> goal_poses = goal->goals;
+    for (auto & goal_pose : goal_poses) {
+      if (!transformPosesToGlobalFrame(action_server_to_poses_, start, goal_pose)) {
+        return;
+      }
+    }
+
+    // Get plans from start -> each goal
+    std::vector<double> costs;
+    result->paths = getPlans(start, goal_poses, goal->planner_id, costs);
+    result->costs.assign(costs.begin(), costs.end());
+
+    if (std::all_of(
+        result->paths.begin(), result->paths.end(),
+        [](const nav_msgs::msg::Path & path) {return path.poses.empty();}))
+    {
+      RCLCPP_WARN(
+        get_logger(), "Planning algorithm %s failed to generate a valid"
+        " path to any of %li goals", goal->planner_id.c_str(), goal_poses.size());
+      action_server_to_poses_->terminate_current();
+      return;
+    }
+
+    auto cycle_duration = steady_clock_.now() - start_time;
+    result->planning_time = cycle_duration;
+
+    if (max_planner_duration_ && cycle_duration.seconds() > max_planner_duration_) {
+      RCLCPP_WARN(
+        get_logger(),
+        "Planner loop missed its desired rate of %.4f Hz. Current loop rate is %.4f Hz",
+        1 / max_planner_duration_, 1 / cycle_duration.seconds());
+    }
+
+    action_server_to_poses_->succeeded_current(result);
+  } catch (std::exception & ex) {
+    RCLCPP_WARN(
+      get_logger(), "%s plugin failed to plan to %li goals: \"%s\"",
+      goal->planner_id.c_str(), goal->goals.size(), ex.what());
+    action_server_to_poses_->terminate_current();
+  }
+}
+
 nav_msgs::msg::Path
 PlannerServer::getPlan(
   const geometry_msgs::msg::PoseStamped & start,
@@ -475,7 +592,12 @@ PlannerServer::getPlan(
     "(%.2f, %.2f).", start.pose.position.x, start.pose.position.y,
     goal.pose.position.x, goal.pose.position.y);
 
+  if (!portfolio_planners_.empty() && planner_id == portfolio_id_) {
+    return getPortfolioPlan(start, goal);
+  }
+
   if (planners_.find(planner_id) != planners_.end()) {
+    waitForPortfolioRacer(planner_id);
     return planners_[planner_id]->createPlan(start, goal);
   } else {
     if (planners_.size() == 1 && planner_id.empty()) {
@@ -483,6 +605,7 @@ PlannerServer::getPlan(
         get_logger(), "No planners specified in action call. "
         "Server will use only plugin %s in server."
         " This warning will appear once.", planner_ids_concat_.c_str());
+      waitForPortfolioRacer(planners_.begin()->first);
       return planners_[planners_.begin()->first]->createPlan(start, goal);
     } else {
       RCLCPP_ERROR(
@@ -495,6 +618,248 @@ PlannerServer::getPlan(
   return nav_msgs::msg::Path();
 }
 
+std::vector<nav_msgs::msg::Path>
+PlannerServer::getPlans(
+  const geometry_msgs::msg::PoseStamped & start,
+  const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+  const std::string & planner_id,
+  std::vector<double> & costs)
+{
+  RCLCPP_DEBUG(
+    get_logger(), "Attempting to a find paths from (%.2f, %.2f) to "
+    "%li goals.", start.pose.position.x, start.pose.position.y, goals.size());
+
+  if (planners_.find(planner_id) != planners_.end()) {
+    waitForPortfolioRacer(planner_id);
+    return planners_[planner_id]->createPlans(start, goals, costs);
+  } else {
+    if (planners_.size() == 1 && planner_id.empty()) {
+      RCLCPP_WARN_ONCE(
+        get_logger(), "No planners specified in action call. "
+        "Server will use only plugin %s in server."
+        " This warning will appear once.", planner_ids_concat_.c_str());
+      waitForPortfolioRacer(planners_.begin()->first);
+      return planners_[planners_.begin()->first]->createPlans(start, goals, costs);
+    } else {
+      RCLCPP_ERROR(
+        get_logger(), "planner %s is not a valid planner. "
+        "Planner names are: %s", planner_id.c_str(),
+        planner_ids_concat_.c_str());
+    }
+  }
+
+  costs.assign(goals.size(), -1.0);
+  return std::vector<nav_msgs::msg::Path>(goals.size());
+}
+
+nav_msgs::msg::Path
+PlannerServer::getPortfolioPlan(
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal)
+{
+  // Shared with the racing threads, which may outlive this call if canceled
+  struct Race
+  {
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<bool> done;
+    std::vector<nav_msgs::msg::Path> paths;
+    std::vector<double> latencies;
+  };
+
+  const size_t num_planners = portfolio_planners_.size();
+  auto race = std::make_shared<Race>();
+  race->done.assign(num_planners, false);
+  race->paths.resize(num_planners);
+  race->latencies.assign(num_planners, -1.0);
+
+  // Planners still searching from a previous race sit this one out rather than be waited for,
+  // the others are claimed for this race so they are not called concurrently
+  std::vector<bool> racing(num_planners, false);
+  std::vector<std::shared_future<void>> racers(num_planners);
+  size_t num_racing = 0;
+  const auto start_time = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> racers_lock(portfolio_mutex_);
+    for (size_t i = 0; i != num_planners; i++) {
+      if (isPortfolioRacerBusy(portfolio_planners_[i])) {
+        RCLCPP_DEBUG(
+          get_logger(), "Portfolio planner %s is still running from a previous race, skipping it.",
+          portfolio_planners_[i].c_str());
+        continue;
+      }
+
+      racing[i] = true;
+      num_racing++;
+      racers[i] = std::async(
+        std::launch::async,
+        [race, planner = planners_[portfolio_planners_[i]], i, start, goal, start_time]() {
+          nav_msgs::msg::Path path;
+          try {
+            path = planner->createPlan(start, goal);
+          } catch (const std::exception &) {
+            path.poses.clear();
+          }
+
+          std::lock_guard<std::mutex> lock(race->mutex);
+          race->done[i] = true;
+          race->paths[i] = std::move(path);
+          race->latencies[i] = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_time).count();
+          race->finished.notify_all();
+        }).share();
+      portfolio_racers_[portfolio_planners_[i]] = racers[i];
+    }
+  }
+
+  if (num_racing == 0) {
+    RCLCPP_WARN(
+      get_logger(), "All portfolio planners are still running from previous races, "
+      "no plan could be computed.");
+    return nav_msgs::msg::Path();
+  }
+
+  // Wait for the first valid plan, or with a deadline, the shortest valid plan before it
+  const auto deadline = start_time + std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<double>(std::max(portfolio_deadline_, 0.0)));
+  int winner = -1;
+  std::unique_lock<std::mutex> lock(race->mutex);
+  while (true) {
+    size_t num_done = 0;
+    double best_length = std::numeric_limits<double>::max();
+    winner = -1;
+    for (size_t i = 0; i != num_planners; i++) {
+      if (!race->done[i]) {
+        continue;
+      }
+      num_done++;
+      if (!race->paths[i].poses.empty()) {
+        const double length = nav2_util::geometry_utils::calculate_path_length(race->paths[i]);
+        if (length < best_length) {
+          best_length = length;
+          winner = static_cast<int>(i);
+        }
+      }
+    }
+
+    const bool past_deadline = std::chrono::steady_clock::now() >= deadline;
+    if (num_done == num_racing || (winner >= 0 && past_deadline)) {
+      break;
+    }
+
+    if (past_deadline) {
+      race->finished.wait(lock);
+    } else {
+      race->finished.wait_until(lock, deadline);
+    }
+  }
+  const std::vector<bool> done = race->done;
+  lock.unlock();
+
+  // Cancel the planners still searching, their plans would not be used. Those which cannot
+  // be interrupted are left out of later races until they return. Finished racers only
+  // have their thread left to exit.
+  for (size_t i = 0; i != num_planners; i++) {
+    if (!racing[i]) {
+      continue;
+    }
+
+    if (done[i]) {
+      racers[i].wait();
+      std::lock_guard<std::mutex> racers_lock(portfolio_mutex_);
+      portfolio_racers_.erase(portfolio_planners_[i]);
+    } else {
+      planners_[portfolio_planners_[i]]->cancelPlanning(true);
+    }
+  }
+
+  // Races of the different action servers may finish at the same time
+  lock.lock();
+  std::lock_guard<std::mutex> statistics_lock(portfolio_statistics_mutex_);
+  for (size_t i = 0; i != num_planners; i++) {
+    if (!racing[i]) {
+      continue;
+    }
+
+    const bool success = done[i] && !race->paths[i].poses.empty();
+    portfolio_statistics_.attempts[i]++;
+    portfolio_statistics_.last_latencies[i] = success ? race->latencies[i] : -1.0;
+    if (success) {
+      portfolio_statistics_.successes[i]++;
+      portfolio_statistics_.mean_latencies[i] +=
+        (race->latencies[i] - portfolio_statistics_.mean_latencies[i]) /
+        portfolio_statistics_.successes[i];
+    }
+  }
+
+  portfolio_statistics_.last_winner = "";
+  if (winner >= 0) {
+    portfolio_statistics_.wins[winner]++;
+    portfolio_statistics_.last_winner = portfolio_planners_[winner];
+    RCLCPP_DEBUG(
+      get_logger(), "Portfolio planner %s won in %.4f s.",
+      portfolio_planners_[winner].c_str(), race->latencies[winner]);
+  }
+
+  portfolio_statistics_.header.stamp = now();
+  if (portfolio_statistics_publisher_ && portfolio_statistics_publisher_->is_activated()) {
+    portfolio_statistics_publisher_->publish(portfolio_statistics_);
+  }
+
+  return winner >= 0 ? race->paths[winner] : nav_msgs::msg::Path();
+}
+
+bool
+PlannerServer::isPortfolioRacerBusy(const std::string & planner_id)
+{
+  auto racer = portfolio_racers_.find(planner_id);
+  if (racer == portfolio_racers_.end()) {
+    return false;
+  }
+
+  if (racer->second.wait_for(0s) != std::future_status::ready) {
+    return true;
+  }
+
+  planners_[planner_id]->cancelPlanning(false);
+  portfolio_racers_.erase(racer);
+  return false;
+}
+
+void
+PlannerServer::waitForPortfolioRacer(const std::string & planner_id)
+{
+  std::shared_future<void> racer;
+  {
+    std::lock_guard<std::mutex> lock(portfolio_mutex_);
+    auto it = portfolio_racers_.find(planner_id);
+    if (it == portfolio_racers_.end()) {
+      return;
+    }
+    racer = it->second;
+  }
+
+  // Only requests for this planner wait on it, without holding up other races
+  RCLCPP_DEBUG(
+    get_logger(), "Waiting for planner %s to return from a portfolio race.",
+    planner_id.c_str());
+  racer.wait();
+
+  std::lock_guard<std::mutex> lock(portfolio_mutex_);
+  isPortfolioRacerBusy(planner_id);
+}
+
+void
+PlannerServer::waitForPortfolioRacers()
+{
+  std::lock_guard<std::mutex> lock(portfolio_mutex_);
+  for (auto & racer : portfolio_racers_) {
+    racer.second.wait();
+    planners_[racer.first]->cancelPlanning(false);
+  }
+  portfolio_racers_.clear();
+}
+
 void
 PlannerServer::publishPlan(const nav_msgs::msg::Path & path)
 {
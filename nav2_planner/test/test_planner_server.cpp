@@ -0,0 +1,377 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "geometry_msgs/msg/transform_stamped.hpp"
+#include "nav2_msgs/action/compute_paths_to_poses.hpp"
+#include "nav2_core/global_planner.hpp"
+#include "nav2_planner/planner_server.hpp"
+
+using namespace std::chrono_literals;
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+// A planner taking a fixed time to return a path detouring by a fixed length, or none to
+// goals behind the start, which ignores cancellation like planners not overriding
+// cancelPlanning()
+class FakePlanner : public nav2_core::GlobalPlanner
+{
+public:
+  FakePlanner(const std::chrono::milliseconds & duration, const double & detour)
+  : duration_(duration), detour_(detour) {}
+
+  void configure(
+    const rclcpp_lifecycle::LifecycleNode::WeakPtr &,
+    std::string, std::shared_ptr<tf2_ros::Buffer>,
+    std::shared_ptr<nav2_costmap_2d::Costmap2DROS>) override {}
+  void cleanup() override {}
+  void activate() override {}
+  void deactivate() override {}
+
+  nav_msgs::msg::Path createPlan(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal) override
+  {
+    calls++;
+    const auto end_time = std::chrono::steady_clock::now() + duration_;
+    while (std::chrono::steady_clock::now() < end_time) {
+      if (isCanceled()) {
+        return nav_msgs::msg::Path();
+      }
+      std::this_thread::sleep_for(1ms);
+    }
+
+    nav_msgs::msg::Path path;
+    if (goal.pose.position.x < start.pose.position.x) {
+      return path;
+    }
+
+    path.poses.push_back(start);
+    geometry_msgs::msg::PoseStamped detour = start;
+    detour.pose.position.y += detour_ / 2.0;
+    path.poses.push_back(detour);
+    path.poses.push_back(start);
+    path.poses.push_back(goal);
+    return path;
+  }
+
+  std::atomic<int> calls{0};
+
+protected:
+  virtual bool isCanceled() {return false;}
+
+  std::chrono::milliseconds duration_;
+  double detour_;
+};
+
+// A planner which returns early without a plan when canceled
+class CancelableFakePlanner : public FakePlanner
+{
+public:
+  using FakePlanner::FakePlanner;
+
+  void cancelPlanning(const bool & cancel) override
+  {
+    canceled = cancel;
+    if (cancel) {
+      cancel_requests++;
+    }
+  }
+
+  std::atomic<bool> canceled{false};
+  std::atomic<int> cancel_requests{0};
+
+protected:
+  bool isCanceled() override {return canceled;}
+};
+
+class PlannerServerWrapper : public nav2_planner::PlannerServer
+{
+public:
+  void setPortfolio(
+    const PlannerMap & planners, const std::vector<std::string> & portfolio,
+    const double & deadline)
+  {
+    planners_ = planners;
+    portfolio_id_ = "Portfolio";
+    portfolio_planners_ = portfolio;
+    portfolio_deadline_ = deadline;
+    portfolio_statistics_ = nav2_msgs::msg::PlannerPortfolioStatistics();
+    portfolio_statistics_.planner_ids = portfolio;
+    portfolio_statistics_.attempts.assign(portfolio.size(), 0);
+    portfolio_statistics_.successes.assign(portfolio.size(), 0);
+    portfolio_statistics_.wins.assign(portfolio.size(), 0);
+    portfolio_statistics_.last_latencies.assign(portfolio.size(), -1.0);
+    portfolio_statistics_.mean_latencies.assign(portfolio.size(), 0.0);
+  }
+
+  const nav2_msgs::msg::PlannerPortfolioStatistics & getStatistics()
+  {
+    return portfolio_statistics_;
+  }
+
+  bool isBusy(const std::string & planner_id)
+  {
+    std::lock_guard<std::mutex> lock(portfolio_mutex_);
+    return isPortfolioRacerBusy(planner_id);
+  }
+
+  void waitForRacers()
+  {
+    waitForPortfolioRacers();
+  }
+
+  // Bring the server up with the given planners rather than plugins, on a costmap
+  // without layers and with the robot at the origin of the map
+  void activateWithPlanners(const PlannerMap & planners)
+  {
+    planner_ids_.clear();
+    costmap_ros_->set_parameter(rclcpp::Parameter("plugins", std::vector<std::string>()));
+    rclcpp_lifecycle::State state;
+    ASSERT_EQ(on_configure(state), nav2_util::CallbackReturn::SUCCESS);
+    planners_ = planners;
+
+    geometry_msgs::msg::TransformStamped transform;
+    transform.header.frame_id = "map";
+    transform.child_frame_id = "base_link";
+    transform.transform.rotation.w = 1.0;
+    tf_->setTransform(transform, "test_planner_server", true);
+    ASSERT_EQ(on_activate(state), nav2_util::CallbackReturn::SUCCESS);
+  }
+
+  void deactivateAndCleanup()
+  {
+    rclcpp_lifecycle::State state;
+    on_deactivate(state);
+    on_cleanup(state);
+  }
+};
+
+geometry_msgs::msg::PoseStamped makePose(const double & x, const double & y)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header.frame_id = "map";
+  pose.pose.position.x = x;
+  pose.pose.position.y = y;
+  pose.pose.orientation.w = 1.0;
+  return pose;
+}
+
+double elapsedSince(const std::chrono::steady_clock::time_point & start_time)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+TEST(PlannerServerTest, test_portfolio_race)
+{
+  auto server = std::make_shared<PlannerServerWrapper>();
+  auto fast = std::make_shared<FakePlanner>(10ms, 2.0);
+  auto slow = std::make_shared<FakePlanner>(1500ms, 0.0);
+  server->setPortfolio({{"Fast", fast}, {"Slow", slow}}, {"Fast", "Slow"}, 0.0);
+
+  auto start = makePose(0.0, 0.0);
+  auto goal = makePose(1.0, 0.0);
+
+  // The first valid plan wins without waiting for the slow, uncancelable planner
+  auto start_time = std::chrono::steady_clock::now();
+  auto path = server->getPlan(start, goal, "Portfolio");
+  EXPECT_LT(elapsedSince(start_time), 1.0);
+  ASSERT_EQ(path.poses.size(), 4u);
+  EXPECT_NEAR(nav2_util::geometry_utils::calculate_path_length(path), 3.0, 1e-6);
+  EXPECT_TRUE(server->isBusy("Slow"));
+  EXPECT_FALSE(server->isBusy("Fast"));
+
+  auto stats = server->getStatistics();
+  EXPECT_EQ(stats.last_winner, "Fast");
+  EXPECT_EQ(stats.attempts, std::vector<uint32_t>({1, 1}));
+  EXPECT_EQ(stats.successes, std::vector<uint32_t>({1, 0}));
+  EXPECT_EQ(stats.wins, std::vector<uint32_t>({1, 0}));
+  EXPECT_GT(stats.last_latencies[0], 0.0);
+  EXPECT_EQ(stats.last_latencies[1], -1.0);
+  EXPECT_NEAR(stats.mean_latencies[0], stats.last_latencies[0], 1e-9);
+
+  // The next race neither waits on the still running loser nor calls it concurrently
+  start_time = std::chrono::steady_clock::now();
+  path = server->getPlan(start, goal, "Portfolio");
+  EXPECT_LT(elapsedSince(start_time), 1.0);
+  EXPECT_EQ(path.poses.size(), 4u);
+  EXPECT_EQ(slow->calls, 1);
+  EXPECT_EQ(fast->calls, 2);
+
+  stats = server->getStatistics();
+  EXPECT_EQ(stats.attempts, std::vector<uint32_t>({2, 1}));
+  EXPECT_EQ(stats.wins, std::vector<uint32_t>({2, 0}));
+
+  // A request naming the loser directly waits for it, rather than calling it concurrently
+  path = server->getPlan(start, goal, "Slow");
+  EXPECT_FALSE(server->isBusy("Slow"));
+  EXPECT_EQ(slow->calls, 2);
+  EXPECT_NEAR(nav2_util::geometry_utils::calculate_path_length(path), 1.0, 1e-6);
+
+  // Once it returned, the loser races again
+  server->getPlan(start, goal, "Portfolio");
+  EXPECT_EQ(slow->calls, 3);
+  EXPECT_EQ(server->getStatistics().attempts, std::vector<uint32_t>({3, 2}));
+
+  server->waitForRacers();
+}
+
+TEST(PlannerServerTest, test_portfolio_deadline)
+{
+  auto server = std::make_shared<PlannerServerWrapper>();
+  auto fast = std::make_shared<FakePlanner>(10ms, 2.0);
+  auto shorter = std::make_shared<FakePlanner>(100ms, 0.0);
+  auto slow = std::make_shared<CancelableFakePlanner>(5000ms, 0.0);
+  server->setPortfolio(
+    {{"Fast", fast}, {"Shorter", shorter}, {"Slow", slow}}, {"Fast", "Shorter", "Slow"}, 0.5);
+
+  auto start = makePose(0.0, 0.0);
+  auto goal = makePose(1.0, 0.0);
+
+  // The shortest plan found before the deadline wins, and the planner still searching is
+  // canceled, returning well before it would have finished
+  auto start_time = std::chrono::steady_clock::now();
+  auto path = server->getPlan(start, goal, "Portfolio");
+  const double duration = elapsedSince(start_time);
+  EXPECT_GE(duration, 0.5);
+  EXPECT_LT(duration, 2.0);
+  EXPECT_NEAR(nav2_util::geometry_utils::calculate_path_length(path), 1.0, 1e-6);
+  EXPECT_EQ(slow->cancel_requests, 1);
+
+  auto stats = server->getStatistics();
+  EXPECT_EQ(stats.last_winner, "Shorter");
+  EXPECT_EQ(stats.successes, std::vector<uint32_t>({1, 1, 0}));
+  EXPECT_EQ(stats.wins, std::vector<uint32_t>({0, 1, 0}));
+  EXPECT_LT(stats.last_latencies[0], stats.last_latencies[1]);
+  EXPECT_EQ(stats.last_latencies[2], -1.0);
+
+  // The canceled planner's cancellation is cleared once it returned, before it races again
+  while (server->isBusy("Slow")) {
+    std::this_thread::sleep_for(10ms);
+  }
+  EXPECT_FALSE(slow->canceled);
+  server->getPlan(start, goal, "Portfolio");
+  EXPECT_EQ(slow->calls, 2);
+  EXPECT_EQ(slow->cancel_requests, 2);
+
+  server->waitForRacers();
+  EXPECT_FALSE(slow->canceled);
+}
+
+TEST(PlannerServerTest, test_portfolio_single_planner)
+{
+  auto server = std::make_shared<PlannerServerWrapper>();
+  auto slow = std::make_shared<FakePlanner>(300ms, 0.0);
+  server->setPortfolio({{"Slow", slow}}, {"Slow"}, 0.0);
+
+  auto start = makePose(0.0, 0.0);
+  auto goal = makePose(1.0, 0.0);
+
+  // With a single planner, the race waits for it
+  auto path = server->getPlan(start, goal, "Portfolio");
+  EXPECT_EQ(path.poses.size(), 4u);
+  EXPECT_FALSE(server->isBusy("Slow"));
+  EXPECT_EQ(server->getStatistics().last_winner, "Slow");
+  server->waitForRacers();
+}
+
+TEST(PlannerServerTest, test_compute_paths_to_poses)
+{
+  using ComputePathsToPoses = nav2_msgs::action::ComputePathsToPoses;
+  using GoalHandle = rclcpp_action::ClientGoalHandle<ComputePathsToPoses>;
+
+  auto server = std::make_shared<PlannerServerWrapper>();
+  auto planner = std::make_shared<FakePlanner>(10ms, 2.0);
+  server->activateWithPlanners({{"Fake", planner}});
+
+  auto client_node = rclcpp::Node::make_shared("compute_paths_to_poses_client");
+  auto client = rclcpp_action::create_client<ComputePathsToPoses>(
+    client_node, "compute_paths_to_poses");
+  ASSERT_TRUE(client->wait_for_action_server(5s));
+
+  auto sendGoal =
+    [&](const ComputePathsToPoses::Goal & goal) -> GoalHandle::WrappedResult
+    {
+      auto goal_handle_future = client->async_send_goal(goal);
+      EXPECT_EQ(
+        rclcpp::spin_until_future_complete(client_node, goal_handle_future, 5s),
+        rclcpp::FutureReturnCode::SUCCESS);
+      auto goal_handle = goal_handle_future.get();
+      EXPECT_NE(goal_handle, nullptr);
+      if (!goal_handle) {
+        return GoalHandle::WrappedResult();
+      }
+      auto result_future = client->async_get_result(goal_handle);
+      EXPECT_EQ(
+        rclcpp::spin_until_future_complete(client_node, result_future, 5s),
+        rclcpp::FutureReturnCode::SUCCESS);
+      return result_future.get();
+    };
+
+  // A path and cost for each goal, in order, with none to those unreachable
+  ComputePathsToPoses::Goal goal;
+  goal.start = makePose(0.0, 0.0);
+  goal.use_start = true;
+  goal.planner_id = "Fake";
+  goal.goals = {makePose(1.0, 0.0), makePose(-1.0, 0.0), makePose(0.0, 2.0)};
+  auto result = sendGoal(goal);
+  ASSERT_EQ(result.code, rclcpp_action::ResultCode::SUCCEEDED);
+  ASSERT_EQ(result.result->paths.size(), 3u);
+  ASSERT_EQ(result.result->costs.size(), 3u);
+  for (unsigned int i = 0; i != 3; i++) {
+    if (i == 1) {
+      EXPECT_TRUE(result.result->paths[i].poses.empty());
+      EXPECT_EQ(result.result->costs[i], -1.0f);
+      continue;
+    }
+
+    ASSERT_FALSE(result.result->paths[i].poses.empty());
+    const auto & end = result.result->paths[i].poses.back().pose.position;
+    EXPECT_EQ(end.x, goal.goals[i].pose.position.x);
+    EXPECT_EQ(end.y, goal.goals[i].pose.position.y);
+    EXPECT_NEAR(
+      result.result->costs[i],
+      nav2_util::geometry_utils::calculate_path_length(result.result->paths[i]), 1e-5);
+  }
+  EXPECT_NEAR(result.result->costs[0], 3.0, 1e-5);
+  EXPECT_NEAR(result.result->costs[2], 4.0, 1e-5);
+  EXPECT_EQ(planner->calls, 3);
+
+  // Aborted if no goal can be reached, none are given or the planner does not exist
+  goal.goals = {makePose(-1.0, 0.0), makePose(-2.0, 1.0)};
+  EXPECT_EQ(sendGoal(goal).code, rclcpp_action::ResultCode::ABORTED);
+  goal.goals.clear();
+  EXPECT_EQ(sendGoal(goal).code, rclcpp_action::ResultCode::ABORTED);
+  goal.goals = {makePose(1.0, 0.0)};
+  goal.planner_id = "Missing";
+  EXPECT_EQ(sendGoal(goal).code, rclcpp_action::ResultCode::ABORTED);
+
+  server->deactivateAndCleanup();
+}
@@ -223,7 +223,8 @@ protected:
   std::shared_ptr<tf2_ros::Buffer> tf_;
   std::string plugin_name_;
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
-  nav2_costmap_2d::Costmap2D * costmap_;
+  // Snapshot of the costmap for the current cycle, read without locking it
+  std::shared_ptr<const nav2_costmap_2d::Costmap2D> costmap_;
   rclcpp::Logger logger_ {rclcpp::get_logger("RegulatedPurePursuitController")};
 
   double desired_linear_vel_, base_desired_linear_vel_;
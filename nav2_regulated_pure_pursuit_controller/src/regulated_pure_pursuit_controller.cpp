@@ -46,7 +46,8 @@ void RegulatedPurePursuitController::configure(
   }
 
   costmap_ros_ = costmap_ros;
-  costmap_ = costmap_ros_->getCostmap();
+  // Replaced every cycle, but set here so no helper is left without a costmap before the first
+  costmap_ = costmap_ros_->getCostmapSnapshot();
   tf_ = tf;
   plugin_name_ = name;
   logger_ = node->get_logger();
@@ -175,6 +176,7 @@ void RegulatedPurePursuitController::cleanup()
   global_path_pub_.reset();
   carrot_pub_.reset();
   carrot_arc_pub_.reset();
+  costmap_.reset();
 }
 
 void RegulatedPurePursuitController::activate()
@@ -230,6 +232,9 @@ geometry_msgs::msg::TwistStamped RegulatedPurePursuitController::computeVelocity
   const geometry_msgs::msg::Twist & speed,
   nav2_core::GoalChecker * goal_checker)
 {
+  // A consistent costmap for the whole cycle, as the costmap keeps updating meanwhile
+  costmap_ = costmap_ros_->getCostmapSnapshot();
+
   // Update for the current goal checker's state
   geometry_msgs::msg::Pose pose_tolerance;
   geometry_msgs::msg::Twist vel_tolerance;
@@ -518,9 +523,9 @@ nav_msgs::msg::Path RegulatedPurePursuitController::transformGlobalPlan(
   }
 
   // We'll discard points on the plan that are outside the local costmap
-  nav2_costmap_2d::Costmap2D * costmap = costmap_ros_->getCostmap();
-  const double max_costmap_dim = std::max(costmap->getSizeInCellsX(), costmap->getSizeInCellsY());
-  const double max_transform_dist = max_costmap_dim * costmap->getResolution() / 2.0;
+  const double max_costmap_dim =
+    std::max(costmap_->getSizeInCellsX(), costmap_->getSizeInCellsY());
+  const double max_transform_dist = max_costmap_dim * costmap_->getResolution() / 2.0;
 
   // First find the closest pose on the path to the robot
   auto transformation_begin =
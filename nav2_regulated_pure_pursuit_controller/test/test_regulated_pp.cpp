@@ -348,3 +348,35 @@ TEST(RegulatedPurePursuitTest, applyConstraints)
   //   dist_error, lookahead_dist, curvature, curr_speed, pose_cost, linear_vel);
   // EXPECT_NEAR(linear_vel, 0.5, 0.01);
 }
+
+TEST(RegulatedPurePursuitTest, applyConstraintsBeforeFirstCycle)
+{
+  auto ctrl = std::make_shared<BasicAPIRPP>();
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testRPP");
+  std::string name = "PathFollower";
+  auto tf = std::make_shared<tf2_ros::Buffer>(node->get_clock());
+  auto costmap = std::make_shared<nav2_costmap_2d::Costmap2DROS>("fake_costmap");
+  costmap->on_configure(rclcpp_lifecycle::State());
+  ctrl->configure(node, name, tf, costmap);
+  ctrl->activate();
+
+  // Approach scaling reads the costmap, which is available before computing a command
+  double lookahead_dist = 0.6;
+  double curvature = 0.0;
+  geometry_msgs::msg::Twist curr_speed;
+  curr_speed.linear.x = 0.25;
+  double pose_cost = 0.0;
+  double linear_vel = 0.5;
+  ctrl->applyConstraintsWrapper(
+    0.0, lookahead_dist, curvature, curr_speed, pose_cost, linear_vel);
+  EXPECT_NEAR(linear_vel, 0.375, 0.01);  // max by acceleration
+
+  linear_vel = 0.5;
+  ctrl->applyConstraintsWrapper(
+    0.4, lookahead_dist, curvature, curr_speed, pose_cost, linear_vel);
+  EXPECT_NEAR(linear_vel, 0.5 / 3.0, 0.01);  // lower by approach
+
+  ctrl->deactivate();
+  ctrl->cleanup();
+  costmap->on_cleanup(rclcpp_lifecycle::State());
+}
@@ -17,6 +17,8 @@
 #define NAV2_SMAC_PLANNER__A_STAR_HPP_
 
 #include <vector>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <unordered_map>
 #include <memory>
@@ -29,6 +31,8 @@
 #include "nav2_smac_planner/node_2d.hpp"
 #include "nav2_smac_planner/node_se2.hpp"
 #include "nav2_smac_planner/node_basic.hpp"
+#include "nav2_smac_planner/node_pool.hpp"
+#include "nav2_smac_planner/indexed_heap.hpp"
 #include "nav2_smac_planner/types.hpp"
 #include "nav2_smac_planner/constants.hpp"
 
@@ -93,11 +97,51 @@ public:
    * @param max_on_approach_iterations Maximum number of iterations before returning a valid
    * path once within thresholds to refine path
    * comes at more compute time but smoother paths.
+   * @param use_node_pool Whether to store the graph in a dense, paged node pool indexed
+   * by node index rather than a hash map. Faster, at the cost of memory on large maps.
+   * @param use_indexed_heap Whether to use an indexed heap open set with decrease-key
+   * rather than a priority queue that re-queues nodes each time their cost improves.
    */
   void initialize(
     const bool & allow_unknown,
     int & max_iterations,
-    const int & max_on_approach_iterations);
+    const int & max_on_approach_iterations,
+    const bool & use_node_pool,
+    const bool & use_indexed_heap);
+
+  /**
+   * @brief Set the search algorithm to use when creating paths
+   * @param search_mode A* (default), anytime, or bidirectional (Node2D only)
+   * @param anytime_initial_weight Heuristic weight of the first anytime search, must be >= 1
+   * @param anytime_weight_decrement Heuristic weight reduction of each following anytime
+   * search, until it reaches 1. If not positive, the second search is unweighted
+   * @param anytime_max_time Maximum time in seconds to spend improving an anytime path
+   * after the first is found
+   */
+  void setSearchMode(
+    const SearchMode & search_mode,
+    const float & anytime_initial_weight,
+    const float & anytime_weight_decrement,
+    const double & anytime_max_time);
+
+  /**
+   * @brief Set limits on the wall-clock time of each call to createPath. The search checks
+   * them periodically, returning the path to the node closest to the goal found so far once
+   * out of time, or failing once canceled.
+   * @param max_planning_time Maximum time in seconds to search for, <= 0 for no limit
+   * @param cancel_requested Flag to stop an ongoing search from another thread, may be null
+   */
+  void setPlanningLimits(
+    const double & max_planning_time,
+    std::shared_ptr<std::atomic<bool>> cancel_requested);
+
+  /**
+   * @brief Restrict the search to a corridor of the graph, such as around a path planned
+   * at a coarser resolution. Reset when the graph is created.
+   * @param corridor Whether each cell of the X-Y grid may be searched, in row-major order.
+   * If empty, the whole grid is searched.
+   */
+  void setSearchCorridor(const std::vector<bool> & corridor);
 
   /**
    * @brief Creating path from given costmap, start, and goal
@@ -108,6 +152,38 @@ public:
    */
   bool createPath(CoordinateVector & path, int & num_iterations, const float & tolerance);
 
+  /**
+   * @brief Create paths from the start to each of many goals with a single Dijkstra search,
+   * expanding in order of cost until all goals are reached or a limit is hit. Only supported
+   * by Node2D, requires the start but not a goal be set.
+   * @param goals Coordinates of the goals
+   * @param paths Paths to set, one per goal ordered from the goal like createPath's,
+   * empty if the goal was not reached
+   * @param costs Accumulated costs of the paths to set, one per goal, -1 if not reached
+   * @param num_iterations Reference to number of iterations to create plans
+   * @return if any goal was reached
+   */
+  bool createPathsToGoals(
+    const CoordinateVector & goals,
+    std::vector<CoordinateVector> & paths,
+    std::vector<float> & costs,
+    int & num_iterations);
+
+  /**
+   * @brief Reuse a previously created path to the goal, if the rest of it from near the start
+   * is still valid on the graph's costmap, reconnecting the start to it along the motion
+   * model's shortest curve. Only supported by NodeSE2, does not require start and goal be set.
+   * @param start Coordinates of the start
+   * @param previous_path Path previously created, ordered from the goal like createPath's
+   * @param max_deviation Maximum distance in nodes of the start from the previous path
+   * @param path Reference to a vector of indicies of repaired path, from the goal to the pose
+   * after the start, which is not included, like createPath's
+   * @return if the previous path could be reused
+   */
+  bool repairPath(
+    const Coordinates & start, const CoordinateVector & previous_path,
+    const float & max_deviation, CoordinateVector & path);
+
   /**
    * @brief Create the graph based on the node type. For 2D nodes, a cost grid.
    *   For 3D nodes, a SE2 grid without cost info as needs collision detector for footprint.
@@ -197,6 +273,18 @@ public:
    */
   float & getToleranceHeuristic();
 
+  /**
+   * @brief Get the maximum number of entries in the open set during the last search
+   * @return Peak open set size
+   */
+  size_t getPeakQueueSize();
+
+  /**
+   * @brief Get whether the last path created ends short of the goal, as planning time ran out
+   * @return If path is partial
+   */
+  bool isPathPartial();
+
   /**
    * @brief Get size of graph in X
    * @return Size in X
@@ -216,6 +304,60 @@ public:
   unsigned int & getSizeDim3();
 
 protected:
+  /**
+   * @brief Expand the open set until the goal is found or a limit is reached
+   * @param path Reference to a vector of indicies of generated path
+   * @param iterations Reference to number of iterations, accumulated across searches
+   * @param path_cost Reference to the accumulated cost of the last node of the path found
+   * @return if a path was found
+   */
+  bool search(CoordinateVector & path, int & iterations, float & path_cost);
+
+  /**
+   * @brief Repeat the search with decreasing heuristic weights while time remains,
+   * reusing the costs found by the prior searches, keeping the cheapest path found
+   * @param path Reference to the path found by the first search, to be improved
+   * @param path_cost Reference to the cost of the path, updated with it
+   * @param iterations Reference to number of iterations, accumulated across searches
+   */
+  void improvePath(CoordinateVector & path, float & path_cost, int & iterations);
+
+  /**
+   * @brief Search from both the start and goal until the searches meet
+   * @param path Reference to a vector of indicies of generated path
+   * @param iterations Reference to number of iterations, across both searches
+   * @return if a path was found
+   */
+  bool createPathBidirectional(CoordinateVector & path, int & iterations);
+
+  /**
+   * @brief Check if the search must stop, as out of time or canceled. Checking the clock is
+   * relatively expensive, so only does so every few iterations
+   * @param iterations Number of iterations so far
+   * @return if search must stop
+   */
+  inline bool isSearchInterrupted(const int & iterations);
+
+  /**
+   * @brief Check if a node is within the search corridor, if any
+   * @param index Node index to check
+   * @return if node may be searched
+   */
+  inline bool isInSearchCorridor(const unsigned int & index);
+
+  /**
+   * @brief Check if planning was canceled
+   * @return if canceled
+   */
+  inline bool isCanceled();
+
+  /**
+   * @brief Backtrace the path to the node closest to the goal, if planning time has run out
+   * @param path Reference to a vector of indicies of generated path
+   * @return if a partial path was found
+   */
+  bool getPartialPath(CoordinateVector & path);
+
   /**
    * @brief Get pointer to next goal in open set
    * @return Node pointer reference to next heuristically scored node
@@ -229,6 +371,37 @@ protected:
    */
   inline void addNode(const float cost, NodePtr & node);
 
+  /**
+   * @brief Push node onto the open set in use
+   * @param cost The cost to sort into the open set of the node
+   * @param node Node to add to open set
+   */
+  inline void pushToQueue(const float & cost, const NodeBasic<NodeT> & node);
+
+  /**
+   * @brief Remove and return the lowest cost node of the open set in use
+   * @return Lowest cost node
+   */
+  inline NodeBasic<NodeT> popFromQueue();
+
+  /**
+   * @brief Check if open set in use is empty
+   * @return Whether empty
+   */
+  inline bool isQueueEmpty();
+
+  /**
+   * @brief Get number of entries in the open set in use
+   * @return Open set size
+   */
+  inline size_t getQueueSize();
+
+  /**
+   * @brief Get the lowest cost of the open set in use, which must not be empty
+   * @return Lowest cost in open set
+   */
+  inline float getQueueTopCost();
+
   /**
    * @brief Adds node to graph
    * @param cost The cost to sort into the open set of the node
@@ -236,6 +409,13 @@ protected:
    */
   inline NodePtr addToGraph(const unsigned int & index);
 
+  /**
+   * @brief Get node previously added to graph
+   * @param index Node index to get
+   * @return Node pointer to node in graph
+   */
+  inline NodePtr getFromGraph(const unsigned int & index);
+
   /**
    * @brief Check if this node is the goal node
    * @param node Node pointer to check if its the goal node
@@ -305,12 +485,35 @@ protected:
   NodePtr _goal;
 
   Graph _graph;
+  NodePool<NodeT> _node_pool;
+  bool _use_node_pool;
   NodeQueue _queue;
+  IndexedHeap<NodeT> _indexed_queue;
+  bool _use_indexed_heap;
+  size_t _peak_queue_size;
+
+  SearchMode _search_mode;
+  float _heuristic_weight;
+  float _anytime_initial_weight;
+  float _anytime_weight_decrement;
+  double _anytime_max_time;
+  NodeVector _reached_nodes;
+  Graph _backward_graph;
+  std::vector<std::pair<unsigned int, unsigned int>> _goal_indices;
+  std::vector<float> _repair_lengths;
+  std::vector<std::pair<float, unsigned int>> _repair_candidates;
+  std::chrono::steady_clock::time_point _deadline;
+  std::chrono::steady_clock::time_point _planning_deadline;
+  double _max_planning_time;
+  std::shared_ptr<std::atomic<bool>> _cancel_requested;
+  bool _is_path_partial;
+  std::vector<bool> _search_corridor;
 
   MotionModel _motion_model;
   NodeHeuristicPair _best_heuristic_node;
 
   GridCollisionChecker _collision_checker;
+  typename NodeT::ExpansionScratch _expansion_scratch;
   nav2_costmap_2d::Footprint _footprint;
   bool _is_radius_footprint;
   nav2_costmap_2d::Costmap2D * _costmap;
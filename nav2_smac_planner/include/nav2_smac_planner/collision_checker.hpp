@@ -12,8 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_smac_planner/constants.hpp"
+#include "nav2_util/line_iterator.hpp"
 
 #ifndef NAV2_SMAC_PLANNER__COLLISION_CHECKER_HPP_
 #define NAV2_SMAC_PLANNER__COLLISION_CHECKER_HPP_
@@ -32,10 +40,16 @@ public:
   /**
    * @brief A constructor for nav2_smac_planner::GridCollisionChecker
    * @param costmap The costmap to collision check against
+   * @param num_quantizations The number of angle bins of the search, used to precompute
+   * footprint cell masks per bin. If 0, footprints are always rasterized at the pose.
+   * Masks are only exact for poses on a cell and an angle bin, other poses are rasterized.
    */
   GridCollisionChecker(
-    nav2_costmap_2d::Costmap2D * costmap)
-  : FootprintCollisionChecker(costmap)
+    nav2_costmap_2d::Costmap2D * costmap,
+    const unsigned int & num_quantizations = 0)
+  : FootprintCollisionChecker(costmap),
+    num_quantizations_(num_quantizations),
+    bin_size_(0.0)
   {
   }
 
@@ -48,6 +62,11 @@ public:
   {
     unoriented_footprint_ = footprint;
     footprint_is_radius_ = radius;
+    footprint_masks_.reset();
+
+    if (!radius && !footprint.empty() && num_quantizations_ > 0 && costmap_) {
+      precomputeFootprintMasks();
+    }
   }
 
   /**
@@ -88,7 +107,18 @@ public:
         return true;
       }
 
-      // if possible inscribed, need to check actual footprint pose
+      // if possible inscribed, need to check actual footprint pose. If on a cell and in an
+      // angle bin, check the cells of the precomputed footprint for that bin instead. Masks
+      // are rasterized at the cell, so a sub-cell offset may cover other cells
+      if (footprint_masks_ && x == std::floor(x) && y == std::floor(y)) {
+        const double bin = static_cast<double>(theta) / bin_size_;
+        const double nearest_bin = std::round(bin);
+        if (fabs(bin - nearest_bin) < 1e-3) {
+          unsigned int bin_idx = static_cast<unsigned int>(nearest_bin) % num_quantizations_;
+          return maskInCollision(x, y, (*footprint_masks_)[bin_idx], traverse_unknown);
+        }
+      }
+
       footprint_cost_ = footprintCostAtPose(
         wx, wy, static_cast<double>(theta), unoriented_footprint_);
       if (footprint_cost_ == UNKNOWN && traverse_unknown) {
@@ -122,9 +152,123 @@ public:
   }
 
 protected:
+  /**
+   * @struct nav2_smac_planner::GridCollisionChecker::FootprintMask
+   * @brief Footprint outline cells at an orientation, relative to the robot's cell
+   */
+  struct FootprintMask
+  {
+    std::vector<int> offsets;
+    int min_x, max_x, min_y, max_y;
+  };
+
+  /**
+   * @brief Precompute the footprint outline cells for each angle bin, as rasterized by
+   * footprintCostAtPose() for a pose in the center of a cell
+   */
+  void precomputeFootprintMasks()
+  {
+    auto masks = std::make_shared<std::vector<FootprintMask>>(num_quantizations_);
+    const double resolution = costmap_->getResolution();
+    const int size_x = static_cast<int>(costmap_->getSizeInCellsX());
+    bin_size_ = 2.0 * M_PI / static_cast<double>(num_quantizations_);
+
+    std::vector<std::pair<int, int>> vertices(unoriented_footprint_.size());
+    std::vector<std::pair<int, int>> cells;
+    for (unsigned int i = 0; i != num_quantizations_; i++) {
+      const double cos_th = cos(static_cast<double>(i) * bin_size_);
+      const double sin_th = sin(static_cast<double>(i) * bin_size_);
+      FootprintMask & mask = (*masks)[i];
+      mask.min_x = mask.min_y = std::numeric_limits<int>::max();
+      mask.max_x = mask.max_y = std::numeric_limits<int>::lowest();
+
+      for (unsigned int j = 0; j != unoriented_footprint_.size(); j++) {
+        const auto & pt = unoriented_footprint_[j];
+        vertices[j].first = static_cast<int>(
+          floor(0.5 + (pt.x * cos_th - pt.y * sin_th) / resolution));
+        vertices[j].second = static_cast<int>(
+          floor(0.5 + (pt.x * sin_th + pt.y * cos_th) / resolution));
+        mask.min_x = std::min(mask.min_x, vertices[j].first);
+        mask.max_x = std::max(mask.max_x, vertices[j].first);
+        mask.min_y = std::min(mask.min_y, vertices[j].second);
+        mask.max_y = std::max(mask.max_y, vertices[j].second);
+      }
+
+      // rasterize each edge, including the one closing the polygon
+      cells.clear();
+      for (unsigned int j = 0; j != vertices.size(); j++) {
+        const auto & v0 = vertices[j];
+        const auto & v1 = vertices[(j + 1) % vertices.size()];
+        for (nav2_util::LineIterator line(v0.first, v0.second, v1.first, v1.second);
+          line.isValid(); line.advance())
+        {
+          cells.emplace_back(line.getX(), line.getY());
+        }
+      }
+      std::sort(cells.begin(), cells.end());
+      cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+      mask.offsets.reserve(cells.size());
+      for (const auto & cell : cells) {
+        mask.offsets.push_back(cell.second * size_x + cell.first);
+      }
+    }
+
+    footprint_masks_ = masks;
+  }
+
+  /**
+   * @brief Check if footprint cells of a mask are in collision with the costmap
+   * @param x X coordinate of pose to check against, must be integral
+   * @param y Y coordinate of pose to check against, must be integral
+   * @param mask Footprint mask at the orientation of the pose
+   * @param traverse_unknown Whether or not to traverse in unknown space
+   * @return boolean if in collision or not.
+   */
+  bool maskInCollision(
+    const float & x,
+    const float & y,
+    const FootprintMask & mask,
+    const bool & traverse_unknown)
+  {
+    const int mx = static_cast<int>(x);
+    const int my = static_cast<int>(y);
+
+    // Off the map is treated as lethal, like footprintCost()
+    if (mx + mask.min_x < 0 || my + mask.min_y < 0 ||
+      mx + mask.max_x >= static_cast<int>(costmap_->getSizeInCellsX()) ||
+      my + mask.max_y >= static_cast<int>(costmap_->getSizeInCellsY()))
+    {
+      footprint_cost_ = OCCUPIED;
+      return true;
+    }
+
+    const unsigned char * cell = costmap_->getCharMap() +
+      costmap_->getIndex(static_cast<unsigned int>(mx), static_cast<unsigned int>(my));
+    unsigned char max_cost = 0;
+    for (const int & offset : mask.offsets) {
+      const unsigned char & cost = cell[offset];
+      if (cost == OCCUPIED || cost == INSCRIBED) {
+        footprint_cost_ = cost;
+        return true;
+      }
+      max_cost = std::max(max_cost, cost);
+    }
+
+    footprint_cost_ = max_cost;
+    if (footprint_cost_ == UNKNOWN) {
+      return !traverse_unknown;
+    }
+    return false;
+  }
+
   nav2_costmap_2d::Footprint unoriented_footprint_;
   double footprint_cost_;
   bool footprint_is_radius_;
+  unsigned int num_quantizations_;
+  double bin_size_;
+  // Shared as collision checkers are copied by value during search
+  std::shared_ptr<const std::vector<FootprintMask>> footprint_masks_;
 };
 
 }  // namespace nav2_smac_planner
@@ -59,6 +59,41 @@ inline MotionModel fromString(const std::string & n)
   }
 }
 
+enum class SearchMode
+{
+  UNKNOWN = 0,
+  ASTAR = 1,
+  ANYTIME = 2,
+  BIDIRECTIONAL = 3,
+};
+
+inline std::string toString(const SearchMode & n)
+{
+  switch (n) {
+    case SearchMode::ASTAR:
+      return "A*";
+    case SearchMode::ANYTIME:
+      return "Anytime";
+    case SearchMode::BIDIRECTIONAL:
+      return "Bidirectional";
+    default:
+      return "Unknown";
+  }
+}
+
+inline SearchMode searchModeFromString(const std::string & n)
+{
+  if (n == "ASTAR") {
+    return SearchMode::ASTAR;
+  } else if (n == "ANYTIME") {
+    return SearchMode::ANYTIME;
+  } else if (n == "BIDIRECTIONAL") {
+    return SearchMode::BIDIRECTIONAL;
+  } else {
+    return SearchMode::UNKNOWN;
+  }
+}
+
 const float UNKNOWN = 255;
 const float OCCUPIED = 254;
 const float INSCRIBED = 253;
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "nav2_smac_planner/constants.hpp"
@@ -84,12 +85,43 @@ public:
    */
   void resizeCostmap();
 
+  /**
+   * @brief Downsample a grid of costs by assigning each coarse cell the max cost of the cells
+   * it covers, working on contiguous rows, vectorized when available and parallel over rows
+   * @param costs Row-major costs of the original grid
+   * @param size_x Size of the original grid in X
+   * @param size_y Size of the original grid in Y
+   * @param downsampling_factor Number of cells per coarse cell in X and Y
+   * @param downsampled_costs Row-major costs of the coarse grid to set, rounded up in size
+   */
+  static void maxPool(
+    const unsigned char * costs,
+    const unsigned int & size_x,
+    const unsigned int & size_y,
+    const unsigned int & downsampling_factor,
+    unsigned char * downsampled_costs);
+
 protected:
   /**
    * @brief Update the sizes X-Y of the costmap and its downsampled version
    */
   void updateCostmapSize();
 
+  /**
+   * @brief Set each element of a row to its max with another row
+   * @param row Row to take the max with
+   * @param max_row Row to update
+   * @param size Number of elements
+   */
+  static void maxRow(const unsigned char * row, unsigned char * max_row, const unsigned int & size);
+
+  /**
+   * @brief Set each element of the first half of a row to the max of a pair of elements
+   * @param row Row to reduce in place
+   * @param size Number of elements, even
+   */
+  static void maxPairs(unsigned char * row, const unsigned int & size);
+
   /**
    * @brief Explore all subcells of the original costmap and assign the max cost to the new (downsampled) cell
    * @param new_mx The X-coordinate of the cell in the new costmap
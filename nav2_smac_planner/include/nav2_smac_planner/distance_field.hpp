@@ -0,0 +1,286 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_SMAC_PLANNER__DISTANCE_FIELD_HPP_
+#define NAV2_SMAC_PLANNER__DISTANCE_FIELD_HPP_
+
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "Eigen/Core"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_smac_planner/constants.hpp"
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::EuclideanDistanceField
+ * @brief A Euclidean signed distance field (ESDF) over a window of a costmap, giving the
+ * distance in meters from the nearest inscribed or occupied cell, negative inside them.
+ * Distances are bilinearly interpolated between cell centers, so its value is continuous
+ * for the smoother rather than constant over each cell.
+ */
+class EuclideanDistanceField
+{
+public:
+  /**
+   * @brief A constructor for nav2_smac_planner::EuclideanDistanceField
+   */
+  EuclideanDistanceField()
+  : _min_x(0), _min_y(0), _size_x(0), _size_y(0),
+    _resolution(1.0), _origin_x(0.0), _origin_y(0.0)
+  {
+  }
+
+  /**
+   * @brief Compute the distance field from a window of the costmap, reusing memory
+   * @param costmap Costmap to compute distances to lethal cells of
+   * @param min_x Minimum X cell of window, inclusive
+   * @param min_y Minimum Y cell of window, inclusive
+   * @param max_x Maximum X cell of window, exclusive
+   * @param max_y Maximum Y cell of window, exclusive
+   */
+  void update(
+    const nav2_costmap_2d::Costmap2D * costmap,
+    const unsigned int & min_x, const unsigned int & min_y,
+    const unsigned int & max_x, const unsigned int & max_y)
+  {
+    _min_x = min_x;
+    _min_y = min_y;
+    _size_x = max_x > min_x ? max_x - min_x : 0;
+    _size_y = max_y > min_y ? max_y - min_y : 0;
+    _resolution = costmap->getResolution();
+    _origin_x = costmap->getOriginX();
+    _origin_y = costmap->getOriginY();
+
+    const unsigned int num_cells = _size_x * _size_y;
+    _distances.resize(num_cells);
+    _inside_distances.resize(num_cells);
+
+    // Squared distances to the nearest lethal cell, and to the nearest free cell
+    bool any_lethal = false;
+    const unsigned char * charmap = costmap->getCharMap();
+    const unsigned int costmap_size_x = costmap->getSizeInCellsX();
+    for (unsigned int y = 0; y != _size_y; y++) {
+      for (unsigned int x = 0; x != _size_x; x++) {
+        const unsigned char cost = charmap[(y + _min_y) * costmap_size_x + x + _min_x];
+        const bool lethal = cost == OCCUPIED || cost == INSCRIBED;
+        any_lethal |= lethal;
+        _distances[y * _size_x + x] = lethal ? 0.0 : INF;
+        _inside_distances[y * _size_x + x] = lethal ? INF : 0.0;
+      }
+    }
+
+    // Without obstacles, every cell is considered as far from them as the window is wide
+    const double max_distance = static_cast<double>(std::max(_size_x, _size_y)) * _resolution;
+    if (!any_lethal) {
+      std::fill(_distances.begin(), _distances.end(), max_distance);
+      return;
+    }
+
+    computeSquaredDistances(_distances);
+    computeSquaredDistances(_inside_distances);
+
+    // Signed distance in meters, measured from the boundary between lethal and free cells
+    for (unsigned int i = 0; i != num_cells; i++) {
+      if (_inside_distances[i] == 0.0) {
+        _distances[i] = (std::sqrt(_distances[i]) - 0.5) * _resolution;
+      } else {
+        _distances[i] = std::max(
+          -(std::sqrt(_inside_distances[i]) - 0.5) * _resolution, -max_distance);
+      }
+    }
+  }
+
+  /**
+   * @brief Get the interpolated signed distance and its gradient at a world coordinate
+   * @param wx X world coordinate
+   * @param wy Y world coordinate
+   * @param distance Distance in meters to set
+   * @param gradient Gradient of distance with respect to world coordinates to set
+   * @return If the coordinate is within the window of the field
+   */
+  inline bool getDistance(
+    const double & wx, const double & wy,
+    double & distance, Eigen::Vector2d & gradient) const
+  {
+    if (_size_x < 2 || _size_y < 2) {
+      return false;
+    }
+
+    // Position relative to the center of the first cell in the window
+    const double fx = (wx - _origin_x) / _resolution - 0.5 - static_cast<double>(_min_x);
+    const double fy = (wy - _origin_y) / _resolution - 0.5 - static_cast<double>(_min_y);
+    if (fx < -0.5 || fy < -0.5 || fx > _size_x - 0.5 || fy > _size_y - 0.5) {
+      return false;
+    }
+
+    // Clamp to the outermost cell centers, half a cell of the window's edges
+    const double cx = std::min(std::max(fx, 0.0), static_cast<double>(_size_x - 1));
+    const double cy = std::min(std::max(fy, 0.0), static_cast<double>(_size_y - 1));
+    const unsigned int x0 = std::min(static_cast<unsigned int>(cx), _size_x - 2);
+    const unsigned int y0 = std::min(static_cast<unsigned int>(cy), _size_y - 2);
+    const double u = cx - x0;
+    const double v = cy - y0;
+
+    const double & d00 = _distances[y0 * _size_x + x0];
+    const double & d10 = _distances[y0 * _size_x + x0 + 1];
+    const double & d01 = _distances[(y0 + 1) * _size_x + x0];
+    const double & d11 = _distances[(y0 + 1) * _size_x + x0 + 1];
+
+    distance = (1.0 - v) * ((1.0 - u) * d00 + u * d10) + v * ((1.0 - u) * d01 + u * d11);
+    gradient[0] = ((1.0 - v) * (d10 - d00) + v * (d11 - d01)) / _resolution;
+    gradient[1] = ((1.0 - u) * (d01 - d00) + u * (d11 - d10)) / _resolution;
+    return true;
+  }
+
+  /**
+   * @brief Get the signed distance at a cell of the window
+   * @param x X cell in the window
+   * @param y Y cell in the window
+   * @return Distance in meters
+   */
+  inline double getCellDistance(const unsigned int & x, const unsigned int & y) const
+  {
+    return _distances[y * _size_x + x];
+  }
+
+  /**
+   * @brief Get size of the window in X
+   * @return Size in cells
+   */
+  inline unsigned int getSizeX() const
+  {
+    return _size_x;
+  }
+
+  /**
+   * @brief Get size of the window in Y
+   * @return Size in cells
+   */
+  inline unsigned int getSizeY() const
+  {
+    return _size_y;
+  }
+
+protected:
+  /**
+   * @brief Exact squared Euclidean distance transform in place, separably along rows then
+   * columns using the lower envelope of parabolas of Felzenszwalb and Huttenlocher
+   * @param grid Window sized grid of 0 at sources and INF elsewhere, set to squared distances
+   */
+  void computeSquaredDistances(std::vector<double> & grid)
+  {
+    const unsigned int max_size = std::max(_size_x, _size_y);
+    _f.resize(max_size);
+    _d.resize(max_size);
+    _v.resize(max_size);
+    _z.resize(max_size + 1);
+
+    for (unsigned int y = 0; y != _size_y; y++) {
+      for (unsigned int x = 0; x != _size_x; x++) {
+        _f[x] = grid[y * _size_x + x];
+      }
+      transform1D(_size_x);
+      for (unsigned int x = 0; x != _size_x; x++) {
+        grid[y * _size_x + x] = _d[x];
+      }
+    }
+
+    for (unsigned int x = 0; x != _size_x; x++) {
+      for (unsigned int y = 0; y != _size_y; y++) {
+        _f[y] = grid[y * _size_x + x];
+      }
+      transform1D(_size_y);
+      for (unsigned int y = 0; y != _size_y; y++) {
+        grid[y * _size_x + x] = _d[y];
+      }
+    }
+  }
+
+  /**
+   * @brief 1D squared distance transform of _f into _d
+   * @param n Number of elements
+   */
+  inline void transform1D(const unsigned int & n)
+  {
+    int k = 0;
+    _v[0] = 0;
+    _z[0] = -INF;
+    _z[1] = INF;
+
+    for (int q = 1; q < static_cast<int>(n); q++) {
+      if (_f[q] >= INF) {
+        continue;
+      }
+
+      // First finite value, start the envelope from it
+      if (_f[_v[0]] >= INF) {
+        _v[0] = q;
+        continue;
+      }
+
+      double s = intersection(q, _v[k]);
+      while (k > 0 && s <= _z[k]) {
+        k--;
+        s = intersection(q, _v[k]);
+      }
+      k++;
+      _v[k] = q;
+      _z[k] = s;
+      _z[k + 1] = INF;
+    }
+
+    if (_f[_v[0]] >= INF) {
+      std::fill(_d.begin(), _d.begin() + n, INF);
+      return;
+    }
+
+    k = 0;
+    for (int q = 0; q < static_cast<int>(n); q++) {
+      while (_z[k + 1] < q) {
+        k++;
+      }
+      const double dq = static_cast<double>(q - _v[k]);
+      _d[q] = dq * dq + _f[_v[k]];
+    }
+  }
+
+  /**
+   * @brief Intersection of the parabolas rooted at q and p
+   * @param q Position of a parabola
+   * @param p Position of a parabola
+   * @return Position of intersection
+   */
+  inline double intersection(const int & q, const int & p) const
+  {
+    return ((_f[q] + q * q) - (_f[p] + p * p)) / (2.0 * (q - p));
+  }
+
+  static constexpr double INF = std::numeric_limits<double>::max() / 4.0;
+
+  unsigned int _min_x, _min_y, _size_x, _size_y;
+  double _resolution, _origin_x, _origin_y;
+  std::vector<double> _distances;
+  std::vector<double> _inside_distances;
+  std::vector<double> _f, _d, _z;
+  std::vector<int> _v;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__DISTANCE_FIELD_HPP_
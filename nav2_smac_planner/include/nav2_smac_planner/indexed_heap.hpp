@@ -0,0 +1,219 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_SMAC_PLANNER__INDEXED_HEAP_HPP_
+#define NAV2_SMAC_PLANNER__INDEXED_HEAP_HPP_
+
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <utility>
+
+#include "nav2_smac_planner/node_basic.hpp"
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::IndexedHeap
+ * @brief A 4-ary min-heap open set supporting in-place decrease-key. Each graph node stores
+ * its position in the heap so that it is only ever queued once, rather than re-queued
+ * every time a lower cost to reach it is found.
+ */
+template<typename NodeT>
+class IndexedHeap
+{
+public:
+  typedef std::pair<float, NodeBasic<NodeT>> NodeElement;
+  static constexpr unsigned int NOT_IN_HEAP = std::numeric_limits<unsigned int>::max();
+
+  /**
+   * @brief A constructor for nav2_smac_planner::IndexedHeap
+   */
+  IndexedHeap()
+  : _peak_size(0)
+  {
+  }
+
+  /**
+   * @brief Whether the heap is empty
+   * @return If empty
+   */
+  inline bool empty() const
+  {
+    return _heap.empty();
+  }
+
+  /**
+   * @brief Number of nodes in the heap
+   * @return Size
+   */
+  inline size_t size() const
+  {
+    return _heap.size();
+  }
+
+  /**
+   * @brief Maximum number of nodes in the heap since last cleared
+   * @return Peak size
+   */
+  inline size_t peakSize() const
+  {
+    return _peak_size;
+  }
+
+  /**
+   * @brief Lowest cost element of the heap
+   * @return Reference to top element
+   */
+  inline const NodeElement & top() const
+  {
+    return _heap.front();
+  }
+
+  /**
+   * @brief Add node to heap, or lower its cost if already queued with a higher cost
+   * @param cost The cost to sort by
+   * @param node The node to queue, its graph node pointer must be set
+   */
+  inline void push(const float & cost, const NodeBasic<NodeT> & node)
+  {
+    unsigned int & position = node.graph_node_ptr->getOpenSetIndex();
+
+    if (position != NOT_IN_HEAP) {
+      // Decrease-key: never increase, the existing entry is already cheaper
+      if (cost < _heap[position].first) {
+        _heap[position].first = cost;
+        _heap[position].second = node;
+        siftUp(position);
+      }
+      return;
+    }
+
+    position = static_cast<unsigned int>(_heap.size());
+    _heap.emplace_back(cost, node);
+    siftUp(position);
+
+    if (_heap.size() > _peak_size) {
+      _peak_size = _heap.size();
+    }
+  }
+
+  /**
+   * @brief Remove the lowest cost element of the heap
+   */
+  inline void pop()
+  {
+    _heap.front().second.graph_node_ptr->getOpenSetIndex() = NOT_IN_HEAP;
+
+    if (_heap.size() == 1) {
+      _heap.pop_back();
+      return;
+    }
+
+    _heap.front() = _heap.back();
+    _heap.pop_back();
+    _heap.front().second.graph_node_ptr->getOpenSetIndex() = 0;
+    siftDown(0);
+  }
+
+  /**
+   * @brief Remove all elements, keeping allocated memory
+   */
+  void clear()
+  {
+    for (auto & element : _heap) {
+      element.second.graph_node_ptr->getOpenSetIndex() = NOT_IN_HEAP;
+    }
+    _heap.clear();
+    _peak_size = 0;
+  }
+
+protected:
+  static constexpr unsigned int ARITY = 4;
+
+  /**
+   * @brief Move element up until heap ordering is restored
+   * @param position Position of element in heap
+   */
+  inline void siftUp(unsigned int position)
+  {
+    NodeElement element = _heap[position];
+
+    while (position > 0) {
+      const unsigned int parent = (position - 1) / ARITY;
+      if (!(element.first < _heap[parent].first)) {
+        break;
+      }
+      moveTo(parent, position);
+      position = parent;
+    }
+
+    _heap[position] = element;
+    element.second.graph_node_ptr->getOpenSetIndex() = position;
+  }
+
+  /**
+   * @brief Move element down until heap ordering is restored
+   * @param position Position of element in heap
+   */
+  inline void siftDown(unsigned int position)
+  {
+    const unsigned int size = static_cast<unsigned int>(_heap.size());
+    NodeElement element = _heap[position];
+
+    while (true) {
+      const unsigned int first_child = position * ARITY + 1;
+      if (first_child >= size) {
+        break;
+      }
+
+      // find lowest cost child
+      const unsigned int last_child = std::min(first_child + ARITY, size);
+      unsigned int best_child = first_child;
+      for (unsigned int child = first_child + 1; child < last_child; ++child) {
+        if (_heap[child].first < _heap[best_child].first) {
+          best_child = child;
+        }
+      }
+
+      if (!(_heap[best_child].first < element.first)) {
+        break;
+      }
+      moveTo(best_child, position);
+      position = best_child;
+    }
+
+    _heap[position] = element;
+    element.second.graph_node_ptr->getOpenSetIndex() = position;
+  }
+
+  /**
+   * @brief Move element in heap, keeping its graph node position in sync
+   * @param from Position to move from
+   * @param to Position to move to
+   */
+  inline void moveTo(const unsigned int & from, const unsigned int & to)
+  {
+    _heap[to] = _heap[from];
+    _heap[to].second.graph_node_ptr->getOpenSetIndex() = to;
+  }
+
+  std::vector<NodeElement> _heap;
+  size_t _peak_size;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__INDEXED_HEAP_HPP_
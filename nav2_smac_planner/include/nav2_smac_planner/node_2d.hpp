@@ -56,6 +56,14 @@ public:
   };
   typedef std::vector<Coordinates> CoordinateVector;
 
+  /**
+   * @struct nav2_smac_planner::Node2D::ExpansionScratch
+   * @brief Caller-owned buffers reused between neighbor expansions, none needed for 2D
+   */
+  struct ExpansionScratch
+  {
+  };
+
   /**
    * @brief A constructor for nav2_smac_planner::Node2D
    * @param cost_in The costmap cost at this node
@@ -145,6 +153,15 @@ public:
     _is_queued = true;
   }
 
+  /**
+   * @brief Gets position of this node in an indexed open set, if queued in one
+   * @return Reference to open set position
+   */
+  inline unsigned int & getOpenSetIndex()
+  {
+    return _open_set_index;
+  }
+
   /**
    * @brief Gets cell index
    * @return Reference to cell index
@@ -160,7 +177,7 @@ public:
    * @param collision_checker Pointer to collision checker object
    * @return whether this node is valid and collision free
    */
-  bool isNodeValid(const bool & traverse_unknown, GridCollisionChecker collision_checker);
+  bool isNodeValid(const bool & traverse_unknown, GridCollisionChecker & collision_checker);
 
   /**
    * @brief get traversal cost from this node to child node
@@ -221,15 +238,48 @@ public:
   /**
    * @brief Retrieve all valid neighbors of a node.
    * @param node Pointer to the node we are currently exploring in A*
-   * @param graph Reference to graph to discover new nodes
+   * @param NeighborGetter Functor taking a node index and node pointer reference to set,
+   * returning whether a node at that index may be searched
+   * @param collision_checker Collision checker to use
+   * @param traverse_unknown If unknown costs are valid to traverse
    * @param neighbors Vector of neighbors to be filled
+   * @param scratch Buffers reused between expansions
    */
-  static void getNeighbors(
-    NodePtr & node,
-    std::function<bool(const unsigned int &, nav2_smac_planner::Node2D * &)> & validity_checker,
-    GridCollisionChecker collision_checker,
+  template<typename NeighborGetterT>
+  static inline void getNeighbors(
+    const NodePtr & node,
+    const NeighborGetterT & NeighborGetter,
+    GridCollisionChecker & collision_checker,
     const bool & traverse_unknown,
-    NodeVector & neighbors);
+    NodeVector & neighbors,
+    ExpansionScratch & /*scratch*/)
+  {
+    // NOTE(stevemacenski): Irritatingly, the order here matters. If you start in free
+    // space and then expand 8-connected, the first set of neighbors will be all cost
+    // _neutral_cost. Then its expansion will all be 2 * _neutral_cost but now multiple
+    // nodes are touching that node so the last cell to update the back pointer wins.
+    // Thusly, the ordering ends with the cardinal directions for both sets such that
+    // behavior is consistent in large free spaces between them.
+    // 100  50   0
+    // 100  50  50
+    // 100 100 100   where lower-middle '100' is visited with same cost by both bottom '50' nodes
+    // Therefore, it is valuable to have some low-potential across the entire map
+    // rather than a small inflation around the obstacles
+    int index;
+    NodePtr neighbor;
+    int node_i = node->getIndex();
+
+    for (unsigned int i = 0; i != _neighbors_grid_offsets.size(); ++i) {
+      index = node_i + _neighbors_grid_offsets[i];
+      if (NeighborGetter(index, neighbor)) {
+        if (neighbor->isNodeValid(traverse_unknown, collision_checker) &&
+          !neighbor->wasVisited())
+        {
+          neighbors.push_back(neighbor);
+        }
+      }
+    }
+  }
 
   Node2D * parent;
   static double neutral_cost;
@@ -241,6 +291,7 @@ private:
   unsigned int _index;
   bool _was_visited;
   bool _is_queued;
+  unsigned int _open_set_index;
 };
 
 }  // namespace nav2_smac_planner
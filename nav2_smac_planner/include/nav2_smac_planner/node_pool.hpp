@@ -0,0 +1,243 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_SMAC_PLANNER__NODE_POOL_HPP_
+#define NAV2_SMAC_PLANNER__NODE_POOL_HPP_
+
+#include <cassert>
+#include <vector>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::NodePool
+ * @brief A dense, lazily paged store of graph nodes addressed directly by node index.
+ * Pages are allocated on first touch and kept between searches. Each slot carries the
+ * generation it was constructed in, so clearing the pool is an O(1) generation increment
+ * rather than a deallocation of every node searched.
+ */
+template<typename NodeT>
+class NodePool
+{
+public:
+  typedef NodeT * NodePtr;
+
+  /**
+   * @brief A constructor for nav2_smac_planner::NodePool
+   * @param page_size_bits Number of nodes per page, as a power of 2
+   */
+  explicit NodePool(const unsigned int & page_size_bits = 12)
+  : _page_size_bits(page_size_bits),
+    _page_size(1u << page_size_bits),
+    _page_mask((1u << page_size_bits) - 1u),
+    _num_nodes(0),
+    _generation(1),
+    _size(0),
+    _num_allocated_pages(0)
+  {
+  }
+
+  /**
+   * @brief A destructor for nav2_smac_planner::NodePool
+   */
+  ~NodePool()
+  {
+    releasePages();
+  }
+
+  NodePool(const NodePool &) = delete;
+  NodePool & operator=(const NodePool &) = delete;
+
+  /**
+   * @brief Set the total number of addressable nodes. Releases all pages if changed.
+   * @param num_nodes Total number of node indices the pool must address
+   */
+  void resize(const unsigned int & num_nodes)
+  {
+    if (num_nodes == _num_nodes) {
+      return;
+    }
+
+    releasePages();
+    _num_nodes = num_nodes;
+    _pages.resize((static_cast<size_t>(num_nodes) + _page_size - 1) >> _page_size_bits);
+    _size = 0;
+  }
+
+  /**
+   * @brief Get the node at index, constructing it in place with args if it has not
+   * been added since the last clear. Mirrors the semantics of std::unordered_map::emplace.
+   * @param index Index of the node
+   * @param args Arguments to construct the node with, if required
+   * @return Node pointer to the node at index, or nullptr if index is out of range
+   */
+  template<typename ... Args>
+  inline NodePtr emplace(const unsigned int & index, Args && ... args)
+  {
+    if (index >= _num_nodes) {
+      return nullptr;
+    }
+
+    Page & page = getPage(index);
+    const unsigned int slot = index & _page_mask;
+    NodePtr node = reinterpret_cast<NodePtr>(&page.nodes[slot]);
+
+    if (page.generations[slot] != _generation) {
+      if (page.generations[slot] != 0) {
+        node->~NodeT();
+      }
+      new (node) NodeT(std::forward<Args>(args)...);
+      page.generations[slot] = _generation;
+      _size++;
+    }
+
+    return node;
+  }
+
+  /**
+   * @brief Get a node previously added since the last clear
+   * @param index Index of the node
+   * @return Node pointer to the node at index
+   */
+  NodePtr at(const unsigned int & index)
+  {
+    const size_t page_idx = index >> _page_size_bits;
+    const unsigned int slot = index & _page_mask;
+    if (index >= _num_nodes || !_pages[page_idx] ||
+      _pages[page_idx]->generations[slot] != _generation)
+    {
+      throw std::out_of_range("NodePool: requested node is not in the graph.");
+    }
+
+    return reinterpret_cast<NodePtr>(&_pages[page_idx]->nodes[slot]);
+  }
+
+  /**
+   * @brief Invalidate all nodes in the pool, keeping pages allocated
+   */
+  void clear()
+  {
+    _size = 0;
+    _generation++;
+
+    // Generation counter wrapped around, must actually reset all slots once
+    if (_generation == 0) {
+      releasePages();
+      _generation = 1;
+    }
+  }
+
+  /**
+   * @brief Whether there are any nodes added since the last clear
+   * @return If empty
+   */
+  inline bool empty() const
+  {
+    return _size == 0;
+  }
+
+  /**
+   * @brief Number of nodes added since the last clear
+   * @return Number of nodes
+   */
+  inline unsigned int size() const
+  {
+    return _size;
+  }
+
+  /**
+   * @brief Approximate memory held by allocated pages
+   * @return Memory in bytes
+   */
+  size_t getMemoryUsage() const
+  {
+    return _num_allocated_pages * _page_size * (sizeof(Storage) + sizeof(unsigned int)) +
+           _pages.size() * sizeof(std::unique_ptr<Page>);
+  }
+
+protected:
+  typedef typename std::aligned_storage<sizeof(NodeT), alignof(NodeT)>::type Storage;
+
+  /**
+   * @struct nav2_smac_planner::NodePool::Page
+   * @brief Contiguous block of node storage and their construction generations
+   */
+  struct Page
+  {
+    explicit Page(const unsigned int & page_size)
+    : nodes(new Storage[page_size]),
+      generations(new unsigned int[page_size]())
+    {
+    }
+
+    std::unique_ptr<Storage[]> nodes;
+    std::unique_ptr<unsigned int[]> generations;
+  };
+
+  /**
+   * @brief Get the page containing index, allocating it on first use
+   * @param index Index of the node
+   * @return Reference to page
+   */
+  inline Page & getPage(const unsigned int & index)
+  {
+    assert(index < _num_nodes);
+    std::unique_ptr<Page> & page = _pages[index >> _page_size_bits];
+    if (!page) {
+      page = std::make_unique<Page>(_page_size);
+      _num_allocated_pages++;
+    }
+    return *page;
+  }
+
+  /**
+   * @brief Destroy all constructed nodes and release all pages
+   */
+  void releasePages()
+  {
+    for (auto & page : _pages) {
+      if (!page) {
+        continue;
+      }
+      if (!std::is_trivially_destructible<NodeT>::value) {
+        for (unsigned int i = 0; i != _page_size; i++) {
+          if (page->generations[i] != 0) {
+            reinterpret_cast<NodePtr>(&page->nodes[i])->~NodeT();
+          }
+        }
+      }
+      page.reset();
+    }
+    _num_allocated_pages = 0;
+  }
+
+  unsigned int _page_size_bits;
+  unsigned int _page_size;
+  unsigned int _page_mask;
+  unsigned int _num_nodes;
+  unsigned int _generation;
+  unsigned int _size;
+  size_t _num_allocated_pages;
+  std::vector<std::unique_ptr<Page>> _pages;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__NODE_POOL_HPP_
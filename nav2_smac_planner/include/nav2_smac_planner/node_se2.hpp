@@ -107,9 +107,9 @@ struct MotionTable
   /**
    * @brief Get projections of motion models
    * @param node Ptr to SE2 node
-   * @return A set of motion poses
+   * @param projection_list Vector to fill with a motion pose per primitive, reusing its memory
    */
-  MotionPoses getProjections(const NodeSE2 * node);
+  void getProjections(const NodeSE2 * node, MotionPoses & projection_list);
 
   /**
    * @brief Get a projection of motion model
@@ -118,6 +118,26 @@ struct MotionTable
    */
   MotionPose getProjection(const NodeSE2 * node, const unsigned int & motion_index);
 
+  /**
+   * @brief Get the multiplier of the cost of a motion primitive following another,
+   * with turning, direction change and reversing penalties applied
+   * @param parent_motion_index Motion primitive index of the node expanded from
+   * @param child_motion_index Motion primitive index of the node expanded to
+   * @return Traversal cost multiplier
+   */
+  inline float getTravelCostMultiplier(
+    const unsigned int & parent_motion_index,
+    const unsigned int & child_motion_index) const
+  {
+    return travel_cost_multipliers[parent_motion_index * projections.size() + child_motion_index];
+  }
+
+  /**
+   * @brief Precompute the projections of each motion primitive from each heading bin
+   * and the traversal cost multipliers between primitives
+   */
+  void initProjectionTables();
+
   MotionPoses projections;
   unsigned int size_x;
   unsigned int num_angle_quantization;
@@ -127,9 +147,13 @@ struct MotionTable
   float non_straight_penalty;
   float cost_penalty;
   float reverse_penalty;
+  int num_threads;
   ompl::base::StateSpacePtr state_space;
-  std::vector<std::vector<double>> delta_xs;
-  std::vector<std::vector<double>> delta_ys;
+  // Projection of each primitive from each heading bin, indexed by
+  // heading * num primitives + primitive, as deltas in X-Y and the final heading bin
+  MotionPoses heading_projections;
+  // Indexed by parent primitive * num primitives + child primitive
+  std::vector<float> travel_cost_multipliers;
 };
 
 /**
@@ -168,6 +192,18 @@ public:
 
   typedef std::vector<Coordinates> CoordinateVector;
 
+  /**
+   * @struct nav2_smac_planner::NodeSE2::ExpansionScratch
+   * @brief Caller-owned buffers reused between neighbor expansions, so that
+   * expanding does not allocate once they have grown to the number of primitives
+   */
+  struct ExpansionScratch
+  {
+    MotionPoses projections;
+    NodeVector candidates;
+    std::vector<float> costs;
+  };
+
   /**
    * @brief A constructor for nav2_smac_planner::NodeSE2
    * @param index The index of this node for self-reference
@@ -283,6 +319,15 @@ public:
     _is_queued = true;
   }
 
+  /**
+   * @brief Gets position of this node in an indexed open set, if queued in one
+   * @return Reference to open set position
+   */
+  inline unsigned int & getOpenSetIndex()
+  {
+    return _open_set_index;
+  }
+
   /**
    * @brief Gets cell index
    * @return Reference to cell index
@@ -297,7 +342,7 @@ public:
    * @param traverse_unknown If we can explore unknown nodes on the graph
    * @return whether this node is valid and collision free
    */
-  bool isNodeValid(const bool & traverse_unknown, GridCollisionChecker collision_checker);
+  bool isNodeValid(const bool & traverse_unknown, GridCollisionChecker & collision_checker);
 
   /**
    * @brief Get traversal cost of parent node to child node
@@ -364,6 +409,29 @@ public:
     const Coordinates & node_coords,
     const Coordinates & goal_coordinates);
 
+  /**
+   * @brief Get the obstacle-free Dubin or Reeds-Shepp distance between poses, using the
+   * precomputed lookup table when the node is within its window around the goal
+   * @param node_coords Coordinates of the node
+   * @param goal_coords Coordinates of the goal
+   * @return Motion model distance, in cells
+   */
+  static float getDistanceHeuristic(
+    const Coordinates & node_coords,
+    const Coordinates & goal_coords);
+
+  /**
+   * @brief Precompute a goal-relative lookup table of obstacle-free motion model distances.
+   * Only recomputed if the motion model, turning radius, angle bins or size changed.
+   * @param motion_model Motion model enum to use
+   * @param angle_quantization Size of theta bins of graph
+   * @param search_info Search info to use, lookup_table_size is the window width in cells
+   */
+  static void precomputeDistanceHeuristic(
+    const MotionModel & motion_model,
+    const unsigned int & angle_quantization,
+    const SearchInfo & search_info);
+
   /**
    * @brief Initialize motion models
    * @param motion_model Motion model enum to use
@@ -386,24 +454,120 @@ public:
    * @param start_y Coordinate of Start Y
    * @param goal_x Coordinate of Goal X
    * @param goal_y Coordinate of Goal Y
+   * @param reuse_previous Whether to keep the wavefront for the next call, and if the goal
+   * is unchanged since the last call, repair it for changes in the costmap instead of
+   * recomputing it
    */
   static void computeWavefrontHeuristic(
     nav2_costmap_2d::Costmap2D * & costmap,
     const unsigned int & start_x, const unsigned int & start_y,
-    const unsigned int & goal_x, const unsigned int & goal_y);
+    const unsigned int & goal_x, const unsigned int & goal_y,
+    const bool & reuse_previous);
+
+  /**
+   * @brief Get the last computed wavefront heuristic
+   * @return Wavefront values per cell, 0 where not reached
+   */
+  static const std::vector<unsigned int> & getWavefrontHeuristic()
+  {
+    return _wavefront_heuristic;
+  }
 
   /**
    * @brief Retrieve all valid neighbors of a node.
    * @param node Pointer to the node we are currently exploring in A*
-   * @param validity_checker Functor for state validity checking
+   * @param NeighborGetter Functor taking a node index and node pointer reference to set,
+   * returning whether a node at that index may be searched
+   * @param collision_checker Collision checker to use
+   * @param traverse_unknown If unknown costs are valid to traverse
    * @param neighbors Vector of neighbors to be filled
+   * @param scratch Buffers reused between expansions
    */
-  static void getNeighbors(
+  template<typename NeighborGetterT>
+  static inline void getNeighbors(
     const NodePtr & node,
-    std::function<bool(const unsigned int &, nav2_smac_planner::NodeSE2 * &)> & validity_checker,
-    GridCollisionChecker collision_checker,
+    const NeighborGetterT & NeighborGetter,
+    GridCollisionChecker & collision_checker,
     const bool & traverse_unknown,
-    NodeVector & neighbors);
+    NodeVector & neighbors,
+    ExpansionScratch & scratch)
+  {
+    unsigned int index = 0;
+    NodePtr neighbor = nullptr;
+    Coordinates initial_node_coords;
+    MotionPoses & motion_projections = scratch.projections;
+    motion_table.getProjections(node, motion_projections);
+    const unsigned int num_projections = static_cast<unsigned int>(motion_projections.size());
+
+    // Get the unvisited neighbors from the graph, this modifies the graph so is done serially
+    NodeVector & candidates = scratch.candidates;
+    candidates.assign(num_projections, nullptr);
+    for (unsigned int i = 0; i != num_projections; i++) {
+      index = NodeSE2::getIndex(
+        static_cast<unsigned int>(motion_projections[i]._x),
+        static_cast<unsigned int>(motion_projections[i]._y),
+        static_cast<unsigned int>(motion_projections[i]._theta),
+        motion_table.size_x, motion_table.num_angle_quantization);
+
+      if (NeighborGetter(index, neighbor) && !neighbor->wasVisited()) {
+        candidates[i] = neighbor;
+      }
+    }
+
+    // Collision check the candidates' footprints, which only reads the costmap so may be
+    // done in parallel
+    std::vector<float> & costs = scratch.costs;
+    costs.assign(num_projections, std::numeric_limits<float>::quiet_NaN());
+    auto checkCandidate = [&](const unsigned int & i, GridCollisionChecker & checker)
+      {
+        if (candidates[i] && !checker.inCollision(
+            motion_projections[i]._x, motion_projections[i]._y,
+            motion_projections[i]._theta * motion_table.bin_size, traverse_unknown))
+        {
+          costs[i] = checker.getCost();
+        }
+      };
+
+    if (motion_table.num_threads > 1) {
+      #pragma omp parallel num_threads(motion_table.num_threads)
+      {
+        // Each thread is given its own copy of the collision checker
+        GridCollisionChecker thread_checker(collision_checker);
+        #pragma omp for schedule(static)
+        for (unsigned int i = 0; i < num_projections; i++) {
+          checkCandidate(i, thread_checker);
+        }
+      }
+    } else {
+      for (unsigned int i = 0; i != num_projections; i++) {
+        checkCandidate(i, collision_checker);
+      }
+    }
+
+    // Apply results in primitive order so neighbors are identical regardless of thread count
+    for (unsigned int i = 0; i != num_projections; i++) {
+      neighbor = candidates[i];
+      if (!neighbor) {
+        continue;
+      }
+
+      // Cache the initial pose in case it was visited but valid
+      // don't want to disrupt continuous coordinate expansion
+      initial_node_coords = neighbor->pose;
+      neighbor->setPose(
+        Coordinates(
+          motion_projections[i]._x,
+          motion_projections[i]._y,
+          motion_projections[i]._theta));
+      if (!std::isnan(costs[i])) {
+        neighbor->_cell_cost = costs[i];
+        neighbor->setMotionPrimitiveIndex(i);
+        neighbors.push_back(neighbor);
+      } else {
+        neighbor->setPose(initial_node_coords);
+      }
+    }
+  }
 
   NodeSE2 * parent;
   Coordinates pose;
@@ -411,13 +575,45 @@ public:
   static MotionTable motion_table;
 
 private:
+  /**
+   * @brief Check if a cell is a valid wavefront neighbor, e.g. in bounds and not wrapping
+   * @param idx Index of the cell expanding
+   * @param new_idx Index of the neighboring cell
+   * @param size_x Size of costmap in X
+   * @param size_y Size of costmap in Y
+   * @return whether the neighbor is valid
+   */
+  static inline bool isWavefrontNeighbor(
+    const unsigned int & idx, const unsigned int & new_idx,
+    const unsigned int & size_x, const unsigned int & size_y);
+
+  /**
+   * @brief Repair the wavefront heuristic to the same goal for cells which changed
+   * between expandable and not since it was last computed
+   * @param char_map Current costmap data
+   * @param size_x Size of costmap in X
+   * @param size_y Size of costmap in Y
+   * @param goal_index Index of the goal cell
+   * @param neighborhood Index offsets of the 8-connected neighborhood
+   */
+  static void repairWavefrontHeuristic(
+    const unsigned char * char_map,
+    const unsigned int & size_x, const unsigned int & size_y,
+    const unsigned int & goal_index,
+    const std::vector<int> & neighborhood);
+
   float _cell_cost;
   float _accumulated_cost;
   unsigned int _index;
   bool _was_visited;
   bool _is_queued;
+  unsigned int _open_set_index;
   unsigned int _motion_primitive_index;
   static std::vector<unsigned int> _wavefront_heuristic;
+  static std::vector<unsigned char> _wavefront_costmap;
+  static unsigned int _wavefront_goal_index;
+  static std::vector<float> _distance_heuristic_lookup_table;
+  static int _lookup_table_half_size;
 };
 
 }  // namespace nav2_smac_planner
@@ -83,7 +83,10 @@ struct OptimizerParams
     max_time(1e4),
     param_tol(1e-8),
     fn_tol(1e-6),
-    gradient_tol(1e-10)
+    gradient_tol(1e-10),
+    window_size(0),
+    window_overlap(10),
+    num_threads(1)
   {
   }
 
@@ -187,6 +190,15 @@ struct OptimizerParams
     nav2_util::declare_parameter_if_not_declared(
       node, local_name + "debug_optimizer", rclcpp::ParameterValue(false));
     node->get_parameter(local_name + "debug_optimizer", debug);
+    nav2_util::declare_parameter_if_not_declared(
+      node, local_name + "window_size", rclcpp::ParameterValue(0));
+    node->get_parameter(local_name + "window_size", window_size);
+    nav2_util::declare_parameter_if_not_declared(
+      node, local_name + "window_overlap", rclcpp::ParameterValue(10));
+    node->get_parameter(local_name + "window_overlap", window_overlap);
+    nav2_util::declare_parameter_if_not_declared(
+      node, local_name + "num_threads", rclcpp::ParameterValue(1));
+    node->get_parameter(local_name + "num_threads", num_threads);
 
     advanced.get(node, name);
   }
@@ -199,6 +211,10 @@ struct OptimizerParams
   double fn_tol;  // Ceres default: 1e-6
   double gradient_tol;  // Ceres default: 1e-10
 
+  int window_size;  // Points per window when smoothing in windows, 0 for the whole path
+  int window_overlap;  // Points shared by consecutive windows
+  int num_threads;  // Threads to smooth windows with
+
   AdvancedParams advanced;
 };
 
@@ -15,6 +15,7 @@
 #ifndef NAV2_SMAC_PLANNER__SMAC_PLANNER_HPP_
 #define NAV2_SMAC_PLANNER__SMAC_PLANNER_HPP_
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <string>
@@ -75,6 +76,12 @@ public:
    */
   void deactivate() override;
 
+  /**
+   * @brief Request that an ongoing search stops, or clear the request
+   * @param cancel Whether to cancel
+   */
+  void cancelPlanning(const bool & cancel) override;
+
   /**
    * @brief Creating a plan from start and goal poses
    * @param start Start pose
@@ -85,6 +92,38 @@ public:
     const geometry_msgs::msg::PoseStamped & start,
     const geometry_msgs::msg::PoseStamped & goal) override;
 
+  /**
+   * @brief Plan on a coarser, downsampled costmap to find the corridor of the costmap
+   * the full resolution search is restricted to
+   * @param start_mx X coordinate of the start in costmap
+   * @param start_my Y coordinate of the start in costmap
+   * @param goal_mx X coordinate of the goal in costmap
+   * @param goal_my Y coordinate of the goal in costmap
+   * @param costmap Costmap the full resolution search is planned on
+   * @param corridor Whether each cell of costmap is within the corridor, in row-major order
+   * @return if a coarse path was found
+   */
+  bool getSearchCorridor(
+    const unsigned int & start_mx, const unsigned int & start_my,
+    const unsigned int & goal_mx, const unsigned int & goal_my,
+    nav2_costmap_2d::Costmap2D * costmap,
+    std::vector<bool> & corridor);
+
+  /**
+   * @brief Reuse the previous plan if to the same goal, reconnecting the start to it,
+   * if it is still valid on the costmap
+   * @param start Start pose
+   * @param goal Goal position in world coordinates and orientation bin
+   * @param costmap Costmap to validate the plan on
+   * @param path Path to set, in the order and coordinates of AStarAlgorithm::createPath
+   * @return if the previous plan could be reused
+   */
+  bool repairPlan(
+    const geometry_msgs::msg::PoseStamped & start,
+    const Eigen::Vector3d & goal,
+    nav2_costmap_2d::Costmap2D * costmap,
+    NodeSE2::CoordinateVector & path);
+
   /**
    * @brief Create an Eigen Vector2D of world poses from continuous map coords
    * @param mx float of map X coordinate
@@ -110,11 +149,17 @@ public:
 
 protected:
   std::unique_ptr<AStarAlgorithm<NodeSE2>> _a_star;
+  std::unique_ptr<AStarAlgorithm<Node2D>> _coarse_a_star;
   std::unique_ptr<Smoother> _smoother;
   rclcpp::Clock::SharedPtr _clock;
   rclcpp::Logger _logger{rclcpp::get_logger("SmacPlanner")};
   nav2_costmap_2d::Costmap2D * _costmap;
+  // Copy of the costmap searched, so its lock is only held while copying
+  nav2_costmap_2d::Costmap2D _costmap_snapshot;
   std::unique_ptr<CostmapDownsampler> _costmap_downsampler;
+  std::unique_ptr<CostmapDownsampler> _coarse_costmap_downsampler;
+  int _coarse_downsampling_factor;
+  double _corridor_radius;
   std::string _global_frame, _name;
   float _tolerance;
   int _downsampling_factor;
@@ -125,6 +170,13 @@ protected:
   SmootherParams _smoother_params;
   OptimizerParams _optimizer_params;
   double _max_planning_time;
+  bool _allow_partial_path;
+  std::shared_ptr<std::atomic<bool>> _cancel_requested;
+  bool _use_plan_repair;
+  double _plan_repair_max_deviation;
+  std::vector<Eigen::Vector3d> _previous_path;
+  NodeSE2::CoordinateVector _previous_path_coords;
+  Eigen::Vector3d _previous_goal;
 };
 
 }  // namespace nav2_smac_planner
@@ -15,6 +15,7 @@
 #ifndef NAV2_SMAC_PLANNER__SMAC_PLANNER_2D_HPP_
 #define NAV2_SMAC_PLANNER__SMAC_PLANNER_2D_HPP_
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <string>
@@ -75,6 +76,12 @@ public:
    */
   void deactivate() override;
 
+  /**
+   * @brief Request that an ongoing search stops, or clear the request
+   * @param cancel Whether to cancel
+   */
+  void cancelPlanning(const bool & cancel) override;
+
   /**
    * @brief Creating a plan from start and goal poses
    * @param start Start pose
@@ -85,6 +92,18 @@ public:
     const geometry_msgs::msg::PoseStamped & start,
     const geometry_msgs::msg::PoseStamped & goal) override;
 
+  /**
+   * @brief Creating plans from a start pose to each of many goal poses, with a single search
+   * @param start Start pose
+   * @param goals Goal poses
+   * @param costs Search cost of each plan to set, -1 if there is none
+   * @return nav2_msgs::Path to each goal, empty if there is none
+   */
+  std::vector<nav_msgs::msg::Path> createPlans(
+    const geometry_msgs::msg::PoseStamped & start,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    std::vector<double> & costs) override;
+
   /**
    * @brief Create an Eigen Vector2D of world poses from continuous map coords
    * @param mx float of map X coordinate
@@ -102,9 +121,24 @@ public:
   void removeHook(std::vector<Eigen::Vector2d> & path);
 
 protected:
+  /**
+   * @brief Convert a path searched on the costmap to a plan in world coordinates,
+   * smoothing it if enabled and time remains
+   * @param path Path in map coordinates, ordered from the goal
+   * @param costmap Costmap the path was searched on
+   * @param max_smoothing_time Time the path may be smoothed for
+   * @return nav2_msgs::Path of the plan
+   */
+  nav_msgs::msg::Path createPlanFromPath(
+    const Node2D::CoordinateVector & path,
+    nav2_costmap_2d::Costmap2D * costmap,
+    const double & max_smoothing_time);
+
   std::unique_ptr<AStarAlgorithm<Node2D>> _a_star;
   std::unique_ptr<Smoother> _smoother;
   nav2_costmap_2d::Costmap2D * _costmap;
+  // Copy of the costmap searched, so its lock is only held while copying
+  nav2_costmap_2d::Costmap2D _costmap_snapshot;
   std::unique_ptr<CostmapDownsampler> _costmap_downsampler;
   rclcpp::Clock::SharedPtr _clock;
   rclcpp::Logger _logger{rclcpp::get_logger("SmacPlanner2D")};
@@ -116,6 +150,8 @@ protected:
   SmootherParams _smoother_params;
   OptimizerParams _optimizer_params;
   double _max_planning_time;
+  bool _allow_partial_path;
+  std::shared_ptr<std::atomic<bool>> _cancel_requested;
 };
 
 }  // namespace nav2_smac_planner
@@ -21,9 +21,11 @@
 #include <memory>
 #include <queue>
 #include <utility>
+#include <algorithm>
 
 #include "nav2_smac_planner/types.hpp"
 #include "nav2_smac_planner/smoother_cost_function.hpp"
+#include "nav2_smac_planner/distance_field.hpp"
 
 #include "ceres/ceres.h"
 #include "Eigen/Core"
@@ -55,6 +57,9 @@ public:
   void initialize(const OptimizerParams params)
   {
     _debug = params.debug;
+    _window_size = params.window_size > 0 ? std::max(params.window_size, 4) : 0;
+    _window_overlap = std::min(std::max(params.window_overlap, 2), _window_size / 2);
+    _num_threads = std::max(params.num_threads, 1);
 
     // General Params
 
@@ -105,17 +110,64 @@ public:
   {
     _options.max_solver_time_in_seconds = params.max_time;
 
-    double parameters[path.size() * 2];  // NOLINT
-    for (uint i = 0; i != path.size(); i++) {
-      parameters[2 * i] = path[i][0];
-      parameters[2 * i + 1] = path[i][1];
+    if (params.costmap_weight > 0.0) {
+      updateDistanceField(path, costmap, params);
+    }
+
+    if (_window_buffers.empty()) {
+      _window_buffers.resize(1);
+    }
+
+    if (_window_size == 0 || path.size() <= static_cast<unsigned int>(_window_size)) {
+      return smoothSegment(path, 0, path.size(), params, _options, _window_buffers[0]);
+    }
+
+    return smoothWindowed(path, params);
+  }
+
+private:
+  /**
+   * @struct nav2_smac_planner::Smoother::WindowBuffers
+   * @brief Memory reused between calls to optimize a window of the path
+   */
+  struct WindowBuffers
+  {
+    std::vector<Eigen::Vector2d> original_path;
+    std::vector<double> parameters;
+  };
+
+  /**
+   * @brief Smooth a segment of the path, keeping its first and last points fixed
+   * @param path Reference to path
+   * @param start Index of first point of segment
+   * @param end Index past the last point of segment
+   * @param params Smoother parameters
+   * @param options Solver options to use
+   * @param buffers Memory to use for the optimization
+   * @return If smoothing was successful
+   */
+  bool smoothSegment(
+    std::vector<Eigen::Vector2d> & path,
+    const unsigned int & start,
+    const unsigned int & end,
+    const SmootherParams & params,
+    const ceres::GradientProblemSolver::Options & options,
+    WindowBuffers & buffers)
+  {
+    buffers.original_path.assign(path.begin() + start, path.begin() + end);
+    buffers.parameters.resize(2 * buffers.original_path.size());
+    for (unsigned int i = 0; i != buffers.original_path.size(); i++) {
+      buffers.parameters[2 * i] = buffers.original_path[i][0];
+      buffers.parameters[2 * i + 1] = buffers.original_path[i][1];
     }
 
     ceres::GradientProblemSolver::Summary summary;
-    ceres::GradientProblem problem(new UnconstrainedSmootherCostFunction(&path, costmap, params));
-    ceres::Solve(_options, problem, parameters, &summary);
+    ceres::GradientProblem problem(
+      new UnconstrainedSmootherCostFunction(&buffers.original_path, &_distance_field, params));
+    ceres::Solve(options, problem, buffers.parameters.data(), &summary);
 
     if (_debug) {
+      #pragma omp critical
       std::cout << summary.FullReport() << '\n';
     }
 
@@ -123,17 +175,103 @@ public:
       return false;
     }
 
-    for (uint i = 0; i != path.size(); i++) {
-      path[i][0] = parameters[2 * i];
-      path[i][1] = parameters[2 * i + 1];
+    for (unsigned int i = 0; i != buffers.original_path.size(); i++) {
+      path[start + i][0] = buffers.parameters[2 * i];
+      path[start + i][1] = buffers.parameters[2 * i + 1];
     }
 
     return true;
   }
 
-private:
+  /**
+   * @brief Smooth the path in windows of a fixed size overlapping their neighbors. Even
+   * windows are smoothed first, then odd windows which smooth over the fixed endpoints of
+   * the even windows. Windows of the same parity do not overlap so may be smoothed in
+   * parallel.
+   * @param path Reference to path
+   * @param params Smoother parameters
+   * @return If smoothing of any window was successful
+   */
+  bool smoothWindowed(std::vector<Eigen::Vector2d> & path, const SmootherParams & params)
+  {
+    const int path_size = static_cast<int>(path.size());
+    const int stride = _window_size - _window_overlap;
+    const int num_windows = (path_size - _window_size + stride - 1) / stride + 1;
+    if (static_cast<int>(_window_buffers.size()) < num_windows) {
+      _window_buffers.resize(num_windows);
+    }
+
+    // Share the time allowed between the rounds of windows each thread will smooth
+    const int num_even = (num_windows + 1) / 2;
+    const int num_odd = num_windows / 2;
+    const int num_rounds =
+      (num_even + _num_threads - 1) / _num_threads + (num_odd + _num_threads - 1) / _num_threads;
+    ceres::GradientProblemSolver::Options window_options = _options;
+    window_options.max_solver_time_in_seconds = params.max_time / num_rounds;
+
+    int num_smoothed = 0;
+    for (int parity = 0; parity != 2; parity++) {
+      #pragma omp parallel for num_threads(_num_threads) schedule(dynamic) \
+      reduction(+:num_smoothed)
+      for (int window = parity; window < num_windows; window += 2) {
+        const int start = window * stride;
+        const int end = std::min(start + _window_size, path_size);
+        if (end - start > 2 &&
+          smoothSegment(path, start, end, params, window_options, _window_buffers[window]))
+        {
+          num_smoothed++;
+        }
+      }
+    }
+
+    return num_smoothed > 0;
+  }
+
+  /**
+   * @brief Compute the distance field over the region of the costmap the path may be
+   * smoothed within: its bounds, padded by twice the distance at which costs decay to free
+   * @param path Reference to path
+   * @param costmap Pointer to minimal costmap
+   * @param params Smoother parameters
+   */
+  void updateDistanceField(
+    const std::vector<Eigen::Vector2d> & path,
+    nav2_costmap_2d::Costmap2D * costmap,
+    const SmootherParams & params)
+  {
+    const int size_x = static_cast<int>(costmap->getSizeInCellsX());
+    const int size_y = static_cast<int>(costmap->getSizeInCellsY());
+    if (params.costmap_factor <= 0.0) {
+      _distance_field.update(costmap, 0, 0, size_x, size_y);
+      return;
+    }
+
+    int min_x = size_x, min_y = size_y, max_x = 0, max_y = 0;
+    int mx, my;
+    for (const auto & pt : path) {
+      costmap->worldToMapNoBounds(pt[0], pt[1], mx, my);
+      min_x = std::min(min_x, mx);
+      min_y = std::min(min_y, my);
+      max_x = std::max(max_x, mx + 1);
+      max_y = std::max(max_y, my + 1);
+    }
+
+    const int padding = static_cast<int>(std::ceil(
+        2.0 * std::log(INSCRIBED - 1.0) / params.costmap_factor / costmap->getResolution()));
+    _distance_field.update(
+      costmap,
+      std::max(min_x - padding, 0), std::max(min_y - padding, 0),
+      std::min(std::max(max_x + padding, 0), size_x),
+      std::min(std::max(max_y + padding, 0), size_y));
+  }
+
   bool _debug;
+  int _window_size{0};
+  int _window_overlap{0};
+  int _num_threads{1};
+  std::vector<WindowBuffers> _window_buffers;
   ceres::GradientProblemSolver::Options _options;
+  EuclideanDistanceField _distance_field;
 };
 
 }  // namespace nav2_smac_planner
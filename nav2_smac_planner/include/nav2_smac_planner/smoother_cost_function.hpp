@@ -26,8 +26,8 @@
 #include "ceres/ceres.h"
 #include "Eigen/Core"
 #include "nav2_smac_planner/types.hpp"
-#include "nav2_costmap_2d/costmap_2d.hpp"
 #include "nav2_smac_planner/options.hpp"
+#include "nav2_smac_planner/distance_field.hpp"
 
 #define EPSILON 0.0001
 
@@ -45,15 +45,15 @@ public:
   /**
    * @brief A constructor for nav2_smac_planner::UnconstrainedSmootherCostFunction
    * @param original_path Original unsmoothed path to smooth
-   * @param costmap A costmap to get values for collision and obstacle avoidance
+   * @param distance_field A distance field of the costmap for collision and obstacle avoidance
    */
   UnconstrainedSmootherCostFunction(
     std::vector<Eigen::Vector2d> * original_path,
-    nav2_costmap_2d::Costmap2D * costmap,
+    const EuclideanDistanceField * distance_field,
     const SmootherParams & params)
   : _original_path(original_path),
     _num_params(2 * original_path->size()),
-    _costmap(costmap),
+    _distance_field(distance_field),
     _params(params)
   {
   }
@@ -111,9 +111,11 @@ public:
     double cost_raw = 0.0;
     double grad_x_raw = 0.0;
     double grad_y_raw = 0.0;
-    unsigned int mx, my;
     bool valid_coords = true;
+    double distance = 0.0;
     double costmap_cost = 0.0;
+    double costmap_cost_derivative = 0.0;
+    Eigen::Vector2d distance_gradient;
 
     // cache some computations between the residual and jacobian
     CurvatureComputations curvature_params;
@@ -136,8 +138,10 @@ public:
       addCurvatureResidual(_params.curvature_weight, xi, xi_p1, xi_m1, curvature_params, cost_raw);
       addDistanceResidual(_params.distance_weight, xi, _original_path->at(i), cost_raw);
 
-      if (valid_coords = _costmap->worldToMap(xi[0], xi[1], mx, my)) {
-        costmap_cost = _costmap->getCost(mx, my);
+      valid_coords = _params.costmap_weight > 0.0 &&
+        _distance_field->getDistance(xi[0], xi[1], distance, distance_gradient);
+      if (valid_coords) {
+        getDistanceCost(distance, costmap_cost, costmap_cost_derivative);
         addCostResidual(_params.costmap_weight, costmap_cost, cost_raw);
       }
 
@@ -154,7 +158,9 @@ public:
             i), grad_x_raw, grad_y_raw);
 
         if (valid_coords) {
-          addCostJacobian(_params.costmap_weight, mx, my, costmap_cost, grad_x_raw, grad_y_raw);
+          addCostJacobian(
+            _params.costmap_weight, costmap_cost, costmap_cost_derivative * distance_gradient,
+            grad_x_raw, grad_y_raw);
         }
 
         gradient[x_index] = grad_x_raw;
@@ -369,11 +375,33 @@ protected:
   }
 
 
+  /**
+   * @brief Cost of a distance from obstacles, following the inflation layer's exponential
+   * decay of cost_scaling_factor away from inscribed cells. Inside them it continues
+   * linearly so that it remains smooth without growing without bound.
+   * @param distance Signed distance in meters from the nearest inscribed cell
+   * @param value Cost to set
+   * @param derivative Derivative of cost with respect to distance to set
+   */
+  inline void getDistanceCost(
+    const double & distance,
+    double & value,
+    double & derivative) const
+  {
+    const double max_cost = INSCRIBED - 1.0;
+    if (distance > 0.0) {
+      value = max_cost * std::exp(-_params.costmap_factor * distance);
+      derivative = -_params.costmap_factor * value;
+    } else {
+      derivative = -_params.costmap_factor * max_cost;
+      value = max_cost + derivative * distance;
+    }
+  }
+
   /**
    * @brief Cost function term for steering away from costs
    * @param weight Weight to apply to function
    * @param value Point Xi's cost'
-   * @param params computed values to reduce overhead
    * @param r Residual (cost) of term
    */
   inline void addCostResidual(
@@ -381,110 +409,28 @@ protected:
     const double & value,
     double & r) const
   {
-    if (value == FREE) {
-      return;
-    }
-
     r += weight * value * value;  // objective function value
   }
 
   /**
    * @brief Cost function derivative term for steering away from costs
    * @param weight Weight to apply to function
-   * @param mx Point Xi's x coordinate in map frame
-   * @param mx Point Xi's y coordinate in map frame
    * @param value Point Xi's cost'
-   * @param params computed values to reduce overhead
+   * @param value_gradient Gradient of Point Xi's cost with respect to its position
    * @param j0 Gradient of X term
    * @param j1 Gradient of Y term
    */
   inline void addCostJacobian(
     const double & weight,
-    const unsigned int & mx,
-    const unsigned int & my,
     const double & value,
+    const Eigen::Vector2d & value_gradient,
     double & j0,
     double & j1) const
   {
-    if (value == FREE) {
-      return;
-    }
-
-    const Eigen::Vector2d grad = getCostmapGradient(mx, my);
-    const double common_prefix = -2.0 * _params.costmap_factor * weight * value * value;
-
-    j0 += common_prefix * grad[0];  // xi x component of partial-derivative
-    j1 += common_prefix * grad[1];  // xi y component of partial-derivative
-  }
-
-  /**
-   * @brief Computing the gradient of the costmap using
-   * the 2 point numerical differentiation method
-   * @param mx Point Xi's x coordinate in map frame
-   * @param mx Point Xi's y coordinate in map frame
-   * @param params Params reference to store gradients
-   */
-  inline Eigen::Vector2d getCostmapGradient(
-    const unsigned int mx,
-    const unsigned int my) const
-  {
-    // find unit vector that describes that direction
-    // via 7 point taylor series approximation for gradient at Xi
-    Eigen::Vector2d gradient;
-
-    double l_1 = 0.0;
-    double l_2 = 0.0;
-    double l_3 = 0.0;
-    double r_1 = 0.0;
-    double r_2 = 0.0;
-    double r_3 = 0.0;
-
-    if (mx < _costmap->getSizeInCellsX()) {
-      r_1 = static_cast<double>(_costmap->getCost(mx + 1, my));
-    }
-    if (mx + 1 < _costmap->getSizeInCellsX()) {
-      r_2 = static_cast<double>(_costmap->getCost(mx + 2, my));
-    }
-    if (mx + 2 < _costmap->getSizeInCellsX()) {
-      r_3 = static_cast<double>(_costmap->getCost(mx + 3, my));
-    }
-
-    if (mx > 0) {
-      l_1 = static_cast<double>(_costmap->getCost(mx - 1, my));
-    }
-    if (mx - 1 > 0) {
-      l_2 = static_cast<double>(_costmap->getCost(mx - 2, my));
-    }
-    if (mx - 2 > 0) {
-      l_3 = static_cast<double>(_costmap->getCost(mx - 3, my));
-    }
-
-    gradient[1] = (45 * r_1 - 9 * r_2 + r_3 - 45 * l_1 + 9 * l_2 - l_3) / 60;
-
-    if (my < _costmap->getSizeInCellsY()) {
-      r_1 = static_cast<double>(_costmap->getCost(mx, my + 1));
-    }
-    if (my + 1 < _costmap->getSizeInCellsY()) {
-      r_2 = static_cast<double>(_costmap->getCost(mx, my + 2));
-    }
-    if (my + 2 < _costmap->getSizeInCellsY()) {
-      r_3 = static_cast<double>(_costmap->getCost(mx, my + 3));
-    }
-
-    if (my > 0) {
-      l_1 = static_cast<double>(_costmap->getCost(mx, my - 1));
-    }
-    if (my - 1 > 0) {
-      l_2 = static_cast<double>(_costmap->getCost(mx, my - 2));
-    }
-    if (my - 2 > 0) {
-      l_3 = static_cast<double>(_costmap->getCost(mx, my - 3));
-    }
-
-    gradient[0] = (45 * r_1 - 9 * r_2 + r_3 - 45 * l_1 + 9 * l_2 - l_3) / 60;
+    const double common_prefix = 2.0 * weight * value;
 
-    gradient.normalize();
-    return gradient;
+    j0 += common_prefix * value_gradient[0];  // xi x component of partial-derivative
+    j1 += common_prefix * value_gradient[1];  // xi y component of partial-derivative
   }
 
   /**
@@ -506,7 +452,7 @@ protected:
 
   std::vector<Eigen::Vector2d> * _original_path{nullptr};
   int _num_params;
-  nav2_costmap_2d::Costmap2D * _costmap{nullptr};
+  const EuclideanDistanceField * _distance_field{nullptr};
   SmootherParams _params;
 };
 
@@ -35,6 +35,10 @@ struct SearchInfo
   float reverse_penalty;
   float cost_penalty;
   float analytic_expansion_ratio;
+  float lookup_table_size = 0.0f;
+  bool cache_wavefront_heuristic = false;
+  int num_expansion_threads = 1;
+  bool use_footprint_masks = false;
 };
 
 }  // namespace nav2_smac_planner
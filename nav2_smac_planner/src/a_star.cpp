@@ -48,6 +48,19 @@ AStarAlgorithm<NodeT>::AStarAlgorithm(
   _goal_coordinates(Coordinates()),
   _start(nullptr),
   _goal(nullptr),
+  _use_node_pool(false),
+  _use_indexed_heap(false),
+  _peak_queue_size(0),
+  _search_mode(SearchMode::ASTAR),
+  _heuristic_weight(1.0f),
+  _anytime_initial_weight(1.0f),
+  _anytime_weight_decrement(0.0f),
+  _anytime_max_time(0.0),
+  _deadline(steady_clock::time_point::max()),
+  _planning_deadline(steady_clock::time_point::max()),
+  _max_planning_time(0.0),
+  _cancel_requested(nullptr),
+  _is_path_partial(false),
   _motion_model(motion_model),
   _collision_checker(nullptr)
 {
@@ -63,11 +76,39 @@ template<typename NodeT>
 void AStarAlgorithm<NodeT>::initialize(
   const bool & allow_unknown,
   int & max_iterations,
-  const int & max_on_approach_iterations)
+  const int & max_on_approach_iterations,
+  const bool & use_node_pool,
+  const bool & use_indexed_heap)
 {
   _traverse_unknown = allow_unknown;
   _max_iterations = max_iterations;
   _max_on_approach_iterations = max_on_approach_iterations;
+  _use_node_pool = use_node_pool;
+  _use_indexed_heap = use_indexed_heap;
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::setSearchMode(
+  const SearchMode & search_mode,
+  const float & anytime_initial_weight,
+  const float & anytime_weight_decrement,
+  const double & anytime_max_time)
+{
+  _search_mode = search_mode;
+  _anytime_initial_weight = std::max(anytime_initial_weight, 1.0f);
+  // A non-positive decrement would repeat the same search, improve straight to A* instead
+  _anytime_weight_decrement = anytime_weight_decrement > 0.0f ?
+    anytime_weight_decrement : _anytime_initial_weight;
+  _anytime_max_time = anytime_max_time;
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::setPlanningLimits(
+  const double & max_planning_time,
+  std::shared_ptr<std::atomic<bool>> cancel_requested)
+{
+  _max_planning_time = max_planning_time;
+  _cancel_requested = cancel_requested;
 }
 
 template<>
@@ -82,7 +123,12 @@ void AStarAlgorithm<Node2D>::createGraph(
   }
   _costmap = costmap;
   _dim3_size = dim_3_size;  // 2D search MUST be 2D, not 3D or SE2.
+  // Queued nodes must be released before resizing frees the pool pages they point into
   clearGraph();
+  if (_use_node_pool) {
+    _node_pool.resize(x_size * y_size);
+  }
+  _search_corridor.clear();
 
   if (getSizeX() != x_size || getSizeY() != y_size) {
     _x_size = x_size;
@@ -99,12 +145,17 @@ void AStarAlgorithm<NodeSE2>::createGraph(
   nav2_costmap_2d::Costmap2D * & costmap)
 {
   _costmap = costmap;
-  _collision_checker = GridCollisionChecker(costmap);
+  _collision_checker = GridCollisionChecker(
+    costmap, _search_info.use_footprint_masks ? dim_3_size : 0);
   _collision_checker.setFootprint(_footprint, _is_radius_footprint);
 
   _dim3_size = dim_3_size;
-  unsigned int index;
+  // Queued nodes must be released before resizing frees the pool pages they point into
   clearGraph();
+  if (_use_node_pool) {
+    _node_pool.resize(x_size * y_size * dim_3_size);
+  }
+  _search_corridor.clear();
 
   if (getSizeX() != x_size || getSizeY() != y_size) {
     _x_size = x_size;
@@ -124,6 +175,9 @@ template<>
 typename AStarAlgorithm<Node2D>::NodePtr AStarAlgorithm<Node2D>::addToGraph(
   const unsigned int & index)
 {
+  if (_use_node_pool) {
+    return _node_pool.emplace(index, _costmap->getCharMap()[index], index);
+  }
   return &(_graph.emplace(index, Node2D(_costmap->getCharMap()[index], index)).first->second);
 }
 
@@ -131,9 +185,22 @@ template<>
 typename AStarAlgorithm<NodeSE2>::NodePtr AStarAlgorithm<NodeSE2>::addToGraph(
   const unsigned int & index)
 {
+  if (_use_node_pool) {
+    return _node_pool.emplace(index, index);
+  }
   return &(_graph.emplace(index, NodeSE2(index)).first->second);
 }
 
+template<typename NodeT>
+typename AStarAlgorithm<NodeT>::NodePtr AStarAlgorithm<NodeT>::getFromGraph(
+  const unsigned int & index)
+{
+  if (_use_node_pool) {
+    return _node_pool.at(index);
+  }
+  return &_graph.at(index);
+}
+
 template<>
 void AStarAlgorithm<Node2D>::setStart(
   const unsigned int & mx,
@@ -144,6 +211,10 @@ void AStarAlgorithm<Node2D>::setStart(
     throw std::runtime_error("Node type Node2D cannot be given non-zero starting dim 3.");
   }
   _start = addToGraph(Node2D::getIndex(mx, my, getSizeX()));
+  if (!_start) {
+    throw std::runtime_error(
+            "Node type Node2D cannot be given a starting pose outside of the map.");
+  }
 }
 
 template<>
@@ -153,6 +224,10 @@ void AStarAlgorithm<NodeSE2>::setStart(
   const unsigned int & dim_3)
 {
   _start = addToGraph(NodeSE2::getIndex(mx, my, dim_3, getSizeX(), getSizeDim3()));
+  if (!_start) {
+    throw std::runtime_error(
+            "Node type NodeSE2 cannot be given a starting pose outside of the map.");
+  }
   _start->setPose(
     Coordinates(
       static_cast<float>(mx),
@@ -171,6 +246,9 @@ void AStarAlgorithm<Node2D>::setGoal(
   }
 
   _goal = addToGraph(Node2D::getIndex(mx, my, getSizeX()));
+  if (!_goal) {
+    throw std::runtime_error("Node type Node2D cannot be given a goal pose outside of the map.");
+  }
   _goal_coordinates = Node2D::Coordinates(mx, my);
 }
 
@@ -181,6 +259,9 @@ void AStarAlgorithm<NodeSE2>::setGoal(
   const unsigned int & dim_3)
 {
   _goal = addToGraph(NodeSE2::getIndex(mx, my, dim_3, getSizeX(), getSizeDim3()));
+  if (!_goal) {
+    throw std::runtime_error("Node type NodeSE2 cannot be given a goal pose outside of the map.");
+  }
   _goal_coordinates = NodeSE2::Coordinates(
     static_cast<float>(mx),
     static_cast<float>(my),
@@ -191,14 +272,14 @@ void AStarAlgorithm<NodeSE2>::setGoal(
     _costmap,
     static_cast<unsigned int>(getStart()->pose.x),
     static_cast<unsigned int>(getStart()->pose.y),
-    mx, my);
+    mx, my, _search_info.cache_wavefront_heuristic);
 }
 
 template<typename NodeT>
 bool AStarAlgorithm<NodeT>::areInputsValid()
 {
   // Check if graph was filled in
-  if (_graph.empty()) {
+  if (_use_node_pool ? _node_pool.empty() : _graph.empty()) {
     throw std::runtime_error("Failed to compute path, no costmap given.");
   }
 
@@ -222,6 +303,16 @@ bool AStarAlgorithm<NodeT>::areInputsValid()
   return true;
 }
 
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::setSearchCorridor(const std::vector<bool> & corridor)
+{
+  if (!corridor.empty() && corridor.size() != getSizeX() * getSizeY()) {
+    throw std::runtime_error("Search corridor must be the size of the graph.");
+  }
+
+  _search_corridor = corridor;
+}
+
 template<typename NodeT>
 bool AStarAlgorithm<NodeT>::createPath(
   CoordinateVector & path, int & iterations,
@@ -229,16 +320,45 @@ bool AStarAlgorithm<NodeT>::createPath(
 {
   _tolerance = tolerance * NodeT::neutral_cost;
   _best_heuristic_node = {std::numeric_limits<float>::max(), 0};
+  _is_path_partial = false;
+  _planning_deadline = _max_planning_time > 0.0 ?
+    steady_clock::now() + duration_cast<steady_clock::duration>(
+    duration<double>(_max_planning_time)) :
+    steady_clock::time_point::max();
+  _deadline = _planning_deadline;
   clearQueue();
 
   if (!areInputsValid()) {
     return false;
   }
 
+  if (_search_mode == SearchMode::BIDIRECTIONAL) {
+    return createPathBidirectional(path, iterations);
+  }
+
+  _heuristic_weight = _search_mode == SearchMode::ANYTIME ? _anytime_initial_weight : 1.0f;
+  _reached_nodes.clear();
+
   // 0) Add starting point to the open set
   addNode(0.0, getStart());
   getStart()->setAccumulatedCost(0.0);
 
+  float path_cost = 0.0f;
+  if (!search(path, iterations, path_cost)) {
+    return getPartialPath(path);
+  }
+
+  if (_search_mode == SearchMode::ANYTIME) {
+    improvePath(path, path_cost, iterations);
+  }
+
+  return true;
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::search(
+  CoordinateVector & path, int & iterations, float & path_cost)
+{
   // Optimization: preallocate all variables
   NodePtr current_node = nullptr;
   NodePtr neighbor = nullptr;
@@ -248,13 +368,14 @@ bool AStarAlgorithm<NodeT>::createPath(
   NeighborIterator neighbor_iterator;
   int analytic_iterations = 0;
   int closest_distance = std::numeric_limits<int>::max();
+  const bool track_reached_nodes = _search_mode == SearchMode::ANYTIME;
 
   // Given an index, return a node ptr reference if its collision-free and valid
   const unsigned int max_index = getSizeX() * getSizeY() * getSizeDim3();
-  NodeGetter neighborGetter =
+  auto neighborGetter =
     [&, this](const unsigned int & index, NodePtr & neighbor_rtn) -> bool
     {
-      if (index < 0 || index >= max_index) {
+      if (index < 0 || index >= max_index || !isInSearchCorridor(index)) {
         return false;
       }
 
@@ -262,25 +383,34 @@ bool AStarAlgorithm<NodeT>::createPath(
       return true;
     };
 
-  while (iterations < getMaxIterations() && !_queue.empty()) {
+  // Neighbor expansion takes the getter as a template argument so it can be inlined,
+  // analytic expansion is rare enough to go through a type-erased copy made once here
+  const NodeGetter analytic_getter(neighborGetter);
+
+  while (iterations < getMaxIterations() && !isQueueEmpty()) {
     // 1) Pick Nbest from O s.t. min(f(Nbest)), remove from queue
     current_node = getNextNode();
 
     // We allow for nodes to be queued multiple times in case
-    // shorter paths result in it, but we can visit only once
+    // shorter paths result in it, but we can visit only once.
+    // The indexed heap instead updates the queued entry in place.
     if (current_node->wasVisited()) {
       continue;
     }
 
     iterations++;
 
+    if (isSearchInterrupted(iterations)) {
+      return false;
+    }
+
     // 2) Mark Nbest as visited
     current_node->visited();
 
     // 2.a) Use an analytic expansion (if available) to generate a path
     // to the goal.
     NodePtr result = tryAnalyticExpansion(
-      current_node, neighborGetter, analytic_iterations,
+      current_node, analytic_getter, analytic_iterations,
       closest_distance);
     if (result != nullptr) {
       current_node = result;
@@ -288,6 +418,7 @@ bool AStarAlgorithm<NodeT>::createPath(
 
     // 3) Check if we're at the goal, backtrace if required
     if (isGoal(current_node)) {
+      path_cost = getAccumulatedCost(current_node);
       return backtracePath(current_node, path);
     } else if (_best_heuristic_node.first < getToleranceHeuristic()) {
       // Optimization: Let us find when in tolerance and refine within reason
@@ -295,7 +426,8 @@ bool AStarAlgorithm<NodeT>::createPath(
       if (approach_iterations > getOnApproachMaxIterations() ||
         iterations + 1 == getMaxIterations())
       {
-        NodePtr node = &_graph.at(_best_heuristic_node.second);
+        NodePtr node = getFromGraph(_best_heuristic_node.second);
+        path_cost = getAccumulatedCost(node);
         return backtracePath(node, path);
       }
     }
@@ -303,7 +435,8 @@ bool AStarAlgorithm<NodeT>::createPath(
     // 4) Expand neighbors of Nbest not visited
     neighbors.clear();
     NodeT::getNeighbors(
-      current_node, neighborGetter, _collision_checker, _traverse_unknown, neighbors);
+      current_node, neighborGetter, _collision_checker, _traverse_unknown, neighbors,
+      _expansion_scratch);
 
     for (neighbor_iterator = neighbors.begin();
       neighbor_iterator != neighbors.end(); ++neighbor_iterator)
@@ -315,12 +448,17 @@ bool AStarAlgorithm<NodeT>::createPath(
 
       // 4.2) If this is a lower cost than prior, we set this as the new cost and new approach
       if (g_cost < getAccumulatedCost(neighbor)) {
+        if (track_reached_nodes &&
+          getAccumulatedCost(neighbor) == std::numeric_limits<float>::max())
+        {
+          _reached_nodes.push_back(neighbor);
+        }
         neighbor->setAccumulatedCost(g_cost);
         neighbor->parent = current_node;
 
         // 4.3) If not in queue or visited, add it, `getNeighbors()` handles
         neighbor->queued();
-        addNode(g_cost + getHeuristicCost(neighbor), neighbor);
+        addNode(g_cost + _heuristic_weight * getHeuristicCost(neighbor), neighbor);
       }
     }
   }
@@ -328,12 +466,417 @@ bool AStarAlgorithm<NodeT>::createPath(
   return false;
 }
 
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::improvePath(
+  CoordinateVector & path, float & path_cost, int & iterations)
+{
+  _deadline = std::min(
+    steady_clock::now() +
+    duration_cast<steady_clock::duration>(duration<double>(_anytime_max_time)),
+    _planning_deadline);
+  CoordinateVector improved_path;
+  float improved_path_cost = 0.0f;
+
+  while (_heuristic_weight > 1.0f && iterations < getMaxIterations() &&
+    steady_clock::now() < _deadline)
+  {
+    _heuristic_weight = std::max(_heuristic_weight - _anytime_weight_decrement, 1.0f);
+
+    // Reopen all nodes reached so far with the new weight. Their costs and parents are
+    // kept, so only parts of the graph where the lower weight finds cheaper paths are
+    // expanded further, as in ARA*.
+    clearQueue();
+    getStart()->wasVisited() = false;
+    addNode(0.0, getStart());
+    getGoal()->wasVisited() = false;
+    for (auto & node : _reached_nodes) {
+      node->wasVisited() = false;
+      if (getAccumulatedCost(node) < std::numeric_limits<float>::max()) {
+        node->queued();
+        addNode(getAccumulatedCost(node) + _heuristic_weight * getHeuristicCost(node), node);
+      }
+    }
+
+    // If out of time or iterations, keep the best path found so far. An analytic expansion
+    // may reach the goal at a higher cost than before, so only take cheaper paths.
+    improved_path.clear();
+    if (!search(improved_path, iterations, improved_path_cost)) {
+      break;
+    }
+    if (improved_path_cost < path_cost) {
+      path.swap(improved_path);
+      path_cost = improved_path_cost;
+    }
+  }
+
+  _deadline = _planning_deadline;
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::createPathBidirectional(
+  CoordinateVector & /*path*/, int & /*iterations*/)
+{
+  throw std::runtime_error("Bidirectional search is only supported by Node2D.");
+}
+
+template<>
+bool AStarAlgorithm<Node2D>::createPathBidirectional(
+  CoordinateVector & path, int & iterations)
+{
+  _heuristic_weight = 1.0f;
+
+  addNode(0.0, getStart());
+  getStart()->setAccumulatedCost(0.0);
+
+  // Can only search backwards from a valid goal, else search forward to within tolerance
+  if (!getGoal()->isNodeValid(_traverse_unknown, _collision_checker)) {
+    float path_cost = 0.0f;
+    return search(path, iterations, path_cost) || getPartialPath(path);
+  }
+
+  // The backward search has its own graph of nodes, their costs being to the goal
+  _backward_graph.clear();
+  _backward_graph.reserve(100000);
+  NodePtr current_node = nullptr;
+  const unsigned int max_index = getSizeX() * getSizeY() * getSizeDim3();
+  const int size_x = static_cast<int>(getSizeX());
+
+  // Unlike the forward search alone, searches joining at any cost can find it cheaper to wrap
+  // around the edges of the grid, so neighbors must be checked for it
+  auto isWrapped = [&](const unsigned int & index) -> bool
+    {
+      return current_node &&
+             std::abs(
+        static_cast<int>(index) % size_x -
+        static_cast<int>(current_node->getIndex()) % size_x) > 1;
+    };
+  auto forwardGetter =
+    [&, this](const unsigned int & index, NodePtr & neighbor_rtn) -> bool
+    {
+      if (index >= max_index || isWrapped(index) || !isInSearchCorridor(index)) {
+        return false;
+      }
+
+      neighbor_rtn = addToGraph(index);
+      return true;
+    };
+  auto backwardGetter =
+    [&, this](const unsigned int & index, NodePtr & neighbor_rtn) -> bool
+    {
+      if (index >= max_index || isWrapped(index) || !isInSearchCorridor(index)) {
+        return false;
+      }
+
+      neighbor_rtn = &(_backward_graph.emplace(
+        index, Node2D(_costmap->getCharMap()[index], index)).first->second);
+      return true;
+    };
+
+  NodePtr backward_goal = nullptr;
+  backwardGetter(getGoal()->getIndex(), backward_goal);
+  backward_goal->setAccumulatedCost(0.0);
+  NodeQueue backward_queue;
+  NodeBasic<Node2D> backward_goal_basic(backward_goal->getIndex());
+  backward_goal_basic.graph_node_ptr = backward_goal;
+  backward_queue.emplace(0.0, backward_goal_basic);
+
+  const Coordinates start_coordinates =
+    Node2D::getCoords(getStart()->getIndex(), getSizeX(), getSizeDim3());
+  float best_cost = std::numeric_limits<float>::max();
+  unsigned int meeting_index = 0;
+  NodePtr other_node = nullptr;
+  NodePtr neighbor = nullptr;
+  NodeVector neighbors;
+  float g_cost = 0.0;
+
+  while (iterations < getMaxIterations() && !isQueueEmpty() && !backward_queue.empty()) {
+    // Once a path is found, no cheaper one is possible if either search's lowest
+    // cost to explore exceeds it
+    if (getQueueTopCost() >= best_cost || backward_queue.top().first >= best_cost) {
+      break;
+    }
+
+    // Expand the direction with the smaller open set
+    const bool forward = getQueueSize() <= backward_queue.size();
+    if (forward) {
+      current_node = getNextNode();
+    } else {
+      current_node = backward_queue.top().second.graph_node_ptr;
+      backward_queue.pop();
+    }
+
+    if (current_node->wasVisited()) {
+      continue;
+    }
+
+    iterations++;
+
+    // If out of time, use the path found so far, if any
+    if (isSearchInterrupted(iterations)) {
+      break;
+    }
+
+    current_node->visited();
+
+    neighbors.clear();
+    if (forward) {
+      Node2D::getNeighbors(
+        current_node, forwardGetter, _collision_checker, _traverse_unknown, neighbors,
+        _expansion_scratch);
+    } else {
+      Node2D::getNeighbors(
+        current_node, backwardGetter, _collision_checker, _traverse_unknown, neighbors,
+        _expansion_scratch);
+    }
+
+    for (auto & neighbor_ptr : neighbors) {
+      neighbor = neighbor_ptr;
+
+      // Traversal costs depend on the cell being entered, so going backwards
+      // it is the cost of the cell we're expanding from
+      g_cost = getAccumulatedCost(current_node) +
+        (forward ? getTraversalCost(current_node, neighbor) :
+        getTraversalCost(neighbor, current_node));
+
+      if (g_cost >= getAccumulatedCost(neighbor)) {
+        continue;
+      }
+
+      neighbor->setAccumulatedCost(g_cost);
+      neighbor->parent = current_node;
+      neighbor->queued();
+
+      if (forward) {
+        addNode(g_cost + getHeuristicCost(neighbor), neighbor);
+      } else {
+        const Coordinates coords =
+          Node2D::getCoords(neighbor->getIndex(), getSizeX(), getSizeDim3());
+        NodeBasic<Node2D> queued_node(neighbor->getIndex());
+        queued_node.graph_node_ptr = neighbor;
+        backward_queue.emplace(
+          g_cost + Node2D::getHeuristicCost(coords, start_coordinates), queued_node);
+      }
+
+      // Check if the other search has reached this node, for a path through it
+      if (forward) {
+        backwardGetter(neighbor->getIndex(), other_node);
+      } else {
+        forwardGetter(neighbor->getIndex(), other_node);
+      }
+      if (other_node->getAccumulatedCost() < std::numeric_limits<float>::max() &&
+        g_cost + other_node->getAccumulatedCost() < best_cost)
+      {
+        best_cost = g_cost + other_node->getAccumulatedCost();
+        meeting_index = neighbor->getIndex();
+      }
+    }
+  }
+
+  if (isCanceled()) {
+    return false;
+  }
+
+  if (best_cost == std::numeric_limits<float>::max()) {
+    return getPartialPath(path);
+  }
+
+  // Join the backward search's path from the goal to the meeting node with the
+  // forward search's path from the meeting node to the start
+  std::vector<unsigned int> goal_side;
+  for (NodePtr node = _backward_graph.at(meeting_index).parent; node; node = node->parent) {
+    goal_side.push_back(node->getIndex());
+  }
+  for (auto it = goal_side.rbegin(); it != goal_side.rend(); ++it) {
+    path.push_back(Node2D::getCoords(*it, getSizeX(), getSizeDim3()));
+  }
+  for (NodePtr node = getFromGraph(meeting_index); node->parent; node = node->parent) {
+    path.push_back(Node2D::getCoords(node->getIndex(), getSizeX(), getSizeDim3()));
+  }
+
+  return path.size() > 1;
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::isSearchInterrupted(const int & iterations)
+{
+  // Checking the clock is relatively expensive, so only do so periodically
+  if (iterations % 128 != 0) {
+    return false;
+  }
+
+  return isCanceled() || steady_clock::now() > _deadline;
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::isInSearchCorridor(const unsigned int & index)
+{
+  return _search_corridor.empty() || _search_corridor[index / getSizeDim3()];
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::isCanceled()
+{
+  return _cancel_requested && _cancel_requested->load();
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::getPartialPath(CoordinateVector & path)
+{
+  if (isCanceled() || steady_clock::now() <= _planning_deadline ||
+    _best_heuristic_node.first == std::numeric_limits<float>::max())
+  {
+    return false;
+  }
+
+  path.clear();
+  NodePtr node = getFromGraph(_best_heuristic_node.second);
+  _is_path_partial = backtracePath(node, path);
+  return _is_path_partial;
+}
+
 template<typename NodeT>
 bool AStarAlgorithm<NodeT>::isGoal(NodePtr & node)
 {
   return node == getGoal();
 }
 
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::repairPath(
+  const Coordinates & /*start*/, const CoordinateVector & /*previous_path*/,
+  const float & /*max_deviation*/, CoordinateVector & /*path*/)
+{
+  return false;
+}
+
+template<>
+bool AStarAlgorithm<NodeSE2>::repairPath(
+  const Coordinates & start, const CoordinateVector & previous_path,
+  const float & max_deviation, CoordinateVector & path)
+{
+  if (previous_path.size() < 2 || !_costmap) {
+    return false;
+  }
+
+  MotionTable & motion_table = NodeSE2::motion_table;
+  auto isPoseValid = [&](const Coordinates & pose) -> bool
+    {
+      if (pose.x < 0.0f || pose.y < 0.0f ||
+        pose.x >= static_cast<float>(getSizeX()) || pose.y >= static_cast<float>(getSizeY()))
+      {
+        return false;
+      }
+      return !_collision_checker.inCollision(
+        pose.x, pose.y, pose.theta * motion_table.bin_size, _traverse_unknown);
+    };
+
+  if (!isPoseValid(start)) {
+    return false;
+  }
+
+  // Find the closest pose of the previous path to the start, and the length of the
+  // path from each pose to the goal
+  std::vector<float> & remaining_lengths = _repair_lengths;
+  remaining_lengths.resize(previous_path.size());
+  remaining_lengths[0] = 0.0f;
+  unsigned int closest = 0;
+  float closest_distance = std::numeric_limits<float>::max();
+  for (unsigned int i = 0; i != previous_path.size(); i++) {
+    if (i > 0) {
+      remaining_lengths[i] = remaining_lengths[i - 1] + std::hypot(
+        previous_path[i].x - previous_path[i - 1].x,
+        previous_path[i].y - previous_path[i - 1].y);
+    }
+    const float distance =
+      std::hypot(previous_path[i].x - start.x, previous_path[i].y - start.y);
+    if (distance < closest_distance) {
+      closest_distance = distance;
+      closest = i;
+    }
+  }
+
+  if (closest_distance > max_deviation) {
+    return false;
+  }
+
+  // The previous path from there to the goal must still be valid
+  for (unsigned int i = 0; i <= closest; i++) {
+    if (!isPoseValid(previous_path[i])) {
+      return false;
+    }
+  }
+
+  // Reconnect to the poses ahead, a curve to a path offset from the start needs to travel
+  // a few turning radii to rejoin it. Try those giving the shortest path to the goal first.
+  ompl::base::ScopedState<> from(motion_table.state_space), to(motion_table.state_space),
+  s(motion_table.state_space);
+  from[0] = start.x;
+  from[1] = start.y;
+  from[2] = start.theta * motion_table.bin_size;
+  const float lookahead = 2.0f * max_deviation + 4.0f * _search_info.minimum_turning_radius;
+  std::vector<std::pair<float, unsigned int>> & candidates = _repair_candidates;
+  candidates.clear();
+  for (int i = static_cast<int>(closest); i >= 0; i--) {
+    if (remaining_lengths[closest] - remaining_lengths[i] > lookahead) {
+      break;
+    }
+    to[0] = previous_path[i].x;
+    to[1] = previous_path[i].y;
+    to[2] = previous_path[i].theta * motion_table.bin_size;
+    candidates.emplace_back(
+      static_cast<float>(motion_table.state_space->distance(from(), to())) +
+      remaining_lengths[i], static_cast<unsigned int>(i));
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  // A move of sqrt(2) is guaranteed to be in a new cell
+  static const float sqrt_2 = std::sqrt(2.);
+  std::vector<double> reals;
+  for (const auto & candidate : candidates) {
+    const Coordinates & join = previous_path[candidate.second];
+    to[0] = join.x;
+    to[1] = join.y;
+    to[2] = join.theta * motion_table.bin_size;
+    const float curve_length = candidate.first - remaining_lengths[candidate.second];
+    const unsigned int num_intervals =
+      std::max(static_cast<unsigned int>(std::floor(curve_length / sqrt_2)), 1u);
+
+    // Path from the goal to the join, then back along the curve to the start
+    path.assign(previous_path.begin(), previous_path.begin() + candidate.second + 1);
+    bool valid = true;
+    for (unsigned int i = num_intervals - 1; i > 0; i--) {
+      motion_table.state_space->interpolate(
+        from(), to(), static_cast<double>(i) / num_intervals, s());
+      reals = s.reals();
+      float angle = reals[2] / motion_table.bin_size;
+      while (angle >= motion_table.num_angle_quantization_float) {
+        angle -= motion_table.num_angle_quantization_float;
+      }
+      while (angle < 0.0) {
+        angle += motion_table.num_angle_quantization_float;
+      }
+      path.emplace_back(static_cast<float>(reals[0]), static_cast<float>(reals[1]), angle);
+      if (!isPoseValid(path.back())) {
+        valid = false;
+        break;
+      }
+    }
+
+    if (valid) {
+      // Like backtraced paths, it ends with the pose after the start rather than the start
+      if (std::hypot(path.back().x - start.x, path.back().y - start.y) < 1e-3f) {
+        path.pop_back();
+      }
+      if (path.empty()) {
+        break;
+      }
+      return true;
+    }
+  }
+
+  path.clear();
+  return false;
+}
+
 template<>
 AStarAlgorithm<NodeSE2>::NodePtr AStarAlgorithm<NodeSE2>::getAnalyticPath(
   const NodePtr & node,
@@ -349,7 +892,7 @@ AStarAlgorithm<NodeSE2>::NodePtr AStarAlgorithm<NodeSE2>::getAnalyticPath(
   to[1] = _goal_coordinates.y;
   to[2] = _goal_coordinates.theta * node->motion_table.bin_size;
 
-  float d = node->motion_table.state_space->distance(from(), to());
+  float d = NodeSE2::getDistanceHeuristic(node_coords, _goal_coordinates);
   NodePtr prev(node);
   // A move of sqrt(2) is guaranteed to be in a new cell
   static const float sqrt_2 = std::sqrt(2.);
@@ -357,7 +900,9 @@ AStarAlgorithm<NodeSE2>::NodePtr AStarAlgorithm<NodeSE2>::getAnalyticPath(
 
   using PossibleNode = std::pair<NodePtr, Coordinates>;
   std::vector<PossibleNode> possible_nodes;
-  possible_nodes.reserve(num_intervals - 1);  // We won't store this node or the goal
+  if (num_intervals > 1) {
+    possible_nodes.reserve(num_intervals - 1);  // We won't store this node or the goal
+  }
   std::vector<double> reals;
   // Pre-allocate
   unsigned int index = 0;
@@ -407,10 +952,13 @@ AStarAlgorithm<NodeSE2>::NodePtr AStarAlgorithm<NodeSE2>::getAnalyticPath(
       return NodePtr(nullptr);
     }
   }
-  // Legitimate path - set the parent relationships - poses already set
+  // Legitimate path - set the parent relationships - poses already set. The goal is
+  // costed like primitives through the same cells, for anytime search to compare paths.
   prev = node;
+  float g_cost = node->getAccumulatedCost();
   for (const auto & node_pose : possible_nodes) {
     const auto & n = node_pose.first;
+    g_cost += NodeSE2::neutral_cost + node->motion_table.cost_penalty * n->getCost() / 252.0;
     if (!n->wasVisited() && n->getIndex() != _goal->getIndex()) {
       // Make sure this node has not been visited by the regular algorithm.
       // If it has been, there is the (slight) chance that it is in the path we are expanding
@@ -418,12 +966,17 @@ AStarAlgorithm<NodeSE2>::NodePtr AStarAlgorithm<NodeSE2>::getAnalyticPath(
       // Skipping to the next node will still create a kinematically feasible path.
       n->parent = prev;
       n->visited();
+      if (_search_mode == SearchMode::ANYTIME) {
+        _reached_nodes.push_back(n);
+      }
       prev = n;
     }
   }
   if (_goal != prev) {
     _goal->parent = prev;
     _goal->visited();
+    _goal->setAccumulatedCost(
+      g_cost + NodeSE2::neutral_cost + node->motion_table.cost_penalty * _goal->getCost() / 252.0);
   }
   return _goal;
 }
@@ -472,6 +1025,158 @@ bool AStarAlgorithm<NodeSE2>::backtracePath(NodePtr & node, CoordinateVector & p
   return path.size() > 1;
 }
 
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::createPathsToGoals(
+  const CoordinateVector & /*goals*/, std::vector<CoordinateVector> & /*paths*/,
+  std::vector<float> & /*costs*/, int & /*iterations*/)
+{
+  throw std::runtime_error("Searching to many goals is only supported by Node2D.");
+}
+
+template<>
+bool AStarAlgorithm<Node2D>::createPathsToGoals(
+  const CoordinateVector & goals,
+  std::vector<CoordinateVector> & paths,
+  std::vector<float> & costs,
+  int & iterations)
+{
+  paths.assign(goals.size(), CoordinateVector());
+  costs.assign(goals.size(), -1.0f);
+  _is_path_partial = false;
+  _planning_deadline = _max_planning_time > 0.0 ?
+    steady_clock::now() + duration_cast<steady_clock::duration>(
+    duration<double>(_max_planning_time)) :
+    steady_clock::time_point::max();
+  _deadline = _planning_deadline;
+  clearQueue();
+
+  if (_use_node_pool ? _node_pool.empty() : _graph.empty()) {
+    throw std::runtime_error("Failed to compute path, no costmap given.");
+  }
+
+  if (!_start) {
+    throw std::runtime_error("Failed to compute path, no valid start given.");
+  }
+
+  if (!_start->isNodeValid(_traverse_unknown, _collision_checker)) {
+    throw std::runtime_error("Starting point in lethal space! Cannot create feasible plan.");
+  }
+
+  // Goal node indices paired with their position in goals, sorted to look up those reached
+  // as nodes are visited. Goals off the graph or in collision can never be reached.
+  _goal_indices.clear();
+  for (unsigned int i = 0; i != goals.size(); i++) {
+    if (goals[i].x < 0.0f || goals[i].y < 0.0f ||
+      goals[i].x >= static_cast<float>(getSizeX()) || goals[i].y >= static_cast<float>(getSizeY()))
+    {
+      continue;
+    }
+
+    const unsigned int index = Node2D::getIndex(
+      static_cast<unsigned int>(goals[i].x), static_cast<unsigned int>(goals[i].y), getSizeX());
+    if (addToGraph(index)->isNodeValid(_traverse_unknown, _collision_checker)) {
+      _goal_indices.emplace_back(index, i);
+    }
+  }
+  std::sort(_goal_indices.begin(), _goal_indices.end());
+  size_t goals_remaining = _goal_indices.size();
+
+  NodePtr current_node = nullptr;
+  NodeVector neighbors;
+  float g_cost = 0.0;
+
+  // Without a heuristic to deter it, the search would find it cheap to wrap around the
+  // edges of the grid, so neighbors must be checked for it
+  const unsigned int max_index = getSizeX() * getSizeY();
+  const int size_x = static_cast<int>(getSizeX());
+  auto neighborGetter =
+    [&, this](const unsigned int & index, NodePtr & neighbor_rtn) -> bool
+    {
+      if (index >= max_index || !isInSearchCorridor(index) ||
+        std::abs(
+          static_cast<int>(index) % size_x -
+          static_cast<int>(current_node->getIndex()) % size_x) > 1)
+      {
+        return false;
+      }
+
+      neighbor_rtn = addToGraph(index);
+      return true;
+    };
+
+  addNode(0.0, getStart());
+  getStart()->setAccumulatedCost(0.0);
+
+  // Without a heuristic, nodes are visited in order of cost so the first visit of a goal
+  // is along its cheapest path
+  while (goals_remaining > 0 && iterations < getMaxIterations() && !isQueueEmpty()) {
+    current_node = getNextNode();
+
+    if (current_node->wasVisited()) {
+      continue;
+    }
+
+    iterations++;
+
+    // If out of time, use the paths to the goals found so far, if any
+    if (isSearchInterrupted(iterations)) {
+      break;
+    }
+
+    current_node->visited();
+
+    auto goal_it = std::lower_bound(
+      _goal_indices.begin(), _goal_indices.end(), current_node->getIndex(),
+      [](const std::pair<unsigned int, unsigned int> & goal, const unsigned int & index) {
+        return goal.first < index;
+      });
+    for (; goal_it != _goal_indices.end() && goal_it->first == current_node->getIndex();
+      ++goal_it)
+    {
+      goals_remaining--;
+    }
+
+    neighbors.clear();
+    Node2D::getNeighbors(
+      current_node, neighborGetter, _collision_checker, _traverse_unknown, neighbors,
+      _expansion_scratch);
+
+    for (auto & neighbor : neighbors) {
+      g_cost = getAccumulatedCost(current_node) + getTraversalCost(current_node, neighbor);
+      if (g_cost < getAccumulatedCost(neighbor)) {
+        neighbor->setAccumulatedCost(g_cost);
+        neighbor->parent = current_node;
+        neighbor->queued();
+        addNode(g_cost, neighbor);
+      }
+    }
+  }
+
+  if (isCanceled()) {
+    return false;
+  }
+
+  bool any_reached = false;
+  for (const auto & goal : _goal_indices) {
+    NodePtr node = getFromGraph(goal.first);
+    if (!node->wasVisited()) {
+      continue;
+    }
+
+    // A goal at the start has no parent to backtrace to, but is trivially reached
+    CoordinateVector & path = paths[goal.second];
+    if (node == getStart()) {
+      path.push_back(Node2D::getCoords(node->getIndex(), getSizeX(), getSizeDim3()));
+    } else {
+      backtracePath(node, path);
+    }
+    costs[goal.second] = getAccumulatedCost(node);
+    any_reached = true;
+  }
+
+  return any_reached;
+}
+
 template<typename NodeT>
 typename AStarAlgorithm<NodeT>::NodePtr & AStarAlgorithm<NodeT>::getStart()
 {
@@ -487,16 +1192,13 @@ typename AStarAlgorithm<NodeT>::NodePtr & AStarAlgorithm<NodeT>::getGoal()
 template<typename NodeT>
 typename AStarAlgorithm<NodeT>::NodePtr AStarAlgorithm<NodeT>::getNextNode()
 {
-  NodeBasic<NodeT> node = _queue.top().second;
-  _queue.pop();
-  return node.graph_node_ptr;
+  return popFromQueue().graph_node_ptr;
 }
 
 template<>
 typename AStarAlgorithm<NodeSE2>::NodePtr AStarAlgorithm<NodeSE2>::getNextNode()
 {
-  NodeBasic<NodeSE2> node = _queue.top().second;
-  _queue.pop();
+  NodeBasic<NodeSE2> node = popFromQueue();
 
   if (!node.graph_node_ptr->wasVisited()) {
     node.graph_node_ptr->pose = node.pose;
@@ -510,7 +1212,7 @@ void AStarAlgorithm<NodeT>::addNode(const float cost, NodePtr & node)
 {
   NodeBasic<NodeT> queued_node(node->getIndex());
   queued_node.graph_node_ptr = node;
-  _queue.emplace(cost, queued_node);
+  pushToQueue(cost, queued_node);
 }
 
 template<>
@@ -519,7 +1221,51 @@ void AStarAlgorithm<NodeSE2>::addNode(const float cost, NodePtr & node)
   NodeBasic<NodeSE2> queued_node(node->getIndex());
   queued_node.pose = node->pose;
   queued_node.graph_node_ptr = node;
-  _queue.emplace(cost, queued_node);
+  pushToQueue(cost, queued_node);
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::pushToQueue(const float & cost, const NodeBasic<NodeT> & node)
+{
+  if (_use_indexed_heap) {
+    _indexed_queue.push(cost, node);
+    return;
+  }
+
+  _queue.emplace(cost, node);
+  _peak_queue_size = std::max(_peak_queue_size, _queue.size());
+}
+
+template<typename NodeT>
+NodeBasic<NodeT> AStarAlgorithm<NodeT>::popFromQueue()
+{
+  if (_use_indexed_heap) {
+    NodeBasic<NodeT> node = _indexed_queue.top().second;
+    _indexed_queue.pop();
+    return node;
+  }
+
+  NodeBasic<NodeT> node = _queue.top().second;
+  _queue.pop();
+  return node;
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::isQueueEmpty()
+{
+  return _use_indexed_heap ? _indexed_queue.empty() : _queue.empty();
+}
+
+template<typename NodeT>
+size_t AStarAlgorithm<NodeT>::getQueueSize()
+{
+  return _use_indexed_heap ? _indexed_queue.size() : _queue.size();
+}
+
+template<typename NodeT>
+float AStarAlgorithm<NodeT>::getQueueTopCost()
+{
+  return _use_indexed_heap ? _indexed_queue.top().first : _queue.top().first;
 }
 
 template<typename NodeT>
@@ -556,11 +1302,22 @@ void AStarAlgorithm<NodeT>::clearQueue()
 {
   NodeQueue q;
   std::swap(_queue, q);
+  _indexed_queue.clear();
+  _peak_queue_size = 0;
 }
 
 template<typename NodeT>
 void AStarAlgorithm<NodeT>::clearGraph()
 {
+  // Must release queued nodes before the graph they point into
+  _indexed_queue.clear();
+
+  if (_use_node_pool) {
+    // O(1), nodes from prior searches are lazily reconstructed when next added
+    _node_pool.clear();
+    return;
+  }
+
   Graph g;
   g.reserve(100000);
   std::swap(_graph, g);
@@ -584,6 +1341,18 @@ float & AStarAlgorithm<NodeT>::getToleranceHeuristic()
   return _tolerance;
 }
 
+template<typename NodeT>
+size_t AStarAlgorithm<NodeT>::getPeakQueueSize()
+{
+  return _use_indexed_heap ? _indexed_queue.peakSize() : _peak_queue_size;
+}
+
+template<typename NodeT>
+bool AStarAlgorithm<NodeT>::isPathPartial()
+{
+  return _is_path_partial;
+}
+
 template<typename NodeT>
 unsigned int & AStarAlgorithm<NodeT>::getSizeX()
 {
@@ -18,6 +18,13 @@
 #include <string>
 #include <memory>
 #include <algorithm>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace nav2_smac_planner
 {
@@ -84,11 +91,9 @@ nav2_costmap_2d::Costmap2D * CostmapDownsampler::downsample(
   }
 
   // Assign costs
-  for (uint i = 0; i < _downsampled_size_x; ++i) {
-    for (uint j = 0; j < _downsampled_size_y; ++j) {
-      setCostOfCell(i, j);
-    }
-  }
+  maxPool(
+    _costmap->getCharMap(), _size_x, _size_y, _downsampling_factor,
+    _downsampled_costmap->getCharMap());
 
   _downsampled_costmap_pub->publishCostmap();
   return _downsampled_costmap.get();
@@ -113,6 +118,101 @@ void CostmapDownsampler::resizeCostmap()
     _costmap->getOriginY());
 }
 
+void CostmapDownsampler::maxPool(
+  const unsigned char * costs,
+  const unsigned int & size_x,
+  const unsigned int & size_y,
+  const unsigned int & downsampling_factor,
+  unsigned char * downsampled_costs)
+{
+  const unsigned int downsampled_size_x = (size_x + downsampling_factor - 1) / downsampling_factor;
+  const unsigned int downsampled_size_y = (size_y + downsampling_factor - 1) / downsampling_factor;
+
+  // Threads only pay off on maps large enough to amortize starting them
+  const bool parallel = size_x * size_y > 250000;
+
+  // Power of two factors are reduced in X by repeatedly taking the max of pairs
+  const bool power_of_two = (downsampling_factor & (downsampling_factor - 1)) == 0;
+  const unsigned int padded_size_x = downsampled_size_x * downsampling_factor;
+
+  #pragma omp parallel if (parallel)
+  {
+    // Max over the rows of a coarse row, per column of the original grid, padded with
+    // zeros to a whole number of coarse cells
+    std::vector<unsigned char> column_max(padded_size_x);
+
+    #pragma omp for schedule(static)
+    for (unsigned int j = 0; j < downsampled_size_y; j++) {
+      const unsigned int y_begin = j * downsampling_factor;
+      const unsigned int y_end = std::min(y_begin + downsampling_factor, size_y);
+      std::copy(
+        costs + y_begin * size_x, costs + (y_begin + 1) * size_x, column_max.begin());
+      std::fill(column_max.begin() + size_x, column_max.end(), 0);
+      for (unsigned int y = y_begin + 1; y < y_end; y++) {
+        maxRow(costs + y * size_x, column_max.data(), size_x);
+      }
+
+      unsigned char * downsampled_row = downsampled_costs + j * downsampled_size_x;
+      if (power_of_two) {
+        for (unsigned int n = padded_size_x; n > downsampled_size_x; n /= 2) {
+          maxPairs(column_max.data(), n);
+        }
+        std::copy(
+          column_max.begin(), column_max.begin() + downsampled_size_x, downsampled_row);
+        continue;
+      }
+
+      for (unsigned int i = 0; i != downsampled_size_x; i++) {
+        const unsigned int x_begin = i * downsampling_factor;
+        const unsigned int x_end = std::min(x_begin + downsampling_factor, size_x);
+        downsampled_row[i] =
+          *std::max_element(column_max.begin() + x_begin, column_max.begin() + x_end);
+      }
+    }
+  }
+}
+
+void CostmapDownsampler::maxRow(
+  const unsigned char * row, unsigned char * max_row, const unsigned int & size)
+{
+  unsigned int i = 0;
+#if defined(__AVX2__)
+  for (; i + 32 <= size; i += 32) {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(max_row + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(max_row + i), _mm256_max_epu8(a, b));
+  }
+#elif defined(__SSE2__)
+  for (; i + 16 <= size; i += 16) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(max_row + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(max_row + i), _mm_max_epu8(a, b));
+  }
+#endif
+  for (; i < size; i++) {
+    max_row[i] = std::max(max_row[i], row[i]);
+  }
+}
+
+void CostmapDownsampler::maxPairs(unsigned char * row, const unsigned int & size)
+{
+  // In place, as each element is written after those it is computed from are read
+  unsigned int i = 0;
+#if defined(__SSE2__)
+  const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+  for (; 2 * i + 32 <= size; i += 16) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + 2 * i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + 2 * i + 16));
+    a = _mm_and_si128(_mm_max_epu8(a, _mm_srli_epi16(a, 8)), low_bytes);
+    b = _mm_and_si128(_mm_max_epu8(b, _mm_srli_epi16(b, 8)), low_bytes);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(row + i), _mm_packus_epi16(a, b));
+  }
+#endif
+  for (; 2 * i < size; i++) {
+    row[i] = std::max(row[2 * i], row[2 * i + 1]);
+  }
+}
+
 void CostmapDownsampler::setCostOfCell(
   const unsigned int & new_mx,
   const unsigned int & new_my)
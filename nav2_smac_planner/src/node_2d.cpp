@@ -31,7 +31,8 @@ Node2D::Node2D(unsigned char & cost_in, const unsigned int index)
   _accumulated_cost(std::numeric_limits<float>::max()),
   _index(index),
   _was_visited(false),
-  _is_queued(false)
+  _is_queued(false),
+  _open_set_index(std::numeric_limits<unsigned int>::max())
 {
 }
 
@@ -47,11 +48,12 @@ void Node2D::reset(const unsigned char & cost)
   _accumulated_cost = std::numeric_limits<float>::max();
   _was_visited = false;
   _is_queued = false;
+  _open_set_index = std::numeric_limits<unsigned int>::max();
 }
 
 bool Node2D::isNodeValid(
   const bool & traverse_unknown,
-  GridCollisionChecker /*collision_checker*/)
+  GridCollisionChecker & /*collision_checker*/)
 {
   // NOTE(stevemacenski): Right now, we do not check if the node has wrapped around
   // the regular grid (e.g. your node is on the edge of the costmap and i+1
@@ -116,36 +118,4 @@ void Node2D::initNeighborhood(
   }
 }
 
-void Node2D::getNeighbors(
-  NodePtr & node,
-  std::function<bool(const unsigned int &, nav2_smac_planner::Node2D * &)> & NeighborGetter,
-  GridCollisionChecker collision_checker,
-  const bool & traverse_unknown,
-  NodeVector & neighbors)
-{
-  // NOTE(stevemacenski): Irritatingly, the order here matters. If you start in free
-  // space and then expand 8-connected, the first set of neighbors will be all cost
-  // _neutral_cost. Then its expansion will all be 2 * _neutral_cost but now multiple
-  // nodes are touching that node so the last cell to update the back pointer wins.
-  // Thusly, the ordering ends with the cardinal directions for both sets such that
-  // behavior is consistent in large free spaces between them.
-  // 100  50   0
-  // 100  50  50
-  // 100 100 100   where lower-middle '100' is visited with same cost by both bottom '50' nodes
-  // Therefore, it is valuable to have some low-potential across the entire map
-  // rather than a small inflation around the obstacles
-  int index;
-  NodePtr neighbor;
-  int node_i = node->getIndex();
-
-  for (unsigned int i = 0; i != _neighbors_grid_offsets.size(); ++i) {
-    index = node_i + _neighbors_grid_offsets[i];
-    if (NeighborGetter(index, neighbor)) {
-      if (neighbor->isNodeValid(traverse_unknown, collision_checker) && !neighbor->wasVisited()) {
-        neighbors.push_back(neighbor);
-      }
-    }
-  }
-}
-
 }  // namespace nav2_smac_planner
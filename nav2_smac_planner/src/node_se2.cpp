@@ -14,12 +14,15 @@
 // limitations under the License. Reserved.
 
 #include <math.h>
+#include <cstdlib>
 #include <chrono>
 #include <vector>
 #include <memory>
 #include <algorithm>
 #include <queue>
 #include <limits>
+#include <utility>
+#include <functional>
 
 #include "ompl/base/ScopedState.h"
 #include "ompl/base/spaces/DubinsStateSpace.h"
@@ -34,6 +37,10 @@ namespace nav2_smac_planner
 
 // defining static member for all instance to share
 std::vector<unsigned int> NodeSE2::_wavefront_heuristic;
+std::vector<unsigned char> NodeSE2::_wavefront_costmap;
+unsigned int NodeSE2::_wavefront_goal_index = std::numeric_limits<unsigned int>::max();
+std::vector<float> NodeSE2::_distance_heuristic_lookup_table;
+int NodeSE2::_lookup_table_half_size = -1;
 double NodeSE2::neutral_cost = sqrt(2);
 MotionTable NodeSE2::motion_table;
 
@@ -59,6 +66,7 @@ void MotionTable::initDubin(
   non_straight_penalty = search_info.non_straight_penalty;
   cost_penalty = search_info.cost_penalty;
   reverse_penalty = search_info.reverse_penalty;
+  num_threads = std::max(search_info.num_expansion_threads, 1);
 
   // angle must meet 3 requirements:
   // 1) be increment of quantized bin size
@@ -103,21 +111,7 @@ void MotionTable::initDubin(
   // Create the correct OMPL state space
   state_space = std::make_unique<ompl::base::DubinsStateSpace>(search_info.minimum_turning_radius);
 
-  // Precompute projection deltas
-  delta_xs.resize(projections.size());
-  delta_ys.resize(projections.size());
-
-  for (unsigned int i = 0; i != projections.size(); i++) {
-    delta_xs[i].resize(num_angle_quantization);
-    delta_ys[i].resize(num_angle_quantization);
-
-    for (unsigned int j = 0; j != num_angle_quantization; j++) {
-      double cos_theta = cos(bin_size * j);
-      double sin_theta = sin(bin_size * j);
-      delta_xs[i][j] = projections[i]._x * cos_theta - projections[i]._y * sin_theta;
-      delta_ys[i][j] = projections[i]._x * sin_theta + projections[i]._y * cos_theta;
-    }
-  }
+  initProjectionTables();
 }
 
 // http://planning.cs.uiuc.edu/node822.html
@@ -136,6 +130,7 @@ void MotionTable::initReedsShepp(
   non_straight_penalty = search_info.non_straight_penalty;
   cost_penalty = search_info.cost_penalty;
   reverse_penalty = search_info.reverse_penalty;
+  num_threads = std::max(search_info.num_expansion_threads, 1);
 
   float angle = 2.0 * asin(sqrt(2.0) / (2 * search_info.minimum_turning_radius));
   bin_size =
@@ -165,31 +160,81 @@ void MotionTable::initReedsShepp(
   state_space = std::make_unique<ompl::base::ReedsSheppStateSpace>(
     search_info.minimum_turning_radius);
 
-  // Precompute projection deltas
-  delta_xs.resize(projections.size());
-  delta_ys.resize(projections.size());
+  initProjectionTables();
+}
+
+void MotionTable::initProjectionTables()
+{
+  const unsigned int num_primitives = static_cast<unsigned int>(projections.size());
+
+  // Rotate each primitive into each heading, with its heading bin after the motion
+  heading_projections.resize(num_angle_quantization * num_primitives);
+  for (unsigned int j = 0; j != num_angle_quantization; j++) {
+    const double cos_theta = cos(bin_size * j);
+    const double sin_theta = sin(bin_size * j);
+    for (unsigned int i = 0; i != num_primitives; i++) {
+      float new_heading = static_cast<float>(j) + projections[i]._theta;
+      while (new_heading >= num_angle_quantization_float) {
+        new_heading -= num_angle_quantization_float;
+      }
+      while (new_heading < 0.0) {
+        new_heading += num_angle_quantization_float;
+      }
+
+      heading_projections[j * num_primitives + i] = MotionPose(
+        projections[i]._x * cos_theta - projections[i]._y * sin_theta,
+        projections[i]._x * sin_theta + projections[i]._y * cos_theta,
+        new_heading);
+    }
+  }
+
+  // Primitives 0 and 3 are straight, forward and backward. Reversing is penalized
+  // when expanding from a backward primitive.
+  travel_cost_multipliers.resize(num_primitives * num_primitives);
+  for (unsigned int parent = 0; parent != num_primitives; parent++) {
+    for (unsigned int child = 0; child != num_primitives; child++) {
+      float multiplier = 1.0f;
+      if (child != 0 && child != 3) {
+        if (parent == child) {
+          // Turning motion but keeps in same direction: encourages to commit to turning
+          multiplier = non_straight_penalty;
+        } else {
+          // Turning motion and changing direction: penalizes wiggling
+          multiplier = change_penalty + non_straight_penalty;
+        }
+      }
 
-  for (unsigned int i = 0; i != projections.size(); i++) {
-    delta_xs[i].resize(num_angle_quantization);
-    delta_ys[i].resize(num_angle_quantization);
+      if (parent > 2) {
+        multiplier *= reverse_penalty;
+      }
 
-    for (unsigned int j = 0; j != num_angle_quantization; j++) {
-      double cos_theta = cos(bin_size * j);
-      double sin_theta = sin(bin_size * j);
-      delta_xs[i][j] = projections[i]._x * cos_theta - projections[i]._y * sin_theta;
-      delta_ys[i][j] = projections[i]._x * sin_theta + projections[i]._y * cos_theta;
+      travel_cost_multipliers[parent * num_primitives + child] = multiplier;
     }
   }
 }
 
-MotionPoses MotionTable::getProjections(const NodeSE2 * node)
+void MotionTable::getProjections(const NodeSE2 * node, MotionPoses & projection_list)
 {
-  MotionPoses projection_list;
-  for (unsigned int i = 0; i != projections.size(); i++) {
-    projection_list.push_back(getProjection(node, i));
+  const unsigned int num_primitives = static_cast<unsigned int>(projections.size());
+  projection_list.clear();
+
+  // Off-bin headings, as set by analytic expansions, must compute their final headings
+  const float & node_heading = node->pose.theta;
+  const unsigned int heading_bin = static_cast<unsigned int>(node_heading);
+  if (static_cast<float>(heading_bin) != node_heading) {
+    for (unsigned int i = 0; i != num_primitives; i++) {
+      projection_list.push_back(getProjection(node, i));
+    }
+    return;
   }
 
-  return projection_list;
+  const MotionPose * heading_projection = &heading_projections[heading_bin * num_primitives];
+  for (unsigned int i = 0; i != num_primitives; i++) {
+    projection_list.emplace_back(
+      heading_projection[i]._x + node->pose.x,
+      heading_projection[i]._y + node->pose.y,
+      heading_projection[i]._theta);
+  }
 }
 
 MotionPose MotionTable::getProjection(const NodeSE2 * node, const unsigned int & motion_index)
@@ -207,10 +252,9 @@ MotionPose MotionTable::getProjection(const NodeSE2 * node, const unsigned int &
     new_heading += num_angle_quantization_float;
   }
 
-  return MotionPose(
-    delta_xs[motion_index][node_heading] + node->pose.x,
-    delta_ys[motion_index][node_heading] + node->pose.y,
-    new_heading);
+  const MotionPose & delta = heading_projections[
+    static_cast<unsigned int>(node_heading) * projections.size() + motion_index];
+  return MotionPose(delta._x + node->pose.x, delta._y + node->pose.y, new_heading);
 }
 
 NodeSE2::NodeSE2(const unsigned int index)
@@ -221,6 +265,7 @@ NodeSE2::NodeSE2(const unsigned int index)
   _index(index),
   _was_visited(false),
   _is_queued(false),
+  _open_set_index(std::numeric_limits<unsigned int>::max()),
   _motion_primitive_index(std::numeric_limits<unsigned int>::max())
 {
 }
@@ -237,13 +282,16 @@ void NodeSE2::reset()
   _accumulated_cost = std::numeric_limits<float>::max();
   _was_visited = false;
   _is_queued = false;
+  _open_set_index = std::numeric_limits<unsigned int>::max();
   _motion_primitive_index = std::numeric_limits<unsigned int>::max();
   pose.x = 0.0f;
   pose.y = 0.0f;
   pose.theta = 0.0f;
 }
 
-bool NodeSE2::isNodeValid(const bool & traverse_unknown, GridCollisionChecker collision_checker)
+bool NodeSE2::isNodeValid(
+  const bool & traverse_unknown,
+  GridCollisionChecker & collision_checker)
 {
   if (collision_checker.inCollision(
       this->pose.x, this->pose.y, this->pose.theta * motion_table.bin_size, traverse_unknown))
@@ -269,37 +317,75 @@ float NodeSE2::getTraversalCost(const NodePtr & child)
     return NodeSE2::neutral_cost;
   }
 
-  float travel_cost = 0.0;
-  float travel_cost_raw = NodeSE2::neutral_cost + motion_table.cost_penalty * normalized_cost;
+  // Turning, direction change, and reversing penalties are precomputed per primitive pair
+  const float travel_cost_raw =
+    NodeSE2::neutral_cost + motion_table.cost_penalty * normalized_cost;
+  return travel_cost_raw * motion_table.getTravelCostMultiplier(
+    getMotionPrimitiveIndex(), child->getMotionPrimitiveIndex());
+}
 
-  if (child->getMotionPrimitiveIndex() == 0 || child->getMotionPrimitiveIndex() == 3) {
-    // straight motion, no additional costs to be applied
-    travel_cost = travel_cost_raw;
-  } else {
-    if (getMotionPrimitiveIndex() == child->getMotionPrimitiveIndex()) {
-      // Turning motion but keeps in same direction: encourages to commit to turning if starting it
-      travel_cost = travel_cost_raw * motion_table.non_straight_penalty;
-    } else {
-      // Turning motion and changing direction: penalizes wiggling
-      travel_cost = travel_cost_raw * motion_table.change_penalty;
-      travel_cost += travel_cost_raw * motion_table.non_straight_penalty;
-    }
-  }
+float NodeSE2::getHeuristicCost(
+  const Coordinates & node_coords,
+  const Coordinates & goal_coords)
+{
+  // Dubin or Reeds-Shepp shortest distances
+  const float motion_heuristic = getDistanceHeuristic(node_coords, goal_coords);
 
-  if (getMotionPrimitiveIndex() > 2) {
-    // reverse direction
-    travel_cost *= motion_table.reverse_penalty;
+  const unsigned int & wavefront_idx = static_cast<unsigned int>(node_coords.y) *
+    motion_table.size_x + static_cast<unsigned int>(node_coords.x);
+  const unsigned int & wavefront_value = _wavefront_heuristic[wavefront_idx];
+
+  // if lethal or didn't visit, use the motion heuristic instead.
+  if (wavefront_value == 0) {
+    return NodeSE2::neutral_cost * motion_heuristic;
   }
 
-  return travel_cost;
+  // -2 because wavefront starts at 2
+  const float wavefront_heuristic = static_cast<float>(wavefront_value - 2);
+
+  return NodeSE2::neutral_cost * std::max(wavefront_heuristic, motion_heuristic);
 }
 
-float NodeSE2::getHeuristicCost(
+float NodeSE2::getDistanceHeuristic(
   const Coordinates & node_coords,
   const Coordinates & goal_coords)
 {
-  // Dubin or Reeds-Shepp shortest distances
-  // Create OMPL states for checking
+  if (_lookup_table_half_size >= 0) {
+    // Rotate and translate the node into the goal frame, such that the goal is (0, 0, 0).
+    // Rounding to the table's cell increments makes this approximate, it is not admissible.
+    const float goal_angle = goal_coords.theta * motion_table.bin_size;
+    const float cos_th = cos(goal_angle);
+    const float sin_th = sin(goal_angle);
+    const float dx = node_coords.x - goal_coords.x;
+    const float dy = node_coords.y - goal_coords.y;
+    int x_idx = static_cast<int>(round(dx * cos_th + dy * sin_th));
+    int y_idx = static_cast<int>(round(-dx * sin_th + dy * cos_th));
+
+    if (std::abs(x_idx) <= _lookup_table_half_size &&
+      std::abs(y_idx) <= _lookup_table_half_size)
+    {
+      const int num_angles = static_cast<int>(motion_table.num_angle_quantization);
+      int theta_idx =
+        static_cast<int>(round(node_coords.theta - goal_coords.theta)) % num_angles;
+      if (theta_idx < 0) {
+        theta_idx += num_angles;
+      }
+
+      // Only the positive Y half is stored, distances are symmetric when
+      // mirroring Y and heading across the X axis
+      if (y_idx < 0) {
+        y_idx = -y_idx;
+        theta_idx = (num_angles - theta_idx) % num_angles;
+      }
+
+      const int index =
+        ((x_idx + _lookup_table_half_size) * (_lookup_table_half_size + 1) + y_idx) *
+        num_angles + theta_idx;
+      return _distance_heuristic_lookup_table[index];
+    }
+  }
+
+  // Outside of the window, create OMPL states for checking
   ompl::base::ScopedState<> from(motion_table.state_space), to(motion_table.state_space);
   from[0] = node_coords.x;
   from[1] = node_coords.y;
@@ -308,21 +394,63 @@ float NodeSE2::getHeuristicCost(
   to[1] = goal_coords.y;
   to[2] = goal_coords.theta * motion_table.bin_size;
 
-  const float motion_heuristic = motion_table.state_space->distance(from(), to());
+  return motion_table.state_space->distance(from(), to());
+}
 
-  const unsigned int & wavefront_idx = static_cast<unsigned int>(node_coords.y) *
-    motion_table.size_x + static_cast<unsigned int>(node_coords.x);
-  const unsigned int & wavefront_value = _wavefront_heuristic[wavefront_idx];
+void NodeSE2::precomputeDistanceHeuristic(
+  const MotionModel & motion_model,
+  const unsigned int & num_angle_quantization,
+  const SearchInfo & search_info)
+{
+  // Table only depends on these settings, don't recompute if they're unchanged
+  static MotionModel last_motion_model = MotionModel::UNKNOWN;
+  static float last_turning_radius = 0.0f;
+  static unsigned int last_num_angle_quantization = 0;
+  const int half_size = static_cast<int>(floor(search_info.lookup_table_size / 2.0f));
+
+  if (half_size <= 0) {
+    _lookup_table_half_size = -1;
+    _distance_heuristic_lookup_table.clear();
+    return;
+  }
 
-  // if lethal or didn't visit, use the motion heuristic instead.
-  if (wavefront_value == 0) {
-    return NodeSE2::neutral_cost * motion_heuristic;
+  if (half_size == _lookup_table_half_size && motion_model == last_motion_model &&
+    search_info.minimum_turning_radius == last_turning_radius &&
+    num_angle_quantization == last_num_angle_quantization)
+  {
+    return;
   }
 
-  // -2 because wavefront starts at 2
-  const float wavefront_heuristic = static_cast<float>(wavefront_value - 2);
+  // Store distances from poses in a window around a goal at (0, 0, 0) to the goal.
+  // Only the positive Y half is needed, the negative half is mirrored across the X axis.
+  ompl::base::ScopedState<> from(motion_table.state_space), to(motion_table.state_space);
+  to[0] = 0.0;
+  to[1] = 0.0;
+  to[2] = 0.0;
 
-  return NodeSE2::neutral_cost * std::max(wavefront_heuristic, motion_heuristic);
+  const float bin_size = 2.0f * static_cast<float>(M_PI) /
+    static_cast<float>(num_angle_quantization);
+  _distance_heuristic_lookup_table.resize(
+    (2 * half_size + 1) * (half_size + 1) * num_angle_quantization);
+
+  unsigned int index = 0;
+  for (int x = -half_size; x <= half_size; x++) {
+    for (int y = 0; y <= half_size; y++) {
+      for (unsigned int heading = 0; heading != num_angle_quantization; heading++) {
+        from[0] = x;
+        from[1] = y;
+        from[2] = heading * bin_size;
+        _distance_heuristic_lookup_table[index] =
+          motion_table.state_space->distance(from(), to());
+        index++;
+      }
+    }
+  }
+
+  _lookup_table_half_size = half_size;
+  last_motion_model = motion_model;
+  last_turning_radius = search_info.minimum_turning_radius;
+  last_num_angle_quantization = num_angle_quantization;
 }
 
 void NodeSE2::initMotionModel(
@@ -346,14 +474,63 @@ void NodeSE2::initMotionModel(
               " Dubin (Ackermann forward only),"
               " Reeds-Shepp (Ackermann forward and back).");
   }
+
+  precomputeDistanceHeuristic(motion_model, num_angle_quantization, search_info);
+}
+
+bool NodeSE2::isWavefrontNeighbor(
+  const unsigned int & idx, const unsigned int & new_idx,
+  const unsigned int & size_x, const unsigned int & size_y)
+{
+  if (new_idx == 0 || new_idx >= size_x * size_y) {
+    return false;
+  }
+
+  // Make sure the neighbor didn't wrap around the edges of the grid
+  const unsigned int my_idx = idx / size_x;
+  const unsigned int mx_idx = idx - (my_idx * size_x);
+  const unsigned int my = new_idx / size_x;
+  const unsigned int mx = new_idx - (my * size_x);
+
+  if ((mx == 0 && mx_idx >= size_x - 1) || (mx >= size_x - 1 && mx_idx == 0)) {
+    return false;
+  }
+  if ((my == 0 && my_idx >= size_y - 1) || (my >= size_y - 1 && my_idx == 0)) {
+    return false;
+  }
+
+  return true;
 }
 
 void NodeSE2::computeWavefrontHeuristic(
   nav2_costmap_2d::Costmap2D * & costmap,
   const unsigned int & start_x, const unsigned int & start_y,
-  const unsigned int & goal_x, const unsigned int & goal_y)
+  const unsigned int & goal_x, const unsigned int & goal_y,
+  const bool & reuse_previous)
 {
-  unsigned int size = costmap->getSizeInCellsX() * costmap->getSizeInCellsY();
+  const unsigned int & size_x = motion_table.size_x;
+  const int size_x_int = static_cast<int>(size_x);
+  const unsigned int size_y = costmap->getSizeInCellsY();
+  const unsigned int size = size_x * size_y;
+  const unsigned int goal_index = goal_y * size_x + goal_x;
+  const unsigned int start_index = start_y * size_x + start_x;
+  const unsigned char * char_map = costmap->getCharMap();
+
+  const std::vector<int> neighborhood = {1, -1,  // left right
+    size_x_int, -size_x_int,  // up down
+    size_x_int + 1, size_x_int - 1,  // upper diagonals
+    -size_x_int + 1, -size_x_int - 1};  // lower diagonals
+
+  // If planning to the same goal as last time, only repair the cells affected
+  // by changes in the costmap since then rather than recomputing it all.
+  if (reuse_previous && goal_index == _wavefront_goal_index &&
+    _wavefront_heuristic.size() == size && _wavefront_costmap.size() == size)
+  {
+    repairWavefrontHeuristic(char_map, size_x, size_y, goal_index, neighborhood);
+    _wavefront_costmap.assign(char_map, char_map + size);
+    return;
+  }
+
   if (_wavefront_heuristic.size() == size) {
     // must reset all values
     for (unsigned int i = 0; i != _wavefront_heuristic.size(); i++) {
@@ -368,92 +545,172 @@ void NodeSE2::computeWavefrontHeuristic(
     }
   }
 
-  const unsigned int & size_x = motion_table.size_x;
-  const int size_x_int = static_cast<int>(size_x);
-  const unsigned int size_y = costmap->getSizeInCellsY();
-  const unsigned int goal_index = goal_y * size_x + goal_x;
-  const unsigned int start_index = start_y * size_x + start_x;
-  unsigned int mx, my, mx_idx, my_idx;
-
   std::queue<unsigned int> q;
   q.emplace(goal_index);
 
   unsigned int idx = goal_index;
   _wavefront_heuristic[idx] = 2;
 
-  static const std::vector<int> neighborhood = {1, -1,  // left right
-    size_x_int, -size_x_int,  // up down
-    size_x_int + 1, size_x_int - 1,  // upper diagonals
-    -size_x_int + 1, -size_x_int - 1};  // lower diagonals
-
   while (!q.empty() || idx == start_index) {
     // get next one
     idx = q.front();
     q.pop();
 
-    my_idx = idx / size_x;
-    mx_idx = idx - (my_idx * size_x);
-
     // find neighbors
     for (unsigned int i = 0; i != neighborhood.size(); i++) {
       unsigned int new_idx = static_cast<unsigned int>(static_cast<int>(idx) + neighborhood[i]);
       unsigned int last_wave_cost = _wavefront_heuristic[idx];
 
       // if neighbor is unvisited and non-lethal, set N and add to queue
-      if (new_idx > 0 && new_idx < size_x * size_y &&
-        _wavefront_heuristic[new_idx] == 0 &&
-        static_cast<float>(costmap->getCost(idx)) < INSCRIBED)
+      if (static_cast<float>(char_map[idx]) < INSCRIBED &&
+        isWavefrontNeighbor(idx, new_idx, size_x, size_y) &&
+        _wavefront_heuristic[new_idx] == 0)
       {
-        my = new_idx / size_x;
-        mx = new_idx - (my * size_x);
-
-        if (mx == 0 && mx_idx >= size_x - 1 || mx >= size_x - 1 && mx_idx == 0) {
-          continue;
-        }
-        if (my == 0 && my_idx >= size_y - 1 || my >= size_y - 1 && my_idx == 0) {
-          continue;
-        }
-
         _wavefront_heuristic[new_idx] = last_wave_cost + 1;
-        q.emplace(idx + neighborhood[i]);
+        q.emplace(new_idx);
       }
     }
   }
+
+  if (reuse_previous) {
+    _wavefront_goal_index = goal_index;
+    _wavefront_costmap.assign(char_map, char_map + size);
+  } else {
+    _wavefront_goal_index = std::numeric_limits<unsigned int>::max();
+    _wavefront_costmap.clear();
+  }
 }
 
-void NodeSE2::getNeighbors(
-  const NodePtr & node,
-  std::function<bool(const unsigned int &, nav2_smac_planner::NodeSE2 * &)> & NeighborGetter,
-  GridCollisionChecker collision_checker,
-  const bool & traverse_unknown,
-  NodeVector & neighbors)
+void NodeSE2::repairWavefrontHeuristic(
+  const unsigned char * char_map,
+  const unsigned int & size_x, const unsigned int & size_y,
+  const unsigned int & goal_index,
+  const std::vector<int> & neighborhood)
 {
-  unsigned int index = 0;
-  NodePtr neighbor = nullptr;
-  Coordinates initial_node_coords;
-  const MotionPoses motion_projections = motion_table.getProjections(node);
-
-  for (unsigned int i = 0; i != motion_projections.size(); i++) {
-    index = NodeSE2::getIndex(
-      static_cast<unsigned int>(motion_projections[i]._x),
-      static_cast<unsigned int>(motion_projections[i]._y),
-      static_cast<unsigned int>(motion_projections[i]._theta),
-      motion_table.size_x, motion_table.num_angle_quantization);
-
-    if (NeighborGetter(index, neighbor) && !neighbor->wasVisited()) {
-      // Cache the initial pose in case it was visited but valid
-      // don't want to disrupt continuous coordinate expansion
-      initial_node_coords = neighbor->pose;
-      neighbor->setPose(
-        Coordinates(
-          motion_projections[i]._x,
-          motion_projections[i]._y,
-          motion_projections[i]._theta));
-      if (neighbor->isNodeValid(traverse_unknown, collision_checker)) {
-        neighbor->setMotionPrimitiveIndex(i);
-        neighbors.push_back(neighbor);
-      } else {
-        neighbor->setPose(initial_node_coords);
+  // A cell's wavefront value is 1 + the lowest value of its neighbors that may be expanded.
+  // Cells which may no longer be expanded can invalidate the values of cells downstream of
+  // them, which must be raised. Cells which may now be expanded can lower values nearby.
+  // This is done in the style of a dynamic brushfire algorithm.
+  auto is_expandable = [&](const unsigned int & idx) -> bool {
+      return static_cast<float>(char_map[idx]) < INSCRIBED;
+    };
+  auto was_expandable = [&](const unsigned int & idx) -> bool {
+      return static_cast<float>(_wavefront_costmap[idx]) < INSCRIBED;
+    };
+  auto neighbor = [](const unsigned int & idx, const int & offset) -> unsigned int {
+      return static_cast<unsigned int>(static_cast<int>(idx) + offset);
+    };
+
+  std::vector<unsigned int> & wavefront = _wavefront_heuristic;
+  const unsigned int size = size_x * size_y;
+  std::queue<unsigned int> raise_queue;
+  std::vector<unsigned int> freed;
+
+  // 1) Find cells which changed between expandable and not
+  for (unsigned int idx = 0; idx != size; idx++) {
+    if (is_expandable(idx) == was_expandable(idx)) {
+      continue;
+    }
+
+    if (is_expandable(idx)) {
+      freed.push_back(idx);
+      continue;
+    }
+
+    // Newly blocked, its neighbors may have relied on it
+    if (wavefront[idx] == 0) {
+      continue;
+    }
+    for (const int & offset : neighborhood) {
+      const unsigned int new_idx = neighbor(idx, offset);
+      if (isWavefrontNeighbor(idx, new_idx, size_x, size_y) &&
+        wavefront[new_idx] == wavefront[idx] + 1)
+      {
+        raise_queue.push(new_idx);
+      }
+    }
+  }
+
+  if (freed.empty() && raise_queue.empty()) {
+    return;
+  }
+
+  // 2) Raise: clear cells which no longer have an expandable neighbor supporting their value
+  std::vector<unsigned int> cleared;
+  while (!raise_queue.empty()) {
+    const unsigned int idx = raise_queue.front();
+    raise_queue.pop();
+
+    if (wavefront[idx] == 0 || idx == goal_index) {
+      continue;
+    }
+
+    bool supported = false;
+    for (const int & offset : neighborhood) {
+      const unsigned int parent_idx = neighbor(idx, offset);
+      if (parent_idx < size && isWavefrontNeighbor(parent_idx, idx, size_x, size_y) &&
+        wavefront[parent_idx] != 0 && wavefront[parent_idx] + 1 == wavefront[idx] &&
+        is_expandable(parent_idx))
+      {
+        supported = true;
+        break;
+      }
+    }
+
+    if (supported) {
+      continue;
+    }
+
+    const unsigned int last_wave_cost = wavefront[idx];
+    wavefront[idx] = 0;
+    cleared.push_back(idx);
+
+    for (const int & offset : neighborhood) {
+      const unsigned int new_idx = neighbor(idx, offset);
+      if (isWavefrontNeighbor(idx, new_idx, size_x, size_y) &&
+        wavefront[new_idx] == last_wave_cost + 1)
+      {
+        raise_queue.push(new_idx);
+      }
+    }
+  }
+
+  // 3) Lower: propagate from the valid cells bordering cleared cells and from freed cells
+  typedef std::pair<unsigned int, unsigned int> WaveCell;
+  std::priority_queue<WaveCell, std::vector<WaveCell>, std::greater<WaveCell>> lower_queue;
+
+  for (const unsigned int & idx : cleared) {
+    for (const int & offset : neighborhood) {
+      const unsigned int parent_idx = neighbor(idx, offset);
+      if (parent_idx < size && isWavefrontNeighbor(parent_idx, idx, size_x, size_y) &&
+        wavefront[parent_idx] != 0 && is_expandable(parent_idx))
+      {
+        lower_queue.emplace(wavefront[parent_idx], parent_idx);
+      }
+    }
+  }
+
+  for (const unsigned int & idx : freed) {
+    if (wavefront[idx] != 0) {
+      lower_queue.emplace(wavefront[idx], idx);
+    }
+  }
+
+  while (!lower_queue.empty()) {
+    const WaveCell cell = lower_queue.top();
+    lower_queue.pop();
+
+    if (wavefront[cell.second] != cell.first || !is_expandable(cell.second)) {
+      continue;
+    }
+
+    for (const int & offset : neighborhood) {
+      const unsigned int new_idx = neighbor(cell.second, offset);
+      if (isWavefrontNeighbor(cell.second, new_idx, size_x, size_y) &&
+        (wavefront[new_idx] == 0 || wavefront[new_idx] > cell.first + 1))
+      {
+        wavefront[new_idx] = cell.first + 1;
+        lower_queue.emplace(cell.first + 1, new_idx);
       }
     }
   }
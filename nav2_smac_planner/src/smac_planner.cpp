@@ -32,7 +32,8 @@ SmacPlanner::SmacPlanner()
 : _a_star(nullptr),
   _smoother(nullptr),
   _costmap(nullptr),
-  _costmap_downsampler(nullptr)
+  _costmap_downsampler(nullptr),
+  _use_plan_repair(false)
 {
 }
 
@@ -52,6 +53,10 @@ void SmacPlanner::configure(
   _logger = node->get_logger();
   _clock = node->get_clock();
   _costmap = costmap_ros->getCostmap();
+  {
+    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(_costmap->getMutex()));
+    _costmap_snapshot = *_costmap;
+  }
   _name = name;
   _global_frame = costmap_ros->getGlobalFrameID();
 
@@ -61,6 +66,14 @@ void SmacPlanner::configure(
   int angle_quantizations;
   SearchInfo search_info;
   bool smooth_path;
+  bool use_node_pool;
+  bool use_indexed_heap;
+  std::string search_mode_name;
+  double anytime_initial_weight;
+  double anytime_weight_decrement;
+  double anytime_max_time;
+  double max_search_time;
+  bool use_hierarchical_planning;
   std::string motion_model_for_search;
 
   // General planner params
@@ -89,6 +102,41 @@ void SmacPlanner::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".smooth_path", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".smooth_path", smooth_path);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_node_pool", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_node_pool", use_node_pool);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_indexed_heap", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_indexed_heap", use_indexed_heap);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".search_mode", rclcpp::ParameterValue(std::string("ASTAR")));
+  node->get_parameter(name + ".search_mode", search_mode_name);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_initial_weight", rclcpp::ParameterValue(3.0));
+  node->get_parameter(name + ".anytime_initial_weight", anytime_initial_weight);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_weight_decrement", rclcpp::ParameterValue(0.5));
+  node->get_parameter(name + ".anytime_weight_decrement", anytime_weight_decrement);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_max_time", rclcpp::ParameterValue(0.5));
+  node->get_parameter(name + ".anytime_max_time", anytime_max_time);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_hierarchical_planning", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_hierarchical_planning", use_hierarchical_planning);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".hierarchical_downsampling_factor", rclcpp::ParameterValue(4));
+  node->get_parameter(name + ".hierarchical_downsampling_factor", _coarse_downsampling_factor);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".hierarchical_corridor_radius", rclcpp::ParameterValue(1.0));
+  node->get_parameter(name + ".hierarchical_corridor_radius", _corridor_radius);
+
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_plan_repair", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_plan_repair", _use_plan_repair);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".plan_repair_max_deviation", rclcpp::ParameterValue(0.5));
+  node->get_parameter(name + ".plan_repair_max_deviation", _plan_repair_max_deviation);
+  _previous_path.clear();
 
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".minimum_turning_radius", rclcpp::ParameterValue(0.2));
@@ -109,10 +157,28 @@ void SmacPlanner::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".analytic_expansion_ratio", rclcpp::ParameterValue(2.0));
   node->get_parameter(name + ".analytic_expansion_ratio", search_info.analytic_expansion_ratio);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".lookup_table_size", rclcpp::ParameterValue(0.0));
+  node->get_parameter(name + ".lookup_table_size", search_info.lookup_table_size);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".cache_wavefront_heuristic", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".cache_wavefront_heuristic", search_info.cache_wavefront_heuristic);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".num_expansion_threads", rclcpp::ParameterValue(1));
+  node->get_parameter(name + ".num_expansion_threads", search_info.num_expansion_threads);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_footprint_masks", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_footprint_masks", search_info.use_footprint_masks);
 
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".max_planning_time", rclcpp::ParameterValue(5.0));
   node->get_parameter(name + ".max_planning_time", _max_planning_time);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".max_search_time", rclcpp::ParameterValue(0.0));
+  node->get_parameter(name + ".max_search_time", max_search_time);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".allow_partial_path", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".allow_partial_path", _allow_partial_path);
 
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".motion_model_for_search", rclcpp::ParameterValue(std::string("DUBIN")));
@@ -126,6 +192,24 @@ void SmacPlanner::configure(
       motion_model_for_search.c_str());
   }
 
+  SearchMode search_mode = searchModeFromString(search_mode_name);
+  if (search_mode == SearchMode::UNKNOWN || search_mode == SearchMode::BIDIRECTIONAL) {
+    RCLCPP_WARN(
+      _logger,
+      "Unable to use search mode. Given '%s', "
+      "valid options are ASTAR, ANYTIME. Using ASTAR.",
+      search_mode_name.c_str());
+    search_mode = SearchMode::ASTAR;
+  }
+
+  if (search_mode == SearchMode::ANYTIME && anytime_weight_decrement <= 0.0) {
+    RCLCPP_WARN(
+      _logger,
+      "Anytime weight decrement must be positive, given %.2f. Using 0.5.",
+      anytime_weight_decrement);
+    anytime_weight_decrement = 0.5;
+  }
+
   if (max_on_approach_iterations <= 0) {
     RCLCPP_INFO(
       _logger, "On approach iteration selected as <= 0, "
@@ -144,12 +228,23 @@ void SmacPlanner::configure(
   const double minimum_turning_radius_global_coords = search_info.minimum_turning_radius;
   search_info.minimum_turning_radius =
     search_info.minimum_turning_radius / (_costmap->getResolution() * _downsampling_factor);
+  search_info.lookup_table_size =
+    search_info.lookup_table_size / (_costmap->getResolution() * _downsampling_factor);
 
   _a_star = std::make_unique<AStarAlgorithm<NodeSE2>>(motion_model, search_info);
   _a_star->initialize(
     allow_unknown,
     max_iterations,
-    max_on_approach_iterations);
+    max_on_approach_iterations,
+    use_node_pool,
+    use_indexed_heap);
+  _a_star->setSearchMode(
+    search_mode,
+    static_cast<float>(anytime_initial_weight),
+    static_cast<float>(anytime_weight_decrement),
+    anytime_max_time);
+  _cancel_requested = std::make_shared<std::atomic<bool>>(false);
+  _a_star->setPlanningLimits(max_search_time, _cancel_requested);
   _a_star->setFootprint(costmap_ros->getRobotFootprint(), costmap_ros->getUseRadius());
 
   if (smooth_path) {
@@ -164,7 +259,28 @@ void SmacPlanner::configure(
     std::string topic_name = "downsampled_costmap";
     _costmap_downsampler = std::make_unique<CostmapDownsampler>();
     _costmap_downsampler->on_configure(
-      node, _global_frame, topic_name, _costmap, _downsampling_factor);
+      node, _global_frame, topic_name, &_costmap_snapshot, _downsampling_factor);
+  }
+
+  if (use_hierarchical_planning && _coarse_downsampling_factor > 1) {
+    const int search_downsampling_factor = _costmap_downsampler ? _downsampling_factor : 1;
+    std::string topic_name = "coarse_costmap";
+    _coarse_costmap_downsampler = std::make_unique<CostmapDownsampler>();
+    _coarse_costmap_downsampler->on_configure(
+      node, _global_frame, topic_name, &_costmap_snapshot,
+      search_downsampling_factor * _coarse_downsampling_factor);
+
+    _coarse_a_star = std::make_unique<AStarAlgorithm<Node2D>>(MotionModel::MOORE, SearchInfo());
+    _coarse_a_star->initialize(
+      allow_unknown,
+      max_iterations,
+      max_on_approach_iterations,
+      false,
+      false);
+  } else if (use_hierarchical_planning) {
+    RCLCPP_WARN(
+      _logger, "Hierarchical planning requires a hierarchical downsampling factor > 1, "
+      "disabling hierarchical planning.");
   }
 
   _raw_plan_publisher = node->create_publisher<nav_msgs::msg::Path>("unsmoothed_plan", 1);
@@ -183,10 +299,14 @@ void SmacPlanner::activate()
   RCLCPP_INFO(
     _logger, "Activating plugin %s of type SmacPlanner",
     _name.c_str());
+  _cancel_requested->store(false);
   _raw_plan_publisher->on_activate();
   if (_costmap_downsampler) {
     _costmap_downsampler->on_activate();
   }
+  if (_coarse_costmap_downsampler) {
+    _coarse_costmap_downsampler->on_activate();
+  }
 }
 
 void SmacPlanner::deactivate()
@@ -194,10 +314,20 @@ void SmacPlanner::deactivate()
   RCLCPP_INFO(
     _logger, "Deactivating plugin %s of type SmacPlanner",
     _name.c_str());
+  // Stop any search in progress, its plan would not be used
+  _cancel_requested->store(true);
   _raw_plan_publisher->on_deactivate();
   if (_costmap_downsampler) {
     _costmap_downsampler->on_deactivate();
   }
+  if (_coarse_costmap_downsampler) {
+    _coarse_costmap_downsampler->on_deactivate();
+  }
+}
+
+void SmacPlanner::cancelPlanning(const bool & cancel)
+{
+  _cancel_requested->store(cancel);
 }
 
 void SmacPlanner::cleanup()
@@ -209,7 +339,13 @@ void SmacPlanner::cleanup()
   _smoother.reset();
   _costmap_downsampler->on_cleanup();
   _costmap_downsampler.reset();
+  if (_coarse_costmap_downsampler) {
+    _coarse_costmap_downsampler->on_cleanup();
+    _coarse_costmap_downsampler.reset();
+  }
+  _coarse_a_star.reset();
   _raw_plan_publisher.reset();
+  _previous_path.clear();
 }
 
 nav_msgs::msg::Path SmacPlanner::createPlan(
@@ -218,39 +354,59 @@ nav_msgs::msg::Path SmacPlanner::createPlan(
 {
   steady_clock::time_point a = steady_clock::now();
 
+  // Plan on a copy of the costmap, so that it may keep updating while searching
   std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(_costmap->getMutex()));
+  _costmap_snapshot = *_costmap;
+  lock.unlock();
 
   // Downsample costmap, if required
-  nav2_costmap_2d::Costmap2D * costmap = _costmap;
+  nav2_costmap_2d::Costmap2D * costmap = &_costmap_snapshot;
   if (_costmap_downsampler) {
     costmap = _costmap_downsampler->downsample(_downsampling_factor);
   }
 
-  // Set Costmap
-  _a_star->createGraph(
-    costmap->getSizeInCellsX(),
-    costmap->getSizeInCellsY(),
-    _angle_quantizations,
-    costmap);
-
-  // Set starting point, in A* bin search coordinates
-  unsigned int mx, my;
-  costmap->worldToMap(start.pose.position.x, start.pose.position.y, mx, my);
+  // Get starting point, in A* bin search coordinates
+  unsigned int start_mx, start_my;
+  costmap->worldToMap(start.pose.position.x, start.pose.position.y, start_mx, start_my);
   double orientation_bin = tf2::getYaw(start.pose.orientation) / _angle_bin_size;
   while (orientation_bin < 0.0) {
     orientation_bin += static_cast<float>(_angle_quantizations);
   }
-  unsigned int orientation_bin_id = static_cast<unsigned int>(floor(orientation_bin));
-  _a_star->setStart(mx, my, orientation_bin_id);
+  const unsigned int start_bin_id = static_cast<unsigned int>(floor(orientation_bin));
 
-  // Set goal point, in A* bin search coordinates
-  costmap->worldToMap(goal.pose.position.x, goal.pose.position.y, mx, my);
+  // Get goal point, in A* bin search coordinates
+  unsigned int goal_mx, goal_my;
+  costmap->worldToMap(goal.pose.position.x, goal.pose.position.y, goal_mx, goal_my);
   orientation_bin = tf2::getYaw(goal.pose.orientation) / _angle_bin_size;
   while (orientation_bin < 0.0) {
     orientation_bin += static_cast<float>(_angle_quantizations);
   }
-  orientation_bin_id = static_cast<unsigned int>(floor(orientation_bin));
-  _a_star->setGoal(mx, my, orientation_bin_id);
+  const unsigned int goal_bin_id = static_cast<unsigned int>(floor(orientation_bin));
+
+  // Set Costmap
+  _a_star->createGraph(
+    costmap->getSizeInCellsX(),
+    costmap->getSizeInCellsY(),
+    _angle_quantizations,
+    costmap);
+
+  // Reuse the previous plan to the same goal if it is still valid, else search for one
+  NodeSE2::CoordinateVector path;
+  const Eigen::Vector3d goal_world(
+    goal.pose.position.x, goal.pose.position.y, static_cast<double>(goal_bin_id));
+  const bool path_repaired = _use_plan_repair && repairPlan(start, goal_world, costmap, path);
+  std::vector<bool> corridor;
+  if (!path_repaired) {
+    _a_star->setStart(start_mx, start_my, start_bin_id);
+    _a_star->setGoal(goal_mx, goal_my, goal_bin_id);
+
+    // Restrict search to a corridor around a path planned on a coarser costmap, if required
+    if (_coarse_a_star &&
+      getSearchCorridor(start_mx, start_my, goal_mx, goal_my, costmap, corridor))
+    {
+      _a_star->setSearchCorridor(corridor);
+    }
+  }
 
   // Setup message
   nav_msgs::msg::Path plan;
@@ -265,14 +421,32 @@ nav_msgs::msg::Path SmacPlanner::createPlan(
   pose.pose.orientation.w = 1.0;
 
   // Compute plan
-  NodeSE2::CoordinateVector path;
   int num_iterations = 0;
   std::string error;
+  const float tolerance = _tolerance / static_cast<float>(costmap->getResolution());
   try {
-    if (!_a_star->createPath(
-        path, num_iterations, _tolerance / static_cast<float>(costmap->getResolution())))
-    {
-      if (num_iterations < _a_star->getMaxIterations()) {
+    bool path_found = path_repaired || _a_star->createPath(path, num_iterations, tolerance);
+
+    // The corridor may be too narrow to maneuver within, if so search the whole costmap
+    if (!path_found && !corridor.empty() && !_cancel_requested->load()) {
+      RCLCPP_DEBUG(
+        _logger, "%s: no path found within coarse path corridor, searching whole costmap.",
+        _name.c_str());
+      _a_star->createGraph(
+        costmap->getSizeInCellsX(),
+        costmap->getSizeInCellsY(),
+        _angle_quantizations,
+        costmap);
+      _a_star->setStart(start_mx, start_my, start_bin_id);
+      _a_star->setGoal(goal_mx, goal_my, goal_bin_id);
+      num_iterations = 0;
+      path_found = _a_star->createPath(path, num_iterations, tolerance);
+    }
+
+    if (!path_found) {
+      if (_cancel_requested->load()) {
+        error = std::string("planning was canceled");
+      } else if (num_iterations < _a_star->getMaxIterations()) {
         error = std::string("no valid path found");
       } else {
         error = std::string("exceeded maximum iterations");
@@ -288,9 +462,42 @@ nav_msgs::msg::Path SmacPlanner::createPlan(
       _logger,
       "%s: failed to create plan, %s.",
       _name.c_str(), error.c_str());
+    _previous_path.clear();
     return plan;
   }
 
+  // A search out of time only reaches as close to the goal as it got, which is not a valid
+  // plan to the goal unless requested
+  const bool path_partial = !path_repaired && _a_star->isPathPartial();
+  if (path_partial) {
+    if (!_allow_partial_path) {
+      RCLCPP_WARN(
+        _logger,
+        "%s: failed to create plan, exceeded maximum search time.",
+        _name.c_str());
+      _previous_path.clear();
+      return plan;
+    }
+
+    RCLCPP_WARN(
+      _logger,
+      "%s: exceeded maximum search time, using path to the closest point to the goal found.",
+      _name.c_str());
+  }
+
+  // Keep complete plans, in world coordinates, to reuse when next planning to the same goal
+  if (_use_plan_repair) {
+    _previous_path.clear();
+    if (!path_partial) {
+      _previous_path.reserve(path.size());
+      for (const auto & coords : path) {
+        const Eigen::Vector2d world = getWorldCoords(coords.x, coords.y, costmap);
+        _previous_path.emplace_back(world.x(), world.y(), coords.theta);
+      }
+      _previous_goal = goal_world;
+    }
+  }
+
   // Convert to world coordinates and downsample path for smoothing if necesssary
   // We're going to downsample by 4x to give terms room to move.
   const int downsample_ratio = 4;
@@ -350,6 +557,52 @@ nav_msgs::msg::Path SmacPlanner::createPlan(
   return plan;
 }
 
+bool SmacPlanner::repairPlan(
+  const geometry_msgs::msg::PoseStamped & start,
+  const Eigen::Vector3d & goal,
+  nav2_costmap_2d::Costmap2D * costmap,
+  NodeSE2::CoordinateVector & path)
+{
+  // Only plans to the same goal pose may be reused
+  if (_previous_path.empty() || _previous_goal[2] != goal[2] ||
+    std::hypot(_previous_goal[0] - goal[0], _previous_goal[1] - goal[1]) >
+    0.5 * costmap->getResolution())
+  {
+    return false;
+  }
+
+  // Previous plan and start in continuous grid coordinates of the current costmap
+  const double resolution = costmap->getResolution();
+  _previous_path_coords.clear();
+  for (const auto & world : _previous_path) {
+    _previous_path_coords.emplace_back(
+      static_cast<float>((world[0] - costmap->getOriginX()) / resolution - 0.5),
+      static_cast<float>((world[1] - costmap->getOriginY()) / resolution - 0.5),
+      static_cast<float>(world[2]));
+  }
+
+  double orientation_bin = tf2::getYaw(start.pose.orientation) / _angle_bin_size;
+  while (orientation_bin < 0.0) {
+    orientation_bin += static_cast<float>(_angle_quantizations);
+  }
+  const NodeSE2::Coordinates start_coords(
+    static_cast<float>((start.pose.position.x - costmap->getOriginX()) / resolution - 0.5),
+    static_cast<float>((start.pose.position.y - costmap->getOriginY()) / resolution - 0.5),
+    static_cast<float>(orientation_bin));
+
+  if (!_a_star->repairPath(
+      start_coords, _previous_path_coords,
+      static_cast<float>(_plan_repair_max_deviation / resolution), path))
+  {
+    RCLCPP_DEBUG(
+      _logger, "%s: previous plan is blocked or too far away to reuse, searching.",
+      _name.c_str());
+    return false;
+  }
+
+  return true;
+}
+
 void SmacPlanner::removeHook(std::vector<Eigen::Vector2d> & path)
 {
   // Removes the end "hooking" since goal is locked in place
@@ -363,6 +616,84 @@ void SmacPlanner::removeHook(std::vector<Eigen::Vector2d> & path)
   }
 }
 
+bool SmacPlanner::getSearchCorridor(
+  const unsigned int & start_mx, const unsigned int & start_my,
+  const unsigned int & goal_mx, const unsigned int & goal_my,
+  nav2_costmap_2d::Costmap2D * costmap,
+  std::vector<bool> & corridor)
+{
+  const int search_downsampling_factor = _costmap_downsampler ? _downsampling_factor : 1;
+  nav2_costmap_2d::Costmap2D * coarse_costmap = _coarse_costmap_downsampler->downsample(
+    search_downsampling_factor * _coarse_downsampling_factor);
+  const unsigned int factor = static_cast<unsigned int>(_coarse_downsampling_factor);
+  const unsigned int coarse_start_mx = start_mx / factor, coarse_start_my = start_my / factor;
+  const unsigned int coarse_goal_mx = goal_mx / factor, coarse_goal_my = goal_my / factor;
+
+  // The full resolution search checks the start and goal themselves, so obstacles
+  // sharing their coarse cells should not block the coarse search
+  coarse_costmap->setCost(
+    coarse_start_mx, coarse_start_my, costmap->getCost(start_mx, start_my));
+  coarse_costmap->setCost(
+    coarse_goal_mx, coarse_goal_my, costmap->getCost(goal_mx, goal_my));
+
+  Node2D::CoordinateVector coarse_path;
+  int num_iterations = 0;
+  try {
+    _coarse_a_star->createGraph(
+      coarse_costmap->getSizeInCellsX(),
+      coarse_costmap->getSizeInCellsY(),
+      1,
+      coarse_costmap);
+    _coarse_a_star->setStart(coarse_start_mx, coarse_start_my, 0);
+    _coarse_a_star->setGoal(coarse_goal_mx, coarse_goal_my, 0);
+    if (!_coarse_a_star->createPath(
+        coarse_path, num_iterations,
+        _tolerance / static_cast<float>(coarse_costmap->getResolution())))
+    {
+      return false;
+    }
+  } catch (const std::runtime_error &) {
+    return false;
+  }
+
+  // Path is backtraced from the goal, so does not contain the start
+  coarse_path.emplace_back(coarse_start_mx, coarse_start_my);
+  coarse_path.emplace_back(coarse_goal_mx, coarse_goal_my);
+
+  // Mark all cells of the costmap in coarse cells within the radius of the coarse path
+  const int radius =
+    static_cast<int>(std::ceil(_corridor_radius / coarse_costmap->getResolution()));
+  const int coarse_size_x = static_cast<int>(coarse_costmap->getSizeInCellsX());
+  const int coarse_size_y = static_cast<int>(coarse_costmap->getSizeInCellsY());
+  const unsigned int size_x = costmap->getSizeInCellsX();
+  const unsigned int size_y = costmap->getSizeInCellsY();
+  corridor.assign(size_x * size_y, false);
+
+  for (const auto & coarse_pt : coarse_path) {
+    for (int dy = -radius; dy <= radius; dy++) {
+      for (int dx = -radius; dx <= radius; dx++) {
+        const int cx = static_cast<int>(coarse_pt.x) + dx;
+        const int cy = static_cast<int>(coarse_pt.y) + dy;
+        if (dx * dx + dy * dy > radius * radius ||
+          cx < 0 || cy < 0 || cx >= coarse_size_x || cy >= coarse_size_y)
+        {
+          continue;
+        }
+
+        const unsigned int max_my = std::min((cy + 1) * factor, size_y);
+        const unsigned int max_mx = std::min((cx + 1) * factor, size_x);
+        for (unsigned int my = cy * factor; my < max_my; my++) {
+          for (unsigned int mx = cx * factor; mx < max_mx; mx++) {
+            corridor[my * size_x + mx] = true;
+          }
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
 Eigen::Vector2d SmacPlanner::getWorldCoords(
   const float & mx, const float & my, const nav2_costmap_2d::Costmap2D * costmap)
 {
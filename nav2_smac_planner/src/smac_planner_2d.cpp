@@ -17,6 +17,7 @@
 #include <vector>
 #include <limits>
 #include <algorithm>
+#include <chrono>
 
 #include "nav2_smac_planner/smac_planner_2d.hpp"
 
@@ -50,6 +51,10 @@ void SmacPlanner2D::configure(
   _logger = node->get_logger();
   _clock = node->get_clock();
   _costmap = costmap_ros->getCostmap();
+  {
+    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(_costmap->getMutex()));
+    _costmap_snapshot = *_costmap;
+  }
   _name = name;
   _global_frame = costmap_ros->getGlobalFrameID();
 
@@ -57,6 +62,13 @@ void SmacPlanner2D::configure(
   int max_iterations;
   int max_on_approach_iterations;
   bool smooth_path;
+  bool use_node_pool;
+  bool use_indexed_heap;
+  std::string search_mode_name;
+  double anytime_initial_weight;
+  double anytime_weight_decrement;
+  double anytime_max_time;
+  double max_search_time;
   double minimum_turning_radius;
   std::string motion_model_for_search;
 
@@ -83,6 +95,24 @@ void SmacPlanner2D::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".smooth_path", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".smooth_path", smooth_path);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_node_pool", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_node_pool", use_node_pool);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_indexed_heap", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_indexed_heap", use_indexed_heap);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".search_mode", rclcpp::ParameterValue(std::string("ASTAR")));
+  node->get_parameter(name + ".search_mode", search_mode_name);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_initial_weight", rclcpp::ParameterValue(3.0));
+  node->get_parameter(name + ".anytime_initial_weight", anytime_initial_weight);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_weight_decrement", rclcpp::ParameterValue(0.5));
+  node->get_parameter(name + ".anytime_weight_decrement", anytime_weight_decrement);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_max_time", rclcpp::ParameterValue(0.5));
+  node->get_parameter(name + ".anytime_max_time", anytime_max_time);
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".minimum_turning_radius", rclcpp::ParameterValue(0.2));
   node->get_parameter(name + ".minimum_turning_radius", minimum_turning_radius);
@@ -90,6 +120,12 @@ void SmacPlanner2D::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".max_planning_time", rclcpp::ParameterValue(1.0));
   node->get_parameter(name + ".max_planning_time", _max_planning_time);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".max_search_time", rclcpp::ParameterValue(0.0));
+  node->get_parameter(name + ".max_search_time", max_search_time);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".allow_partial_path", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".allow_partial_path", _allow_partial_path);
 
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".motion_model_for_search", rclcpp::ParameterValue(std::string("MOORE")));
@@ -103,6 +139,24 @@ void SmacPlanner2D::configure(
       motion_model_for_search.c_str());
   }
 
+  SearchMode search_mode = searchModeFromString(search_mode_name);
+  if (search_mode == SearchMode::UNKNOWN) {
+    RCLCPP_WARN(
+      _logger,
+      "Unable to use search mode. Given '%s', "
+      "valid options are ASTAR, ANYTIME, BIDIRECTIONAL. Using ASTAR.",
+      search_mode_name.c_str());
+    search_mode = SearchMode::ASTAR;
+  }
+
+  if (search_mode == SearchMode::ANYTIME && anytime_weight_decrement <= 0.0) {
+    RCLCPP_WARN(
+      _logger,
+      "Anytime weight decrement must be positive, given %.2f. Using 0.5.",
+      anytime_weight_decrement);
+    anytime_weight_decrement = 0.5;
+  }
+
   if (max_on_approach_iterations <= 0) {
     RCLCPP_INFO(
       _logger, "On approach iteration selected as <= 0, "
@@ -121,7 +175,16 @@ void SmacPlanner2D::configure(
   _a_star->initialize(
     allow_unknown,
     max_iterations,
-    max_on_approach_iterations);
+    max_on_approach_iterations,
+    use_node_pool,
+    use_indexed_heap);
+  _a_star->setSearchMode(
+    search_mode,
+    static_cast<float>(anytime_initial_weight),
+    static_cast<float>(anytime_weight_decrement),
+    anytime_max_time);
+  _cancel_requested = std::make_shared<std::atomic<bool>>(false);
+  _a_star->setPlanningLimits(max_search_time, _cancel_requested);
 
   if (smooth_path) {
     _smoother = std::make_unique<Smoother>();
@@ -135,7 +198,7 @@ void SmacPlanner2D::configure(
     std::string topic_name = "downsampled_costmap";
     _costmap_downsampler = std::make_unique<CostmapDownsampler>();
     _costmap_downsampler->on_configure(
-      node, _global_frame, topic_name, _costmap, _downsampling_factor);
+      node, _global_frame, topic_name, &_costmap_snapshot, _downsampling_factor);
   }
 
   _raw_plan_publisher = node->create_publisher<nav_msgs::msg::Path>("unsmoothed_plan", 1);
@@ -154,6 +217,7 @@ void SmacPlanner2D::activate()
   RCLCPP_INFO(
     _logger, "Activating plugin %s of type SmacPlanner2D",
     _name.c_str());
+  _cancel_requested->store(false);
   _raw_plan_publisher->on_activate();
   if (_costmap_downsampler) {
     _costmap_downsampler->on_activate();
@@ -165,12 +229,19 @@ void SmacPlanner2D::deactivate()
   RCLCPP_INFO(
     _logger, "Deactivating plugin %s of type SmacPlanner2D",
     _name.c_str());
+  // Stop any search in progress, its plan would not be used
+  _cancel_requested->store(true);
   _raw_plan_publisher->on_deactivate();
   if (_costmap_downsampler) {
     _costmap_downsampler->on_deactivate();
   }
 }
 
+void SmacPlanner2D::cancelPlanning(const bool & cancel)
+{
+  _cancel_requested->store(cancel);
+}
+
 void SmacPlanner2D::cleanup()
 {
   RCLCPP_INFO(
@@ -189,10 +260,13 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
 {
   steady_clock::time_point a = steady_clock::now();
 
+  // Plan on a copy of the costmap, so that it may keep updating while searching
   std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(_costmap->getMutex()));
+  _costmap_snapshot = *_costmap;
+  lock.unlock();
 
   // Downsample costmap, if required
-  nav2_costmap_2d::Costmap2D * costmap = _costmap;
+  nav2_costmap_2d::Costmap2D * costmap = &_costmap_snapshot;
   if (_costmap_downsampler) {
     costmap = _costmap_downsampler->downsample(_downsampling_factor);
   }
@@ -217,13 +291,6 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
   nav_msgs::msg::Path plan;
   plan.header.stamp = _clock->now();
   plan.header.frame_id = _global_frame;
-  geometry_msgs::msg::PoseStamped pose;
-  pose.header = plan.header;
-  pose.pose.position.z = 0.0;
-  pose.pose.orientation.x = 0.0;
-  pose.pose.orientation.y = 0.0;
-  pose.pose.orientation.z = 0.0;
-  pose.pose.orientation.w = 1.0;
 
   // Compute plan
   Node2D::CoordinateVector path;
@@ -233,7 +300,9 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
     if (!_a_star->createPath(
         path, num_iterations, _tolerance / static_cast<float>(costmap->getResolution())))
     {
-      if (num_iterations < _a_star->getMaxIterations()) {
+      if (_cancel_requested->load()) {
+        error = std::string("planning was canceled");
+      } else if (num_iterations < _a_star->getMaxIterations()) {
         error = std::string("no valid path found");
       } else {
         error = std::string("exceeded maximum iterations");
@@ -252,6 +321,140 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
     return plan;
   }
 
+  // A search out of time only reaches as close to the goal as it got, which is not a valid
+  // plan to the goal unless requested
+  if (_a_star->isPathPartial()) {
+    if (!_allow_partial_path) {
+      RCLCPP_WARN(
+        _logger,
+        "%s: failed to create plan, exceeded maximum search time.",
+        _name.c_str());
+      return plan;
+    }
+
+    RCLCPP_WARN(
+      _logger,
+      "%s: exceeded maximum search time, using path to the closest point to the goal found.",
+      _name.c_str());
+  }
+
+  // Smooth in the time left after searching
+  duration<double> search_time = duration_cast<duration<double>>(steady_clock::now() - a);
+  plan = createPlanFromPath(path, costmap, _max_planning_time - search_time.count());
+#ifdef BENCHMARK_TESTING
+  steady_clock::time_point b = steady_clock::now();
+  duration<double> time_span = duration_cast<duration<double>>(b - a);
+  std::cout << "It took " << time_span.count() * 1000 <<
+    " milliseconds with " << num_iterations << " iterations." << std::endl;
+#endif
+  return plan;
+}
+
+std::vector<nav_msgs::msg::Path> SmacPlanner2D::createPlans(
+  const geometry_msgs::msg::PoseStamped & start,
+  const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+  std::vector<double> & costs)
+{
+  steady_clock::time_point a = steady_clock::now();
+
+  // Plan on a copy of the costmap, so that it may keep updating while searching
+  std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(_costmap->getMutex()));
+  _costmap_snapshot = *_costmap;
+  lock.unlock();
+
+  // Downsample costmap, if required
+  nav2_costmap_2d::Costmap2D * costmap = &_costmap_snapshot;
+  if (_costmap_downsampler) {
+    costmap = _costmap_downsampler->downsample(_downsampling_factor);
+  }
+
+  // Set Costmap
+  _a_star->createGraph(
+    costmap->getSizeInCellsX(),
+    costmap->getSizeInCellsY(),
+    1,
+    costmap);
+
+  // Set starting point
+  unsigned int mx, my;
+  costmap->worldToMap(start.pose.position.x, start.pose.position.y, mx, my);
+  _a_star->setStart(mx, my, 0);
+
+  // Goals off the costmap are left out of bounds, to not be reached
+  Node2D::CoordinateVector goal_coords;
+  goal_coords.reserve(goals.size());
+  for (const auto & goal : goals) {
+    if (costmap->worldToMap(goal.pose.position.x, goal.pose.position.y, mx, my)) {
+      goal_coords.emplace_back(static_cast<float>(mx), static_cast<float>(my));
+    } else {
+      goal_coords.emplace_back(-1.0f, -1.0f);
+    }
+  }
+
+  // Compute plans to all goals with a single search
+  std::vector<Node2D::CoordinateVector> paths;
+  std::vector<float> path_costs;
+  int num_iterations = 0;
+  std::string error;
+  try {
+    if (!_a_star->createPathsToGoals(goal_coords, paths, path_costs, num_iterations)) {
+      if (_cancel_requested->load()) {
+        error = std::string("planning was canceled");
+      } else if (num_iterations < _a_star->getMaxIterations()) {
+        error = std::string("no valid path found to any goal");
+      } else {
+        error = std::string("exceeded maximum iterations");
+      }
+    }
+  } catch (const std::runtime_error & e) {
+    error = "invalid use: ";
+    error += e.what();
+  }
+
+  std::vector<nav_msgs::msg::Path> plans(goals.size());
+  costs.assign(goals.size(), -1.0);
+  if (!error.empty()) {
+    RCLCPP_WARN(
+      _logger,
+      "%s: failed to create plans, %s.",
+      _name.c_str(), error.c_str());
+    return plans;
+  }
+
+  // Share the time left after the search between the paths to smooth, so the first
+  // are not given all of it. Time a path leaves unused goes to those after it.
+  auto paths_left = std::count_if(
+    paths.begin(), paths.end(),
+    [](const Node2D::CoordinateVector & path) {return !path.empty();});
+  for (unsigned int i = 0; i != goals.size(); i++) {
+    if (!paths[i].empty()) {
+      duration<double> elapsed = duration_cast<duration<double>>(steady_clock::now() - a);
+      const double time_remaining = _max_planning_time - elapsed.count();
+      plans[i] = createPlanFromPath(paths[i], costmap, time_remaining / paths_left--);
+      costs[i] = static_cast<double>(path_costs[i]);
+    }
+  }
+
+  return plans;
+}
+
+nav_msgs::msg::Path SmacPlanner2D::createPlanFromPath(
+  const Node2D::CoordinateVector & path,
+  nav2_costmap_2d::Costmap2D * costmap,
+  const double & max_smoothing_time)
+{
+  // Setup message
+  nav_msgs::msg::Path plan;
+  plan.header.stamp = _clock->now();
+  plan.header.frame_id = _global_frame;
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header = plan.header;
+  pose.pose.position.z = 0.0;
+  pose.pose.orientation.x = 0.0;
+  pose.pose.orientation.y = 0.0;
+  pose.pose.orientation.z = 0.0;
+  pose.pose.orientation.w = 1.0;
+
   // Convert to world coordinates and downsample path for smoothing if necesssary
   // We're going to downsample by 4x to give terms room to move.
   const int downsample_ratio = 4;
@@ -277,20 +480,10 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
 
   // If not smoothing or too short to smooth, return path
   if (!_smoother || path_world.size() < 4) {
-#ifdef BENCHMARK_TESTING
-    steady_clock::time_point b = steady_clock::now();
-    duration<double> time_span = duration_cast<duration<double>>(b - a);
-    std::cout << "It took " << time_span.count() * 1000 <<
-      " milliseconds with " << num_iterations << " iterations." << std::endl;
-#endif
     return plan;
   }
 
-  // Find how much time we have left to do smoothing
-  steady_clock::time_point b = steady_clock::now();
-  duration<double> time_span = duration_cast<duration<double>>(b - a);
-  double time_remaining = _max_planning_time - static_cast<double>(time_span.count());
-  _smoother_params.max_time = std::min(time_remaining, _optimizer_params.max_time);
+  _smoother_params.max_time = std::min(max_smoothing_time, _optimizer_params.max_time);
 
   // Smooth plan
   if (!_smoother->smooth(path_world, costmap, _smoother_params)) {
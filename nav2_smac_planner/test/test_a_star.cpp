@@ -45,7 +45,7 @@ TEST(AStarTest, test_a_star_2d)
   int it_on_approach = 10;
   int num_it = 0;
 
-  a_star.initialize(false, max_iterations, it_on_approach);
+  a_star.initialize(false, max_iterations, it_on_approach, false, false);
   a_star.setFootprint(nav2_costmap_2d::Footprint(), true);
 
   nav2_costmap_2d::Costmap2D * costmapA =
@@ -82,7 +82,7 @@ TEST(AStarTest, test_a_star_2d)
   // failure cases with invalid inputs
   nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star_2(
     nav2_smac_planner::MotionModel::VON_NEUMANN, info);
-  a_star_2.initialize(false, max_iterations, it_on_approach);
+  a_star_2.initialize(false, max_iterations, it_on_approach, false, false);
   a_star_2.setFootprint(nav2_costmap_2d::Footprint(), true);
   num_it = 0;
   EXPECT_THROW(a_star_2.createPath(path, num_it, tolerance), std::runtime_error);
@@ -118,6 +118,89 @@ TEST(AStarTest, test_a_star_2d)
   delete costmapA;
 }
 
+TEST(AStarTest, test_a_star_2d_many_goals)
+{
+  nav2_smac_planner::SearchInfo info;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star(
+    nav2_smac_planner::MotionModel::MOORE, info);
+  int max_iterations = 100000;
+  int it_on_approach = 10;
+  int num_it = 0;
+
+  a_star.initialize(false, max_iterations, it_on_approach, false, false);
+  a_star.setFootprint(nav2_costmap_2d::Footprint(), true);
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  a_star.createGraph(costmapA->getSizeInCellsX(), costmapA->getSizeInCellsY(), 1, costmapA);
+  a_star.setStart(20u, 20u, 0);
+
+  // Goals near and far, at the start, in lethal space, off the map and on its far edge
+  nav2_smac_planner::Node2D::CoordinateVector goals = {
+    {80.0f, 80.0f}, {25.0f, 20.0f}, {20.0f, 20.0f}, {50.0f, 50.0f}, {150.0f, 20.0f},
+    {99.0f, 0.0f}, {25.0f, 20.0f}};
+  std::vector<nav2_smac_planner::Node2D::CoordinateVector> paths;
+  std::vector<float> costs;
+  EXPECT_TRUE(a_star.createPathsToGoals(goals, paths, costs, num_it));
+  ASSERT_EQ(paths.size(), goals.size());
+  ASSERT_EQ(costs.size(), goals.size());
+
+  // Unreachable goals
+  EXPECT_TRUE(paths[3].empty());
+  EXPECT_EQ(costs[3], -1.0f);
+  EXPECT_TRUE(paths[4].empty());
+  EXPECT_EQ(costs[4], -1.0f);
+
+  // The start itself
+  ASSERT_EQ(paths[2].size(), 1u);
+  EXPECT_EQ(costs[2], 0.0f);
+
+  // Reachable goals have collision free paths of adjacent cells ending at them, from the start
+  for (unsigned int i : {0u, 1u, 5u, 6u}) {
+    ASSERT_FALSE(paths[i].empty());
+    EXPECT_GT(costs[i], 0.0f);
+    EXPECT_EQ(paths[i].front().x, goals[i].x);
+    EXPECT_EQ(paths[i].front().y, goals[i].y);
+    EXPECT_LE(std::abs(paths[i].back().x - 20.0f), 1.0f);
+    EXPECT_LE(std::abs(paths[i].back().y - 20.0f), 1.0f);
+    for (unsigned int j = 0; j != paths[i].size(); j++) {
+      EXPECT_EQ(costmapA->getCost(paths[i][j].x, paths[i][j].y), 0);
+      if (j > 0) {
+        EXPECT_LE(std::abs(paths[i][j].x - paths[i][j - 1].x), 1.0f);
+        EXPECT_LE(std::abs(paths[i][j].y - paths[i][j - 1].y), 1.0f);
+      }
+    }
+  }
+  EXPECT_LT(costs[1], costs[0]);
+  EXPECT_EQ(costs[1], costs[6]);
+
+  // A single A* search to the far goal finds a path of the same length
+  a_star.createGraph(costmapA->getSizeInCellsX(), costmapA->getSizeInCellsY(), 1, costmapA);
+  a_star.setStart(20u, 20u, 0);
+  a_star.setGoal(80u, 80u, 0);
+  nav2_smac_planner::Node2D::CoordinateVector path;
+  num_it = 0;
+  EXPECT_TRUE(a_star.createPath(path, num_it, 0.0));
+  EXPECT_EQ(path.size(), paths[0].size());
+
+  // Only Node2D is supported
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeSE2> a_star_se2(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  nav2_smac_planner::NodeSE2::CoordinateVector goals_se2;
+  std::vector<nav2_smac_planner::NodeSE2::CoordinateVector> paths_se2;
+  EXPECT_THROW(
+    a_star_se2.createPathsToGoals(goals_se2, paths_se2, costs, num_it), std::runtime_error);
+
+  delete costmapA;
+}
+
 TEST(AStarTest, test_a_star_se2)
 {
   nav2_smac_planner::SearchInfo info;
@@ -133,7 +216,7 @@ TEST(AStarTest, test_a_star_se2)
   int it_on_approach = 10;
   int num_it = 0;
 
-  a_star.initialize(false, max_iterations, it_on_approach);
+  a_star.initialize(false, max_iterations, it_on_approach, false, false);
   a_star.setFootprint(nav2_costmap_2d::Footprint(), true);
 
   nav2_costmap_2d::Costmap2D * costmapA =
@@ -163,6 +246,523 @@ TEST(AStarTest, test_a_star_se2)
   delete costmapA;
 }
 
+TEST(AStarTest, test_a_star_parallel_expansion)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 1.2;
+  info.non_straight_penalty = 1.4;
+  info.reverse_penalty = 2.1;
+  info.minimum_turning_radius = 2.0;  // in grid coordinates
+  int max_iterations = 10000;
+  float tolerance = 10.0;
+  int it_on_approach = 10;
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross, with a band of possibly inscribed
+  // cost around it so the full footprint is checked
+  for (unsigned int i = 35; i <= 65; ++i) {
+    for (unsigned int j = 35; j <= 65; ++j) {
+      costmapA->setCost(i, j, 140);
+    }
+  }
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  nav2_costmap_2d::Footprint footprint;
+  geometry_msgs::msg::Point p;
+  p.x = -0.15;
+  p.y = -0.1;
+  footprint.push_back(p);
+  p.x = 0.15;
+  footprint.push_back(p);
+  p.y = 0.1;
+  footprint.push_back(p);
+  p.x = -0.15;
+  footprint.push_back(p);
+
+  // the same search with 1 and multiple expansion threads must be identical
+  std::vector<nav2_smac_planner::NodeSE2::CoordinateVector> paths;
+  std::vector<int> iterations;
+  for (int num_threads : {1, 4}) {
+    info.num_expansion_threads = num_threads;
+    nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeSE2> a_star(
+      nav2_smac_planner::MotionModel::REEDS_SHEPP, info);
+    a_star.initialize(false, max_iterations, it_on_approach, false, false);
+    a_star.setFootprint(footprint, false);
+    a_star.createGraph(
+      costmapA->getSizeInCellsX(), costmapA->getSizeInCellsY(), 72, costmapA);
+    a_star.setStart(10u, 10u, 0u);
+    a_star.setGoal(80u, 80u, 40u);
+
+    int num_it = 0;
+    nav2_smac_planner::NodeSE2::CoordinateVector path;
+    EXPECT_TRUE(a_star.createPath(path, num_it, tolerance));
+    paths.push_back(path);
+    iterations.push_back(num_it);
+  }
+
+  EXPECT_EQ(iterations[0], iterations[1]);
+  ASSERT_EQ(paths[0].size(), paths[1].size());
+  for (unsigned int i = 0; i != paths[0].size(); i++) {
+    EXPECT_EQ(paths[0][i].x, paths[1][i].x);
+    EXPECT_EQ(paths[0][i].y, paths[1][i].y);
+    EXPECT_EQ(paths[0][i].theta, paths[1][i].theta);
+  }
+
+  delete costmapA;
+}
+
+TEST(AStarTest, test_a_star_node_pool)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 1.2;
+  info.non_straight_penalty = 1.4;
+  info.reverse_penalty = 2.1;
+  info.minimum_turning_radius = 2.0;  // in grid coordinates
+  int max_iterations = 10000;
+  float tolerance = 10.0;
+  int it_on_approach = 10;
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  // 2D search must give identical results with either graph backend
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star_hash(
+    nav2_smac_planner::MotionModel::MOORE, info);
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star_pool(
+    nav2_smac_planner::MotionModel::MOORE, info);
+  a_star_hash.initialize(false, max_iterations, it_on_approach, false, false);
+  a_star_pool.initialize(false, max_iterations, it_on_approach, true, false);
+
+  nav2_smac_planner::Node2D::CoordinateVector path_hash, path_pool;
+  int num_it_hash = 0, num_it_pool = 0;
+  a_star_hash.createGraph(100u, 100u, 1u, costmapA);
+  a_star_hash.setStart(20u, 20u, 0);
+  a_star_hash.setGoal(80u, 80u, 0);
+  EXPECT_TRUE(a_star_hash.createPath(path_hash, num_it_hash, 0.0));
+
+  // Plan twice to make sure nodes from the prior search are reset
+  for (unsigned int i = 0; i != 2; i++) {
+    path_pool.clear();
+    num_it_pool = 0;
+    a_star_pool.createGraph(100u, 100u, 1u, costmapA);
+    a_star_pool.setStart(20u, 20u, 0);
+    a_star_pool.setGoal(80u, 80u, 0);
+    EXPECT_TRUE(a_star_pool.createPath(path_pool, num_it_pool, 0.0));
+    EXPECT_EQ(num_it_pool, num_it_hash);
+    ASSERT_EQ(path_pool.size(), path_hash.size());
+    for (unsigned int j = 0; j != path_pool.size(); j++) {
+      EXPECT_EQ(path_pool[j].x, path_hash[j].x);
+      EXPECT_EQ(path_pool[j].y, path_hash[j].y);
+    }
+  }
+
+  // The pool only addresses the graph's nodes, so off-map endpoints are rejected
+  EXPECT_THROW(a_star_pool.setStart(0u, 100u, 0), std::runtime_error);
+  EXPECT_THROW(a_star_pool.setGoal(0u, 100u, 0), std::runtime_error);
+
+  // SE2 search must give identical results with either graph backend
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeSE2> a_star_se2_hash(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeSE2> a_star_se2_pool(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  a_star_se2_hash.initialize(false, max_iterations, it_on_approach, false, false);
+  a_star_se2_pool.initialize(false, max_iterations, it_on_approach, true, false);
+  a_star_se2_hash.setFootprint(nav2_costmap_2d::Footprint(), true);
+  a_star_se2_pool.setFootprint(nav2_costmap_2d::Footprint(), true);
+
+  nav2_smac_planner::NodeSE2::CoordinateVector path_se2_hash, path_se2_pool;
+  num_it_hash = 0;
+  a_star_se2_hash.createGraph(100u, 100u, 72u, costmapA);
+  a_star_se2_hash.setStart(10u, 10u, 0u);
+  a_star_se2_hash.setGoal(80u, 80u, 40u);
+  EXPECT_TRUE(a_star_se2_hash.createPath(path_se2_hash, num_it_hash, tolerance));
+
+  for (unsigned int i = 0; i != 2; i++) {
+    path_se2_pool.clear();
+    num_it_pool = 0;
+    a_star_se2_pool.createGraph(100u, 100u, 72u, costmapA);
+    a_star_se2_pool.setStart(10u, 10u, 0u);
+    a_star_se2_pool.setGoal(80u, 80u, 40u);
+    EXPECT_TRUE(a_star_se2_pool.createPath(path_se2_pool, num_it_pool, tolerance));
+    EXPECT_EQ(num_it_pool, num_it_hash);
+    ASSERT_EQ(path_se2_pool.size(), path_se2_hash.size());
+    for (unsigned int j = 0; j != path_se2_pool.size(); j++) {
+      EXPECT_NEAR(path_se2_pool[j].x, path_se2_hash[j].x, 1e-6);
+      EXPECT_NEAR(path_se2_pool[j].y, path_se2_hash[j].y, 1e-6);
+      EXPECT_NEAR(path_se2_pool[j].theta, path_se2_hash[j].theta, 1e-6);
+    }
+  }
+  EXPECT_THROW(a_star_se2_pool.setStart(0u, 100u, 0u), std::runtime_error);
+  EXPECT_THROW(a_star_se2_pool.setGoal(0u, 100u, 0u), std::runtime_error);
+
+  delete costmapA;
+}
+
+TEST(AStarTest, test_a_star_indexed_heap)
+{
+  nav2_smac_planner::SearchInfo info;
+  int max_iterations = 10000;
+  int it_on_approach = 10;
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross, with uneven costs around it
+  // such that nodes are often found again with lower costs once queued
+  for (unsigned int i = 0; i != 100; ++i) {
+    for (unsigned int j = 0; j != 100; ++j) {
+      costmapA->setCost(i, j, (i * 7 + j * 13) % 150);
+    }
+  }
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star_queue(
+    nav2_smac_planner::MotionModel::MOORE, info);
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star_heap(
+    nav2_smac_planner::MotionModel::MOORE, info);
+  a_star_queue.initialize(false, max_iterations, it_on_approach, false, false);
+  a_star_heap.initialize(false, max_iterations, it_on_approach, false, true);
+
+  nav2_smac_planner::Node2D::CoordinateVector path_queue, path_heap;
+  int num_it_queue = 0, num_it_heap = 0;
+  a_star_queue.createGraph(100u, 100u, 1u, costmapA);
+  a_star_queue.setStart(20u, 20u, 0);
+  a_star_queue.setGoal(80u, 80u, 0);
+  EXPECT_TRUE(a_star_queue.createPath(path_queue, num_it_queue, 0.0));
+
+  a_star_heap.createGraph(100u, 100u, 1u, costmapA);
+  a_star_heap.setStart(20u, 20u, 0);
+  a_star_heap.setGoal(80u, 80u, 0);
+  EXPECT_TRUE(a_star_heap.createPath(path_heap, num_it_heap, 0.0));
+
+  // Both are optimal, but nodes are never queued more than once with decrease-key
+  EXPECT_EQ(path_heap.size(), path_queue.size());
+  EXPECT_LT(a_star_heap.getPeakQueueSize(), a_star_queue.getPeakQueueSize());
+  for (unsigned int i = 0; i != path_heap.size(); i++) {
+    EXPECT_LT(costmapA->getCost(path_heap[i].x, path_heap[i].y), 254);
+  }
+
+  // Re-running the search without rebuilding the graph is still valid
+  path_heap.clear();
+  num_it_heap = 0;
+  a_star_heap.createGraph(100u, 100u, 1u, costmapA);
+  a_star_heap.setStart(20u, 20u, 0);
+  a_star_heap.setGoal(80u, 80u, 0);
+  EXPECT_TRUE(a_star_heap.createPath(path_heap, num_it_heap, 0.0));
+  EXPECT_EQ(path_heap.size(), path_queue.size());
+
+  delete costmapA;
+}
+
+TEST(AStarTest, test_a_star_node_pool_resize)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 1.2;
+  info.non_straight_penalty = 1.4;
+  info.reverse_penalty = 2.1;
+  info.minimum_turning_radius = 2.0;  // in grid coordinates
+  int max_iterations = 10000;
+  int it_on_approach = 10;
+
+  // The open set left queued by each search points into the pool, which is reallocated
+  // when the size of the costmap changes between searches
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  nav2_costmap_2d::Costmap2D * costmapB =
+    new nav2_costmap_2d::Costmap2D(60, 40, 0.1, 0.0, 0.0, 0);
+
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star(
+    nav2_smac_planner::MotionModel::MOORE, info);
+  a_star.initialize(false, max_iterations, it_on_approach, true, true);
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeSE2> a_star_se2(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  a_star_se2.initialize(false, max_iterations, it_on_approach, true, true);
+  a_star_se2.setFootprint(nav2_costmap_2d::Footprint(), true);
+
+  for (auto costmap : {costmapA, costmapB, costmapA}) {
+    nav2_smac_planner::Node2D::CoordinateVector path;
+    int num_it = 0;
+    a_star.createGraph(costmap->getSizeInCellsX(), costmap->getSizeInCellsY(), 1u, costmap);
+    a_star.setStart(10u, 10u, 0);
+    a_star.setGoal(50u, 30u, 0);
+    EXPECT_TRUE(a_star.createPath(path, num_it, 0.0));
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(path.front().x, 50.0f);
+    EXPECT_EQ(path.front().y, 30.0f);
+
+    nav2_smac_planner::NodeSE2::CoordinateVector path_se2;
+    num_it = 0;
+    a_star_se2.createGraph(costmap->getSizeInCellsX(), costmap->getSizeInCellsY(), 72u, costmap);
+    a_star_se2.setStart(10u, 10u, 0u);
+    a_star_se2.setGoal(50u, 30u, 0u);
+    EXPECT_TRUE(a_star_se2.createPath(path_se2, num_it, 10.0));
+    EXPECT_FALSE(path_se2.empty());
+  }
+
+  delete costmapA;
+  delete costmapB;
+}
+
+TEST(AStarTest, test_a_star_anytime_and_bidirectional)
+{
+  nav2_smac_planner::SearchInfo info;
+  int max_iterations = 100000;
+  int it_on_approach = 10;
+
+  // large enough that paths aren't cheaper wrapping around the edges of the grid
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(200, 200, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross, with uneven costs around it
+  for (unsigned int i = 0; i != 200; ++i) {
+    for (unsigned int j = 0; j != 200; ++j) {
+      costmapA->setCost(i, j, (i * 7 + j * 13) % 150);
+    }
+  }
+  for (unsigned int i = 90; i <= 110; ++i) {
+    for (unsigned int j = 90; j <= 110; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  // cost of a path is the cost of each cell entered after the start
+  auto path_cost = [&](const nav2_smac_planner::Node2D::CoordinateVector & path) {
+      float cost = 0.0;
+      for (const auto & pt : path) {
+        cost += nav2_smac_planner::Node2D::neutral_cost + 0.8 * costmapA->getCost(pt.x, pt.y);
+      }
+      return cost;
+    };
+
+  auto plan = [&](
+    const nav2_smac_planner::SearchMode & mode, const double & anytime_max_time,
+    nav2_smac_planner::Node2D::CoordinateVector & path, int & num_it,
+    const float & weight_decrement = 1.0f) {
+      nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star(
+        nav2_smac_planner::MotionModel::MOORE, info);
+      a_star.initialize(false, max_iterations, it_on_approach, false, false);
+      a_star.setSearchMode(mode, 5.0, weight_decrement, anytime_max_time);
+      a_star.createGraph(200u, 200u, 1u, costmapA);
+      a_star.setStart(70u, 80u, 0);
+      a_star.setGoal(130u, 120u, 0);
+      num_it = 0;
+      return a_star.createPath(path, num_it, 0.0);
+    };
+
+  nav2_smac_planner::Node2D::CoordinateVector path_astar, path_weighted, path_anytime, path_bidir;
+  int num_it_astar, num_it_weighted, num_it_anytime, num_it_bidir;
+  EXPECT_TRUE(plan(nav2_smac_planner::SearchMode::ASTAR, 0.0, path_astar, num_it_astar));
+
+  // With no time to improve, anytime returns its first, inflated heuristic, path quickly
+  EXPECT_TRUE(
+    plan(nav2_smac_planner::SearchMode::ANYTIME, 0.0, path_weighted, num_it_weighted));
+  EXPECT_LT(num_it_weighted, num_it_astar);
+  EXPECT_GE(path_cost(path_weighted), path_cost(path_astar));
+
+  // With time to improve, it reaches a heuristic weight of 1, so as good as A*
+  EXPECT_TRUE(
+    plan(nav2_smac_planner::SearchMode::ANYTIME, 10.0, path_anytime, num_it_anytime));
+  EXPECT_LE(path_cost(path_anytime), path_cost(path_weighted));
+  EXPECT_NEAR(path_cost(path_anytime), path_cost(path_astar), 0.01 * path_cost(path_astar));
+
+  // A non-positive weight decrement improves straight to a heuristic weight of 1
+  path_anytime.clear();
+  EXPECT_TRUE(
+    plan(nav2_smac_planner::SearchMode::ANYTIME, 10.0, path_anytime, num_it_anytime, 0.0f));
+  EXPECT_NEAR(path_cost(path_anytime), path_cost(path_astar), 0.01 * path_cost(path_astar));
+
+  // Bidirectional paths join the searches, from goal back to the start
+  EXPECT_TRUE(plan(nav2_smac_planner::SearchMode::BIDIRECTIONAL, 0.0, path_bidir, num_it_bidir));
+  EXPECT_EQ(path_bidir.front().x, 130);
+  EXPECT_EQ(path_bidir.front().y, 120);
+  EXPECT_LE(fabs(path_bidir.back().x - 70), 1);
+  EXPECT_LE(fabs(path_bidir.back().y - 80), 1);
+  for (unsigned int i = 0; i != path_bidir.size(); i++) {
+    EXPECT_LT(costmapA->getCost(path_bidir[i].x, path_bidir[i].y), 254);
+    if (i > 0) {
+      EXPECT_LE(fabs(path_bidir[i].x - path_bidir[i - 1].x), 1);
+      EXPECT_LE(fabs(path_bidir[i].y - path_bidir[i - 1].y), 1);
+    }
+  }
+  EXPECT_NEAR(path_cost(path_bidir), path_cost(path_astar), 0.05 * path_cost(path_astar));
+
+  // Bidirectional search is not available for SE2 nodes
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeSE2> a_star_se2(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  a_star_se2.initialize(false, max_iterations, it_on_approach, false, false);
+  a_star_se2.setSearchMode(nav2_smac_planner::SearchMode::BIDIRECTIONAL, 1.0, 0.0, 0.0);
+  a_star_se2.setFootprint(nav2_costmap_2d::Footprint(), true);
+  a_star_se2.createGraph(200u, 200u, 72u, costmapA);
+  a_star_se2.setStart(70u, 80u, 0);
+  a_star_se2.setGoal(130u, 120u, 0);
+  nav2_smac_planner::NodeSE2::CoordinateVector path_se2;
+  EXPECT_THROW(a_star_se2.createPath(path_se2, num_it_bidir, 0.0), std::runtime_error);
+
+  delete costmapA;
+}
+
+TEST(AStarTest, test_a_star_planning_limits)
+{
+  nav2_smac_planner::SearchInfo info;
+  int max_iterations = 1000000;
+  int it_on_approach = 10;
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(200, 200, 0.1, 0.0, 0.0, 0);
+  for (unsigned int i = 0; i != 200; ++i) {
+    for (unsigned int j = 0; j != 200; ++j) {
+      costmapA->setCost(i, j, (i * 7 + j * 13) % 150);
+    }
+  }
+
+  auto cancel_requested = std::make_shared<std::atomic<bool>>(false);
+  auto plan = [&](
+    const nav2_smac_planner::SearchMode & mode, const double & max_planning_time,
+    nav2_smac_planner::Node2D::CoordinateVector & path, bool & is_partial) {
+      nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star(
+        nav2_smac_planner::MotionModel::MOORE, info);
+      a_star.initialize(false, max_iterations, it_on_approach, false, false);
+      a_star.setSearchMode(mode, 1.0, 0.0, 0.0);
+      a_star.setPlanningLimits(max_planning_time, cancel_requested);
+      a_star.createGraph(200u, 200u, 1u, costmapA);
+      a_star.setStart(20u, 20u, 0);
+      a_star.setGoal(180u, 180u, 0);
+      int num_it = 0;
+      path.clear();
+      const bool result = a_star.createPath(path, num_it, 0.0);
+      is_partial = a_star.isPathPartial();
+      return result;
+    };
+
+  // Without a time limit, the goal is reached
+  nav2_smac_planner::Node2D::CoordinateVector path;
+  bool is_partial = true;
+  EXPECT_TRUE(plan(nav2_smac_planner::SearchMode::ASTAR, 0.0, path, is_partial));
+  EXPECT_FALSE(is_partial);
+  EXPECT_EQ(path.front().x, 180);
+  EXPECT_EQ(path.front().y, 180);
+
+  // Out of time, the path ends at the closest point to the goal found
+  for (auto mode : {nav2_smac_planner::SearchMode::ASTAR,
+      nav2_smac_planner::SearchMode::BIDIRECTIONAL})
+  {
+    EXPECT_TRUE(plan(mode, 1e-9, path, is_partial));
+    EXPECT_TRUE(is_partial);
+    EXPECT_GT(path.size(), 1u);
+    EXPECT_FALSE(path.front().x == 180 && path.front().y == 180);
+    EXPECT_LT(
+      hypot(path.front().x - 180.0, path.front().y - 180.0),
+      hypot(20.0 - 180.0, 20.0 - 180.0));
+  }
+
+  // Once canceled, no path is returned
+  cancel_requested->store(true);
+  EXPECT_FALSE(plan(nav2_smac_planner::SearchMode::ASTAR, 0.0, path, is_partial));
+  EXPECT_FALSE(is_partial);
+  EXPECT_FALSE(plan(nav2_smac_planner::SearchMode::BIDIRECTIONAL, 1e-9, path, is_partial));
+
+  delete costmapA;
+}
+
+TEST(AStarTest, test_a_star_search_corridor)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 0.1;
+  info.non_straight_penalty = 1.1;
+  info.reverse_penalty = 2.0;
+  info.minimum_turning_radius = 4;  // in grid coordinates
+  int max_iterations = 100000;
+  int it_on_approach = 10;
+
+  // island in the middle of lethal cost to go around
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  // corridor only passing above the island
+  std::vector<bool> corridor(100 * 100, true);
+  for (unsigned int j = 0; j != 62; ++j) {
+    for (unsigned int i = 35; i <= 65; ++i) {
+      corridor[j * 100 + i] = false;
+    }
+  }
+
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star(
+    nav2_smac_planner::MotionModel::MOORE, info);
+  a_star.initialize(false, max_iterations, it_on_approach, false, false);
+  nav2_smac_planner::Node2D::CoordinateVector path;
+  int num_it = 0;
+  a_star.createGraph(100u, 100u, 1u, costmapA);
+  a_star.setStart(20u, 45u, 0);
+  a_star.setGoal(80u, 45u, 0);
+  a_star.setSearchCorridor(corridor);
+  EXPECT_TRUE(a_star.createPath(path, num_it, 0.0));
+  for (auto & pt : path) {
+    EXPECT_TRUE(corridor[static_cast<unsigned int>(pt.y) * 100 + pt.x]);
+  }
+
+  // SE2 paths, including analytic expansions, also stay within the corridor
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeSE2> a_star_se2(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  a_star_se2.initialize(false, max_iterations, it_on_approach, false, false);
+  a_star_se2.setFootprint(nav2_costmap_2d::Footprint(), true);
+  nav2_smac_planner::NodeSE2::CoordinateVector path_se2;
+  num_it = 0;
+  a_star_se2.createGraph(100u, 100u, 72u, costmapA);
+  a_star_se2.setStart(20u, 45u, 0);
+  a_star_se2.setGoal(80u, 45u, 0);
+  a_star_se2.setSearchCorridor(corridor);
+  EXPECT_TRUE(a_star_se2.createPath(path_se2, num_it, 0.0));
+  for (auto & pt : path_se2) {
+    EXPECT_TRUE(
+      corridor[static_cast<unsigned int>(pt.y) * 100 + static_cast<unsigned int>(pt.x)]);
+  }
+
+  // No path if the corridor doesn't reach the goal
+  corridor.assign(100 * 100, false);
+  for (unsigned int j = 35; j != 55; ++j) {
+    for (unsigned int i = 10; i != 30; ++i) {
+      corridor[j * 100 + i] = true;
+    }
+  }
+  path.clear();
+  num_it = 0;
+  a_star.createGraph(100u, 100u, 1u, costmapA);
+  a_star.setStart(20u, 45u, 0);
+  a_star.setGoal(80u, 45u, 0);
+  a_star.setSearchCorridor(corridor);
+  EXPECT_FALSE(a_star.createPath(path, num_it, 0.0));
+
+  // Recreating the graph searches it all again
+  num_it = 0;
+  a_star.createGraph(100u, 100u, 1u, costmapA);
+  a_star.setStart(20u, 45u, 0);
+  a_star.setGoal(80u, 45u, 0);
+  EXPECT_TRUE(a_star.createPath(path, num_it, 0.0));
+
+  // Corridor must match the graph
+  EXPECT_THROW(a_star.setSearchCorridor(std::vector<bool>(10, true)), std::runtime_error);
+
+  delete costmapA;
+}
+
 TEST(AStarTest, test_constants)
 {
   nav2_smac_planner::MotionModel mm = nav2_smac_planner::MotionModel::UNKNOWN;  // unknown
@@ -185,4 +785,92 @@ TEST(AStarTest, test_constants)
     nav2_smac_planner::fromString(
       "REEDS_SHEPP"), nav2_smac_planner::MotionModel::REEDS_SHEPP);
   EXPECT_EQ(nav2_smac_planner::fromString("NONE"), nav2_smac_planner::MotionModel::UNKNOWN);
+
+  EXPECT_EQ(nav2_smac_planner::toString(nav2_smac_planner::SearchMode::ASTAR), std::string("A*"));
+  EXPECT_EQ(
+    nav2_smac_planner::toString(nav2_smac_planner::SearchMode::ANYTIME), std::string("Anytime"));
+  EXPECT_EQ(
+    nav2_smac_planner::toString(
+      nav2_smac_planner::SearchMode::BIDIRECTIONAL), std::string("Bidirectional"));
+  EXPECT_EQ(
+    nav2_smac_planner::searchModeFromString("ANYTIME"), nav2_smac_planner::SearchMode::ANYTIME);
+  EXPECT_EQ(
+    nav2_smac_planner::searchModeFromString("NONE"), nav2_smac_planner::SearchMode::UNKNOWN);
+}
+
+TEST(AStarTest, test_a_star_plan_repair)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 1.2;
+  info.non_straight_penalty = 1.4;
+  info.reverse_penalty = 2.1;
+  info.minimum_turning_radius = 2.0;  // in grid coordinates
+  unsigned int size_theta = 72;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeSE2> a_star(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  int max_iterations = 10000;
+  float tolerance = 10.0;
+  int it_on_approach = 10;
+  int num_it = 0;
+
+  a_star.initialize(false, max_iterations, it_on_approach, false, false);
+  a_star.setFootprint(nav2_costmap_2d::Footprint(), true);
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  a_star.createGraph(
+    costmapA->getSizeInCellsX(), costmapA->getSizeInCellsY(), size_theta, costmapA);
+  a_star.setStart(10u, 10u, 0u);
+  a_star.setGoal(80u, 80u, 40u);
+  nav2_smac_planner::NodeSE2::CoordinateVector path;
+  EXPECT_TRUE(a_star.createPath(path, num_it, tolerance));
+  ASSERT_GT(path.size(), 10u);
+
+  // robot has moved a little along the path and off to its side
+  const nav2_smac_planner::NodeSE2::Coordinates & passed = path[path.size() - 4];
+  nav2_smac_planner::NodeSE2::Coordinates start(passed.x, passed.y + 1.0f, passed.theta);
+  nav2_smac_planner::NodeSE2::CoordinateVector repaired;
+  a_star.createGraph(
+    costmapA->getSizeInCellsX(), costmapA->getSizeInCellsY(), size_theta, costmapA);
+  EXPECT_TRUE(a_star.repairPath(start, path, 3.0f, repaired));
+  EXPECT_EQ(repaired.front().x, path.front().x);
+  EXPECT_EQ(repaired.front().y, path.front().y);
+  // like created paths, ends next to the start without including it
+  const float start_distance =
+    std::hypot(repaired.back().x - start.x, repaired.back().y - start.y);
+  EXPECT_GT(start_distance, 0.0f);
+  EXPECT_LT(start_distance, 2.0f * std::sqrt(2.0f));
+  EXPECT_LT(repaired.size(), path.size());
+  for (unsigned int i = 0; i != repaired.size(); i++) {
+    EXPECT_EQ(costmapA->getCost(repaired[i].x, repaired[i].y), 0);
+  }
+
+  // too far from the previous path
+  nav2_smac_planner::NodeSE2::Coordinates far_start(10.0f, 90.0f, 0.0f);
+  EXPECT_FALSE(a_star.repairPath(far_start, path, 3.0f, repaired));
+
+  // previous path is now blocked ahead
+  const nav2_smac_planner::NodeSE2::Coordinates & blocked = path[path.size() / 2];
+  costmapA->setCost(blocked.x, blocked.y, 254);
+  a_star.createGraph(
+    costmapA->getSizeInCellsX(), costmapA->getSizeInCellsY(), size_theta, costmapA);
+  EXPECT_FALSE(a_star.repairPath(start, path, 3.0f, repaired));
+
+  // not supported by 2D search
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::Node2D> a_star_2d(
+    nav2_smac_planner::MotionModel::MOORE, info);
+  nav2_smac_planner::Node2D::CoordinateVector path_2d, repaired_2d;
+  path_2d.emplace_back(1.0f, 1.0f);
+  path_2d.emplace_back(2.0f, 2.0f);
+  EXPECT_FALSE(
+    a_star_2d.repairPath(nav2_smac_planner::Node2D::Coordinates(1.0f, 1.0f), path_2d, 3.0f,
+    repaired_2d));
+
+  delete costmapA;
 }
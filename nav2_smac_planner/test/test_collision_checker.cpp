@@ -169,3 +169,77 @@ TEST(collision_footprint, test_point_and_line_cost)
   EXPECT_NEAR(right_value, 254.0, 0.001);
   delete costmap_;
 }
+
+TEST(collision_footprint, test_footprint_masks)
+{
+  nav2_costmap_2d::Costmap2D * costmap_ = new nav2_costmap_2d::Costmap2D(
+    100, 100, 0.1, 0, 0, 0);
+
+  // possibly inscribed everywhere so the footprint is always checked,
+  // with scattered obstacles
+  srand(7);
+  for (unsigned int i = 0; i != 100; ++i) {
+    for (unsigned int j = 0; j != 100; ++j) {
+      costmap_->setCost(i, j, rand() % 40 == 0 ? 254 : 128 + rand() % 100);
+    }
+  }
+
+  geometry_msgs::msg::Point p1;
+  p1.x = -0.43;
+  p1.y = 0.27;
+  geometry_msgs::msg::Point p2;
+  p2.x = 0.61;
+  p2.y = 0.27;
+  geometry_msgs::msg::Point p3;
+  p3.x = 0.61;
+  p3.y = -0.27;
+  geometry_msgs::msg::Point p4;
+  p4.x = -0.43;
+  p4.y = -0.27;
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  unsigned int num_quantizations = 72;
+  float bin_size = 2.0 * M_PI / num_quantizations;
+  nav2_smac_planner::GridCollisionChecker exact_checker(costmap_);
+  exact_checker.setFootprint(footprint, false /*use footprint*/);
+  nav2_smac_planner::GridCollisionChecker mask_checker(costmap_, num_quantizations);
+  mask_checker.setFootprint(footprint, false /*use footprint*/);
+
+  // For poses in the center of cells and angle bins, the masks must agree
+  // exactly with rasterizing the footprint, including off the edges of the map
+  unsigned int num_collisions = 0;
+  for (unsigned int x = 0; x < 100; x += 3) {
+    for (unsigned int y = 0; y < 100; y += 3) {
+      for (unsigned int bin = 0; bin < num_quantizations; bin += 5) {
+        const bool in_collision = exact_checker.inCollision(x, y, bin * bin_size, false);
+        EXPECT_EQ(in_collision, mask_checker.inCollision(x, y, bin * bin_size, false));
+        if (!in_collision) {
+          EXPECT_EQ(exact_checker.getCost(), mask_checker.getCost());
+        } else {
+          num_collisions++;
+        }
+      }
+    }
+  }
+  EXPECT_GT(num_collisions, 0u);
+
+  // Angles not in a bin are rasterized at the pose
+  EXPECT_EQ(
+    exact_checker.inCollision(50.3, 50.7, 0.123, false),
+    mask_checker.inCollision(50.3, 50.7, 0.123, false));
+  EXPECT_EQ(exact_checker.getCost(), mask_checker.getCost());
+
+  // So are poses off the center of cells, even in an angle bin
+  for (float x = 1.25f; x < 99.0f; x += 2.75f) {
+    for (float y = 1.5f; y < 99.0f; y += 3.25f) {
+      for (unsigned int bin = 0; bin < num_quantizations; bin += 7) {
+        EXPECT_EQ(
+          exact_checker.inCollision(x, y, bin * bin_size, false),
+          mask_checker.inCollision(x, y, bin * bin_size, false));
+        EXPECT_EQ(exact_checker.getCost(), mask_checker.getCost());
+      }
+    }
+  }
+
+  delete costmap_;
+}
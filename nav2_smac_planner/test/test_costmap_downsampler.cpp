@@ -13,6 +13,7 @@
 // limitations under the License. Reserved.
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -29,6 +30,25 @@ public:
 };
 RclCppFixture g_rclcppfixture;
 
+// Exposes the per-cell downsampling to compare against
+class DownsamplerWrap : public nav2_smac_planner::CostmapDownsampler
+{
+public:
+  void downsamplePerCell()
+  {
+    for (unsigned int i = 0; i < _downsampled_size_x; ++i) {
+      for (unsigned int j = 0; j < _downsampled_size_y; ++j) {
+        setCostOfCell(i, j);
+      }
+    }
+  }
+
+  nav2_costmap_2d::Costmap2D * getDownsampledCostmap()
+  {
+    return _downsampled_costmap.get();
+  }
+};
+
 TEST(CostmapDownsampler, costmap_downsample_test)
 {
   nav2_util::LifecycleNode::SharedPtr node = std::make_shared<nav2_util::LifecycleNode>(
@@ -65,3 +85,37 @@ TEST(CostmapDownsampler, costmap_downsample_test)
 
   downsampler.resizeCostmap();
 }
+
+TEST(CostmapDownsampler, costmap_downsample_max_pooling)
+{
+  nav2_util::LifecycleNode::SharedPtr node = std::make_shared<nav2_util::LifecycleNode>(
+    "CostmapDownsamplerMaxPooling");
+
+  // Odd sized so coarse cells on the edges are partial
+  const unsigned int size_x = 2001;
+  const unsigned int size_y = 1999;
+  nav2_costmap_2d::Costmap2D costmap(size_x, size_y, 0.05, 0.0, 0.0, 0);
+  unsigned int seed = 42;
+  for (unsigned int i = 0; i != size_x * size_y; i++) {
+    seed = seed * 1103515245u + 12345u;
+    costmap.getCharMap()[i] = static_cast<unsigned char>(seed >> 24);
+  }
+
+  // Power of two factors reduce rows by pairs, others take the max of each coarse cell
+  for (unsigned int factor : {1u, 2u, 3u, 4u, 5u, 8u}) {
+    SCOPED_TRACE("downsampling by " + std::to_string(factor));
+    DownsamplerWrap downsampler;
+    downsampler.on_configure(node, "map", "unused_topic", &costmap, factor);
+
+    downsampler.downsample(factor);
+    nav2_costmap_2d::Costmap2D pooled(*downsampler.getDownsampledCostmap());
+    downsampler.downsamplePerCell();
+    nav2_costmap_2d::Costmap2D * per_cell = downsampler.getDownsampledCostmap();
+
+    ASSERT_EQ(pooled.getSizeInCellsX(), per_cell->getSizeInCellsX());
+    ASSERT_EQ(pooled.getSizeInCellsY(), per_cell->getSizeInCellsY());
+    for (unsigned int i = 0; i != pooled.getSizeInCellsX() * pooled.getSizeInCellsY(); i++) {
+      ASSERT_EQ(pooled.getCharMap()[i], per_cell->getCharMap()[i]);
+    }
+  }
+}
@@ -0,0 +1,191 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_smac_planner/node_2d.hpp"
+#include "nav2_smac_planner/node_se2.hpp"
+#include "nav2_smac_planner/collision_checker.hpp"
+
+// Heap allocations are only counted on the thread of an AllocationCounter in scope,
+// others are passed through
+static thread_local bool t_count_allocations = false;
+static thread_local size_t t_num_allocations = 0;
+
+void * operator new(std::size_t size)
+{
+  if (t_count_allocations) {
+    t_num_allocations++;
+  }
+  void * ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+// Counts the heap allocations made by this thread while in scope
+class AllocationCounter
+{
+public:
+  AllocationCounter()
+  {
+    t_num_allocations = 0;
+    t_count_allocations = true;
+  }
+
+  ~AllocationCounter()
+  {
+    t_count_allocations = false;
+  }
+
+  size_t count() const
+  {
+    return t_num_allocations;
+  }
+};
+
+static const unsigned int NUM_EXPANSIONS = 1000;
+
+TEST(ExpansionAllocations, test_node_se2_expansion)
+{
+  unsigned int size_x = 50;
+  unsigned int size_y = 50;
+  unsigned int size_theta = 72;
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 1.2;
+  info.non_straight_penalty = 1.4;
+  info.reverse_penalty = 2.1;
+  info.minimum_turning_radius = 8;  // 0.4m/5cm resolution costmap
+  info.num_expansion_threads = 1;
+  nav2_smac_planner::NodeSE2::initMotionModel(
+    nav2_smac_planner::MotionModel::REEDS_SHEPP, size_x, size_y, size_theta, info);
+
+  // Costs possibly inscribed so that every primitive's footprint is checked
+  nav2_costmap_2d::Costmap2D costmap(size_x, size_y, 0.05, 0.0, 0.0, 200);
+  nav2_smac_planner::GridCollisionChecker checker(&costmap, size_theta);
+  geometry_msgs::msg::Point p1, p2, p3, p4;
+  p1.x = -0.1;
+  p1.y = -0.1;
+  p2.x = 0.1;
+  p2.y = -0.1;
+  p3.x = 0.1;
+  p3.y = 0.1;
+  p4.x = -0.1;
+  p4.y = 0.1;
+  checker.setFootprint({p1, p2, p3, p4}, false);
+
+  std::vector<nav2_smac_planner::NodeSE2> graph;
+  graph.reserve(size_x * size_y * size_theta);
+  for (unsigned int i = 0; i != size_x * size_y * size_theta; i++) {
+    graph.emplace_back(i);
+  }
+  auto neighborGetter =
+    [&](const unsigned int & index, nav2_smac_planner::NodeSE2 * & neighbor_rtn) -> bool
+    {
+      if (index >= graph.size()) {
+        return false;
+      }
+      neighbor_rtn = &graph[index];
+      return true;
+    };
+
+  const unsigned int index = nav2_smac_planner::NodeSE2::getIndex(25u, 25u, 10u);
+  nav2_smac_planner::NodeSE2 * node = &graph[index];
+  node->setPose(nav2_smac_planner::NodeSE2::Coordinates(25.0f, 25.0f, 10.0f));
+  nav2_smac_planner::NodeSE2::NodeVector neighbors;
+  nav2_smac_planner::NodeSE2::ExpansionScratch scratch;
+
+  // Warm up so scratch buffers have grown to their steady state size
+  nav2_smac_planner::NodeSE2::getNeighbors(
+    node, neighborGetter, checker, false, neighbors, scratch);
+  EXPECT_EQ(neighbors.size(), 6u);
+
+  size_t num_allocations;
+  {
+    AllocationCounter counter;
+    for (unsigned int i = 0; i != NUM_EXPANSIONS; i++) {
+      neighbors.clear();
+      nav2_smac_planner::NodeSE2::getNeighbors(
+        node, neighborGetter, checker, false, neighbors, scratch);
+    }
+    num_allocations = counter.count();
+  }
+
+  EXPECT_EQ(neighbors.size(), 6u);
+  EXPECT_EQ(num_allocations, 0u);
+}
+
+TEST(ExpansionAllocations, test_node_2d_expansion)
+{
+  const unsigned int size_x = 100;
+  const unsigned int size_y = 100;
+  nav2_smac_planner::Node2D::initNeighborhood(size_x, nav2_smac_planner::MotionModel::MOORE);
+
+  nav2_costmap_2d::Costmap2D costmap(size_x, size_y, 0.05, 0.0, 0.0, 0);
+  nav2_smac_planner::GridCollisionChecker checker(&costmap);
+  checker.setFootprint(nav2_costmap_2d::Footprint(), true);
+
+  std::vector<nav2_smac_planner::Node2D> graph;
+  graph.reserve(size_x * size_y);
+  for (unsigned int i = 0; i != size_x * size_y; i++) {
+    graph.emplace_back(costmap.getCharMap()[i], i);
+  }
+  auto neighborGetter =
+    [&](const unsigned int & index, nav2_smac_planner::Node2D * & neighbor_rtn) -> bool
+    {
+      if (index >= graph.size()) {
+        return false;
+      }
+      neighbor_rtn = &graph[index];
+      return true;
+    };
+
+  nav2_smac_planner::Node2D * node = &graph[nav2_smac_planner::Node2D::getIndex(50u, 50u, size_x)];
+  nav2_smac_planner::Node2D::NodeVector neighbors;
+  nav2_smac_planner::Node2D::ExpansionScratch scratch;
+
+  // Warm up so the neighbors vector has grown to its steady state size
+  nav2_smac_planner::Node2D::getNeighbors(
+    node, neighborGetter, checker, false, neighbors, scratch);
+  EXPECT_EQ(neighbors.size(), 8u);
+
+  size_t num_allocations;
+  {
+    AllocationCounter counter;
+    for (unsigned int i = 0; i != NUM_EXPANSIONS; i++) {
+      neighbors.clear();
+      nav2_smac_planner::Node2D::getNeighbors(
+        node, neighborGetter, checker, false, neighbors, scratch);
+    }
+    num_allocations = counter.count();
+  }
+
+  EXPECT_EQ(neighbors.size(), 8u);
+  EXPECT_EQ(num_allocations, 0u);
+}
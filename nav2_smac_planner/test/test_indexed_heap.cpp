@@ -0,0 +1,81 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <math.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nav2_smac_planner/indexed_heap.hpp"
+#include "nav2_smac_planner/node_2d.hpp"
+
+TEST(IndexedHeapTest, test_indexed_heap)
+{
+  typedef nav2_smac_planner::IndexedHeap<nav2_smac_planner::Node2D> Heap;
+  unsigned char cost = 0;
+  std::vector<nav2_smac_planner::Node2D> nodes;
+  for (unsigned int i = 0; i != 10; i++) {
+    nodes.emplace_back(cost, i);
+  }
+
+  Heap heap;
+  EXPECT_TRUE(heap.empty());
+
+  // Push in descending order of cost
+  for (unsigned int i = 0; i != nodes.size(); i++) {
+    nav2_smac_planner::NodeBasic<nav2_smac_planner::Node2D> node(i);
+    node.graph_node_ptr = &nodes[i];
+    heap.push(100.0 - i, node);
+  }
+  EXPECT_EQ(heap.size(), 10u);
+  EXPECT_EQ(heap.peakSize(), 10u);
+  EXPECT_EQ(heap.top().second.index, 9u);
+
+  // Decrease-key moves node to the front without adding a new entry
+  nav2_smac_planner::NodeBasic<nav2_smac_planner::Node2D> node(3);
+  node.graph_node_ptr = &nodes[3];
+  heap.push(1.0, node);
+  EXPECT_EQ(heap.size(), 10u);
+  EXPECT_EQ(heap.top().second.index, 3u);
+  EXPECT_EQ(heap.top().first, 1.0);
+
+  // Higher costs for queued nodes are ignored
+  heap.push(500.0, node);
+  EXPECT_EQ(heap.size(), 10u);
+  EXPECT_EQ(heap.top().first, 1.0);
+
+  // Elements come out in order of cost, and are no longer marked as queued
+  heap.pop();
+  EXPECT_EQ(nodes[3].getOpenSetIndex(), Heap::NOT_IN_HEAP);
+  float last_cost = 0.0;
+  while (!heap.empty()) {
+    EXPECT_GE(heap.top().first, last_cost);
+    last_cost = heap.top().first;
+    heap.pop();
+  }
+  EXPECT_EQ(heap.peakSize(), 10u);
+
+  for (unsigned int i = 0; i != nodes.size(); i++) {
+    EXPECT_EQ(nodes[i].getOpenSetIndex(), Heap::NOT_IN_HEAP);
+  }
+
+  // A popped node can be queued again
+  heap.push(5.0, node);
+  EXPECT_EQ(heap.size(), 1u);
+  heap.clear();
+  EXPECT_TRUE(heap.empty());
+  EXPECT_EQ(heap.peakSize(), 0u);
+  EXPECT_EQ(nodes[3].getOpenSetIndex(), Heap::NOT_IN_HEAP);
+}
@@ -120,14 +120,19 @@ TEST(Node2DTest, test_node_2d_neighbors)
   nav2_smac_planner::GridCollisionChecker checker(&costmapA);
   unsigned char cost = static_cast<unsigned int>(1);
   nav2_smac_planner::Node2D * node = new nav2_smac_planner::Node2D(cost, 1);
+  unsigned char lethal_cost = 254;
+  nav2_smac_planner::Node2D lethal_node(lethal_cost, 0);
   std::function<bool(const unsigned int &, nav2_smac_planner::Node2D * &)> neighborGetter =
     [&, this](const unsigned int & index, nav2_smac_planner::Node2D * & neighbor_rtn) -> bool
     {
+      neighbor_rtn = &lethal_node;
       return true;
     };
 
   nav2_smac_planner::Node2D::NodeVector neighbors;
-  nav2_smac_planner::Node2D::getNeighbors(node, neighborGetter, checker, false, neighbors);
+  nav2_smac_planner::Node2D::ExpansionScratch scratch;
+  nav2_smac_planner::Node2D::getNeighbors(
+    node, neighborGetter, checker, false, neighbors, scratch);
   delete node;
 
   // should be empty since totally invalid
@@ -0,0 +1,71 @@
+// Copyright (c) 2026 Nav2 Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <math.h>
+#include <memory>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nav2_smac_planner/node_pool.hpp"
+#include "nav2_smac_planner/node_se2.hpp"
+
+TEST(NodePoolTest, test_node_pool)
+{
+  nav2_smac_planner::NodePool<nav2_smac_planner::NodeSE2> pool(4);
+  EXPECT_TRUE(pool.empty());
+  EXPECT_EQ(pool.getMemoryUsage(), 0u);
+
+  pool.resize(100);
+  EXPECT_TRUE(pool.empty());
+  EXPECT_THROW(pool.at(10), std::out_of_range);
+
+  // Nodes are constructed on first use and reused afterwards
+  nav2_smac_planner::NodeSE2 * node = pool.emplace(10, 10);
+  EXPECT_EQ(node->getIndex(), 10u);
+  EXPECT_EQ(pool.size(), 1u);
+  node->setAccumulatedCost(5.0);
+  node->visited();
+  EXPECT_EQ(pool.emplace(10, 10), node);
+  EXPECT_EQ(pool.at(10), node);
+  EXPECT_EQ(node->getAccumulatedCost(), 5.0);
+  EXPECT_EQ(pool.size(), 1u);
+
+  // Only touched pages are allocated
+  pool.emplace(99, 99);
+  EXPECT_EQ(pool.size(), 2u);
+  EXPECT_GT(pool.getMemoryUsage(), 0u);
+  const size_t memory = pool.getMemoryUsage();
+
+  // Clearing invalidates nodes without releasing memory
+  pool.clear();
+  EXPECT_TRUE(pool.empty());
+  EXPECT_EQ(pool.getMemoryUsage(), memory);
+  EXPECT_THROW(pool.at(10), std::out_of_range);
+  node = pool.emplace(10, 10);
+  EXPECT_FALSE(node->wasVisited());
+  EXPECT_EQ(node->getAccumulatedCost(), std::numeric_limits<float>::max());
+
+  // Resizing releases all pages
+  pool.resize(200);
+  EXPECT_TRUE(pool.empty());
+  EXPECT_THROW(pool.at(10), std::out_of_range);
+  EXPECT_THROW(pool.at(500), std::out_of_range);
+
+  // Indices beyond the pool are not added
+  EXPECT_EQ(pool.emplace(200, 200), nullptr);
+  EXPECT_EQ(pool.emplace(500, 500), nullptr);
+  EXPECT_TRUE(pool.empty());
+}
@@ -100,7 +100,7 @@ TEST(NodeSE2Test, test_node_se2)
     costmapA,
     static_cast<unsigned int>(10.0),
     static_cast<unsigned int>(5.0),
-    0.0, 0.0);
+    0.0, 0.0, false);
   nav2_smac_planner::NodeSE2::Coordinates A(0.0, 0.0, 4.2);
   nav2_smac_planner::NodeSE2::Coordinates B(10.0, 5.0, 54.1);
   EXPECT_NEAR(testB.getHeuristicCost(B, A), 16.723, 0.01);
@@ -139,6 +139,108 @@ TEST(NodeSE2Test, test_node_se2)
   delete costmapA;
 }
 
+TEST(NodeSE2Test, test_distance_heuristic_lookup_table)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 1.2;
+  info.non_straight_penalty = 1.4;
+  info.reverse_penalty = 2.1;
+  info.minimum_turning_radius = 4.0;
+  unsigned int size_x = 100;
+  unsigned int size_y = 100;
+  unsigned int size_theta = 72;
+
+  // Without a lookup table, distances come directly from OMPL
+  info.lookup_table_size = 0.0;
+  nav2_smac_planner::NodeSE2::initMotionModel(
+    nav2_smac_planner::MotionModel::REEDS_SHEPP, size_x, size_y, size_theta, info);
+
+  nav2_smac_planner::NodeSE2::Coordinates goal(50.0, 50.0, 0.0);
+  std::vector<nav2_smac_planner::NodeSE2::Coordinates> nodes = {
+    {45.0, 50.0, 0.0}, {52.0, 41.0, 10.0}, {57.0, 58.0, 65.0}, {50.0, 60.0, 36.0},
+    {90.0, 90.0, 20.0}};
+  std::vector<float> ompl_distances;
+  for (const auto & node : nodes) {
+    ompl_distances.push_back(
+      nav2_smac_planner::NodeSE2::getDistanceHeuristic(node, goal));
+  }
+
+  // Within the window of the table, integer cell offsets match exactly.
+  // Outside, the last node falls back to OMPL.
+  info.lookup_table_size = 40.0;
+  nav2_smac_planner::NodeSE2::initMotionModel(
+    nav2_smac_planner::MotionModel::REEDS_SHEPP, size_x, size_y, size_theta, info);
+  for (unsigned int i = 0; i != nodes.size(); i++) {
+    EXPECT_NEAR(
+      nav2_smac_planner::NodeSE2::getDistanceHeuristic(nodes[i], goal),
+      ompl_distances[i], 1e-4);
+  }
+
+  // Distances are invariant to rotating the node and goal together, including
+  // when the goal is not aligned with the table
+  goal.theta = 18.0;  // 90 degrees
+  for (unsigned int i = 0; i != nodes.size(); i++) {
+    nav2_smac_planner::NodeSE2::Coordinates rotated(
+      goal.x - (nodes[i].y - goal.y),
+      goal.y + (nodes[i].x - goal.x),
+      fmod(nodes[i].theta + 18.0, 72.0));
+    EXPECT_NEAR(
+      nav2_smac_planner::NodeSE2::getDistanceHeuristic(rotated, goal),
+      ompl_distances[i], 1e-3);
+  }
+}
+
+TEST(NodeSE2Test, test_wavefront_heuristic_repair)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 1.2;
+  info.non_straight_penalty = 1.4;
+  info.reverse_penalty = 2.1;
+  info.minimum_turning_radius = 0.20;
+  unsigned int size_x = 60;
+  unsigned int size_y = 50;
+  unsigned int size_theta = 72;
+  nav2_smac_planner::NodeSE2::initMotionModel(
+    nav2_smac_planner::MotionModel::DUBIN, size_x, size_y, size_theta, info);
+
+  nav2_costmap_2d::Costmap2D * costmapA = new nav2_costmap_2d::Costmap2D(
+    size_x, size_y, 0.05, 0.0, 0.0, 0);
+
+  // a wall with a gap to route around
+  for (unsigned int j = 0; j != 40; j++) {
+    costmapA->setCost(30, j, 254);
+  }
+
+  nav2_smac_planner::NodeSE2::computeWavefrontHeuristic(costmapA, 5, 5, 50, 10, true);
+
+  // Randomly block and free cells, the repaired wavefront must always
+  // match one computed from scratch on the same costmap
+  srand(42);
+  for (unsigned int iter = 0; iter != 20; iter++) {
+    for (unsigned int k = 0; k != 30; k++) {
+      const unsigned int x = rand() % size_x;
+      const unsigned int y = rand() % size_y;
+      const unsigned char cost = rand() % 3 == 0 ? 0 : 254;
+      costmapA->setCost(x, y, cost);
+    }
+
+    // reopen and close the gap in the wall
+    costmapA->setCost(30, 45, iter % 2 == 0 ? 254 : 0);
+
+    nav2_smac_planner::NodeSE2::computeWavefrontHeuristic(costmapA, 5, 5, 50, 10, true);
+    const std::vector<unsigned int> repaired =
+      nav2_smac_planner::NodeSE2::getWavefrontHeuristic();
+
+    nav2_smac_planner::NodeSE2::computeWavefrontHeuristic(costmapA, 5, 5, 50, 10, false);
+    EXPECT_EQ(repaired, nav2_smac_planner::NodeSE2::getWavefrontHeuristic());
+
+    // cache again from scratch for the next repair, as the last call dropped it
+    nav2_smac_planner::NodeSE2::computeWavefrontHeuristic(costmapA, 5, 5, 50, 10, true);
+  }
+
+  delete costmapA;
+}
+
 TEST(NodeSE2Test, test_node_2d_neighbors)
 {
   nav2_smac_planner::SearchInfo info;
@@ -195,6 +297,39 @@ TEST(NodeSE2Test, test_node_2d_neighbors)
   EXPECT_NEAR(nav2_smac_planner::NodeSE2::motion_table.projections[5]._y, -0.3747, 0.01);
   EXPECT_NEAR(nav2_smac_planner::NodeSE2::motion_table.projections[5]._theta, 5, 0.01);
 
+  // test precomputed projections from each heading, with headings wrapped around
+  nav2_smac_planner::MotionTable & table = nav2_smac_planner::NodeSE2::motion_table;
+  nav2_smac_planner::NodeSE2 projected_node(0);
+  nav2_smac_planner::MotionPoses projections;
+  for (unsigned int heading : {0u, 17u, 70u}) {
+    projected_node.setPose(nav2_smac_planner::NodeSE2::Coordinates(10.0f, 20.0f, heading));
+    table.getProjections(&projected_node, projections);
+    ASSERT_EQ(projections.size(), 6u);
+    for (unsigned int i = 0; i != projections.size(); i++) {
+      const double theta = heading * table.bin_size;
+      EXPECT_NEAR(
+        projections[i]._x,
+        10.0 + table.projections[i]._x * cos(theta) - table.projections[i]._y * sin(theta),
+        0.001);
+      EXPECT_NEAR(
+        projections[i]._y,
+        20.0 + table.projections[i]._x * sin(theta) + table.projections[i]._y * cos(theta),
+        0.001);
+      EXPECT_EQ(
+        projections[i]._theta,
+        fmod(heading + table.projections[i]._theta + 72.0f, 72.0f));
+    }
+  }
+
+  // test precomputed traversal cost multipliers
+  EXPECT_NEAR(table.getTravelCostMultiplier(0, 0), 1.0, 0.001);
+  EXPECT_NEAR(table.getTravelCostMultiplier(1, 1), 1.4, 0.001);
+  EXPECT_NEAR(table.getTravelCostMultiplier(1, 2), 2.6, 0.001);
+  EXPECT_NEAR(table.getTravelCostMultiplier(2, 3), 1.0, 0.001);
+  EXPECT_NEAR(table.getTravelCostMultiplier(3, 3), 2.1, 0.001);
+  EXPECT_NEAR(table.getTravelCostMultiplier(4, 4), 1.4 * 2.1, 0.001);
+  EXPECT_NEAR(table.getTravelCostMultiplier(5, 1), 2.6 * 2.1, 0.001);
+
   nav2_costmap_2d::Costmap2D costmapA(100, 100, 0.05, 0.0, 0.0, 0);
   nav2_smac_planner::GridCollisionChecker checker(&costmapA);
   nav2_smac_planner::NodeSE2 * node = new nav2_smac_planner::NodeSE2(49);
@@ -206,7 +341,9 @@ TEST(NodeSE2Test, test_node_2d_neighbors)
     };
 
   nav2_smac_planner::NodeSE2::NodeVector neighbors;
-  nav2_smac_planner::NodeSE2::getNeighbors(node, neighborGetter, checker, false, neighbors);
+  nav2_smac_planner::NodeSE2::ExpansionScratch scratch;
+  nav2_smac_planner::NodeSE2::getNeighbors(
+    node, neighborGetter, checker, false, neighbors, scratch);
   delete node;
 
   // should be empty since totally invalid
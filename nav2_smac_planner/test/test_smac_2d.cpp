@@ -20,6 +20,7 @@
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_costmap_2d/costmap_subscriber.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -78,3 +79,89 @@ TEST(SmacTest, test_smac_2d)
   node2D.reset();
   costmap_ros.reset();
 }
+
+TEST(SmacTest, test_smac_2d_create_plans)
+{
+  rclcpp_lifecycle::LifecycleNode::SharedPtr node2D =
+    std::make_shared<rclcpp_lifecycle::LifecycleNode>("Smac2DPlansTest");
+
+  std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros =
+    std::make_shared<nav2_costmap_2d::Costmap2DROS>("global_costmap");
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+
+  // A wall across most of the costmap, which paths to goals past it must go around
+  auto costmap = costmap_ros->getCostmap();
+  for (unsigned int y = 0; y != 35; y++) {
+    costmap->setCost(20, y, nav2_costmap_2d::LETHAL_OBSTACLE);
+    costmap->setCost(21, y, nav2_costmap_2d::LETHAL_OBSTACLE);
+  }
+
+  node2D->declare_parameter("test.smooth_path", true);
+  node2D->set_parameter(rclcpp::Parameter("test.smooth_path", true));
+  node2D->declare_parameter("test.downsample_costmap", true);
+  node2D->set_parameter(rclcpp::Parameter("test.downsample_costmap", true));
+  node2D->declare_parameter("test.downsampling_factor", 2);
+  node2D->set_parameter(rclcpp::Parameter("test.downsampling_factor", 2));
+
+  auto makePose = [](const double & x, const double & y) {
+      geometry_msgs::msg::PoseStamped pose;
+      pose.pose.position.x = x;
+      pose.pose.position.y = y;
+      pose.pose.orientation.w = 1.0;
+      return pose;
+    };
+
+  auto planner_2d = std::make_unique<nav2_smac_planner::SmacPlanner2D>();
+  planner_2d->configure(node2D, "test", nullptr, costmap_ros);
+  planner_2d->activate();
+
+  // Goals on either side of the wall, in it and off the costmap
+  auto start = makePose(0.5, 0.5);
+  std::vector<geometry_msgs::msg::PoseStamped> goals = {
+    makePose(1.0, 2.5), makePose(4.0, 1.0), makePose(2.1, 1.0),
+    makePose(4.5, 4.5), makePose(10.0, 10.0)};
+  const std::vector<bool> reachable = {true, true, false, true, false};
+
+  std::vector<double> costs;
+  auto plans = planner_2d->createPlans(start, goals, costs);
+  ASSERT_EQ(plans.size(), goals.size());
+  ASSERT_EQ(costs.size(), goals.size());
+
+  // Paths start and end within a cell of the downsampled costmap of their poses
+  const double tolerance = 0.2;
+  for (unsigned int i = 0; i != goals.size(); i++) {
+    if (!reachable[i]) {
+      EXPECT_TRUE(plans[i].poses.empty()) << "to goal " << i;
+      EXPECT_EQ(costs[i], -1.0) << "to goal " << i;
+      continue;
+    }
+
+    ASSERT_FALSE(plans[i].poses.empty()) << "to goal " << i;
+    EXPECT_NEAR(plans[i].poses.front().pose.position.x, start.pose.position.x, tolerance);
+    EXPECT_NEAR(plans[i].poses.front().pose.position.y, start.pose.position.y, tolerance);
+    EXPECT_NEAR(plans[i].poses.back().pose.position.x, goals[i].pose.position.x, tolerance);
+    EXPECT_NEAR(plans[i].poses.back().pose.position.y, goals[i].pose.position.y, tolerance);
+
+    // The same as planning to each goal on its own
+    std::vector<double> goal_costs;
+    auto goal_plans = planner_2d->createPlans(start, {goals[i]}, goal_costs);
+    ASSERT_EQ(goal_costs.size(), 1u);
+    EXPECT_NEAR(costs[i], goal_costs[0], 1e-3) << "to goal " << i;
+
+    auto plan = planner_2d->createPlan(start, goals[i]);
+    ASSERT_FALSE(plan.poses.empty()) << "to goal " << i;
+    EXPECT_NEAR(plan.poses.back().pose.position.x, plans[i].poses.back().pose.position.x, 1e-6);
+    EXPECT_NEAR(plan.poses.back().pose.position.y, plans[i].poses.back().pose.position.y, 1e-6);
+  }
+
+  // Going around the wall costs more than reaching the goal on the same side
+  EXPECT_GT(costs[1], costs[0]);
+
+  planner_2d->deactivate();
+  planner_2d->cleanup();
+
+  planner_2d.reset();
+  costmap_ros->on_cleanup(rclcpp_lifecycle::State());
+  node2D.reset();
+  costmap_ros.reset();
+}
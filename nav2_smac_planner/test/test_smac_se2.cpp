@@ -13,6 +13,7 @@
 // limitations under the License. Reserved.
 
 #include <math.h>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -20,6 +21,7 @@
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_costmap_2d/costmap_subscriber.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -37,6 +39,65 @@ public:
 };
 RclCppFixture g_rclcppfixture;
 
+geometry_msgs::msg::PoseStamped makePose(const double & x, const double & y)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  pose.pose.position.x = x;
+  pose.pose.position.y = y;
+  pose.pose.orientation.w = 1.0;
+  return pose;
+}
+
+class SmacPlannerWrap : public nav2_smac_planner::SmacPlanner
+{
+public:
+  // Find the corridor on the current costmap, as createPlan does when not downsampling
+  bool getCorridor(
+    const unsigned int & start_mx, const unsigned int & start_my,
+    const unsigned int & goal_mx, const unsigned int & goal_my,
+    std::vector<bool> & corridor)
+  {
+    _costmap_snapshot = *_costmap;
+    return getSearchCorridor(
+      start_mx, start_my, goal_mx, goal_my, &_costmap_snapshot, corridor);
+  }
+};
+
+// Whether a plan ends at the goal, within tolerance, with no pose in collision
+bool isPlanValid(
+  const nav_msgs::msg::Path & plan, const geometry_msgs::msg::PoseStamped & goal,
+  nav2_costmap_2d::Costmap2D * costmap, const double & tolerance)
+{
+  if (plan.poses.empty() ||
+    std::hypot(
+      plan.poses.back().pose.position.x - goal.pose.position.x,
+      plan.poses.back().pose.position.y - goal.pose.position.y) > tolerance)
+  {
+    return false;
+  }
+
+  for (const auto & pose : plan.poses) {
+    unsigned int mx, my;
+    if (!costmap->worldToMap(pose.pose.position.x, pose.pose.position.y, mx, my) ||
+      costmap->getCost(mx, my) == nav2_costmap_2d::LETHAL_OBSTACLE)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Furthest a plan strays from the line y = y0
+double getMaxDeviation(const nav_msgs::msg::Path & plan, const double & y0)
+{
+  double max_deviation = 0.0;
+  for (const auto & pose : plan.poses) {
+    max_deviation = std::max(max_deviation, std::abs(pose.pose.position.y - y0));
+  }
+  return max_deviation;
+}
+
 // SMAC smoke tests for plugin-level issues rather than algorithms
 // (covered by more extensively testing in other files)
 // System tests in nav2_system_tests will actually plan with this work
@@ -56,20 +117,181 @@ TEST(SmacTest, test_smac_se2)
   nodeSE2->set_parameter(rclcpp::Parameter("test.downsample_costmap", true));
   nodeSE2->declare_parameter("test.downsampling_factor", 2);
   nodeSE2->set_parameter(rclcpp::Parameter("test.downsampling_factor", 2));
+  nodeSE2->declare_parameter("test.use_hierarchical_planning", true);
+  nodeSE2->set_parameter(rclcpp::Parameter("test.use_hierarchical_planning", true));
+  nodeSE2->declare_parameter("test.use_plan_repair", true);
+  nodeSE2->set_parameter(rclcpp::Parameter("test.use_plan_repair", true));
+
+  auto start = makePose(0.5, 0.5);
+  auto goal = makePose(4.0, 4.0);
+  auto planner = std::make_unique<nav2_smac_planner::SmacPlanner>();
+  planner->configure(nodeSE2, "test", nullptr, costmap_ros);
+  planner->activate();
+
+  // Within a cell of the downsampled costmap of the goal
+  const double tolerance = 0.2;
+  auto plan = planner->createPlan(start, goal);
+  EXPECT_TRUE(isPlanValid(plan, goal, costmap_ros->getCostmap(), tolerance));
+
+  // Replanning to the same goal reuses the previous plan
+  auto replan = planner->createPlan(start, goal);
+  EXPECT_TRUE(isPlanValid(replan, goal, costmap_ros->getCostmap(), tolerance));
+
+  planner->deactivate();
+  planner->cleanup();
+
+  planner.reset();
+  costmap_ros->on_cleanup(rclcpp_lifecycle::State());
+  costmap_ros.reset();
+  nodeSE2.reset();
+}
+
+TEST(SmacTest, test_smac_se2_plan_repair)
+{
+  rclcpp_lifecycle::LifecycleNode::SharedPtr nodeSE2 =
+    std::make_shared<rclcpp_lifecycle::LifecycleNode>("SmacSE2RepairTest");
+
+  std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros =
+    std::make_shared<nav2_costmap_2d::Costmap2DROS>("global_costmap");
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+
+  // Unsmoothed, so plans are made of the poses searched or reused
+  nodeSE2->declare_parameter("test.smooth_path", false);
+  nodeSE2->set_parameter(rclcpp::Parameter("test.smooth_path", false));
+  nodeSE2->declare_parameter("test.use_plan_repair", true);
+  nodeSE2->set_parameter(rclcpp::Parameter("test.use_plan_repair", true));
+
+  // A wall between the start and goal, which the first plan must go around
+  auto costmap = costmap_ros->getCostmap();
+  auto setWall = [&](const unsigned char & cost) {
+      for (unsigned int y = 15; y != 35; y++) {
+        for (unsigned int x = 24; x != 27; x++) {
+          costmap->setCost(x, y, cost);
+        }
+      }
+    };
+  setWall(nav2_costmap_2d::LETHAL_OBSTACLE);
 
-  geometry_msgs::msg::PoseStamped start, goal;
-  start.pose.position.x = 0.0;
-  start.pose.position.y = 0.0;
-  start.pose.orientation.w = 1.0;
-  goal = start;
   auto planner = std::make_unique<nav2_smac_planner::SmacPlanner>();
   planner->configure(nodeSE2, "test", nullptr, costmap_ros);
   planner->activate();
 
-  try {
-    planner->createPlan(start, goal);
-  } catch (...) {
+  const double tolerance = 0.2;
+  auto start = makePose(0.5, 2.5);
+  auto goal = makePose(4.5, 2.5);
+  auto plan = planner->createPlan(start, goal);
+  ASSERT_TRUE(isPlanValid(plan, goal, costmap, tolerance));
+  EXPECT_GT(getMaxDeviation(plan, 2.5), 1.0);
+
+  // Once the wall is gone, replanning from further along the plan reuses the rest of it,
+  // still going around where the wall was rather than straight to the goal
+  setWall(nav2_costmap_2d::FREE_SPACE);
+  auto moved_start = plan.poses[3];
+  auto repaired = planner->createPlan(moved_start, goal);
+  ASSERT_TRUE(isPlanValid(repaired, goal, costmap, tolerance));
+  EXPECT_GT(getMaxDeviation(repaired, 2.5), 1.0);
+  // Like searched plans, it does not include the start
+  EXPECT_GT(
+    std::hypot(
+      repaired.poses.front().pose.position.x - moved_start.pose.position.x,
+      repaired.poses.front().pose.position.y - moved_start.pose.position.y), 1e-3);
+  for (size_t i = 1; i <= repaired.poses.size() / 2; i++) {
+    const auto & repaired_pose = repaired.poses.end()[-i].pose.position;
+    const auto & pose = plan.poses.end()[-i].pose.position;
+    EXPECT_NEAR(repaired_pose.x, pose.x, 1e-4);
+    EXPECT_NEAR(repaired_pose.y, pose.y, 1e-4);
+  }
+
+  // Blocking the previous plan makes it search again, taking the way now open
+  for (const auto & pose : repaired.poses) {
+    if (std::abs(pose.pose.position.y - 2.5) > 1.0) {
+      unsigned int mx, my;
+      ASSERT_TRUE(costmap->worldToMap(pose.pose.position.x, pose.pose.position.y, mx, my));
+      costmap->setCost(mx, my, nav2_costmap_2d::LETHAL_OBSTACLE);
+      break;
+    }
+  }
+  auto replanned = planner->createPlan(moved_start, goal);
+  ASSERT_TRUE(isPlanValid(replanned, goal, costmap, tolerance));
+  EXPECT_LT(getMaxDeviation(replanned, 2.5), 1.0);
+
+  // A plan to another goal is searched for, not reused
+  auto other_goal = makePose(4.5, 1.0);
+  auto other_plan = planner->createPlan(moved_start, other_goal);
+  EXPECT_TRUE(isPlanValid(other_plan, other_goal, costmap, tolerance));
+
+  planner->deactivate();
+  planner->cleanup();
+
+  planner.reset();
+  costmap_ros->on_cleanup(rclcpp_lifecycle::State());
+  costmap_ros.reset();
+  nodeSE2.reset();
+}
+
+TEST(SmacTest, test_smac_se2_hierarchical)
+{
+  rclcpp_lifecycle::LifecycleNode::SharedPtr nodeSE2 =
+    std::make_shared<rclcpp_lifecycle::LifecycleNode>("SmacSE2HierarchicalTest");
+
+  std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros =
+    std::make_shared<nav2_costmap_2d::Costmap2DROS>("global_costmap");
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+
+  nodeSE2->declare_parameter("test.use_hierarchical_planning", true);
+  nodeSE2->set_parameter(rclcpp::Parameter("test.use_hierarchical_planning", true));
+  nodeSE2->declare_parameter("test.hierarchical_downsampling_factor", 4);
+  nodeSE2->set_parameter(rclcpp::Parameter("test.hierarchical_downsampling_factor", 4));
+  nodeSE2->declare_parameter("test.hierarchical_corridor_radius", 0.5);
+  nodeSE2->set_parameter(rclcpp::Parameter("test.hierarchical_corridor_radius", 0.5));
+
+  // A wall between the start and goal, leaving room to go around it either side
+  auto costmap = costmap_ros->getCostmap();
+  for (unsigned int y = 15; y != 35; y++) {
+    for (unsigned int x = 24; x != 27; x++) {
+      costmap->setCost(x, y, nav2_costmap_2d::LETHAL_OBSTACLE);
+    }
+  }
+
+  auto planner = std::make_unique<SmacPlannerWrap>();
+  planner->configure(nodeSE2, "test", nullptr, costmap_ros);
+  planner->activate();
+
+  // The corridor follows the coarse path around one side of the wall, not both
+  const unsigned int size_x = costmap->getSizeInCellsX();
+  std::vector<bool> corridor;
+  ASSERT_TRUE(planner->getCorridor(5, 25, 45, 25, corridor));
+  ASSERT_EQ(corridor.size(), size_x * costmap->getSizeInCellsY());
+  EXPECT_TRUE(corridor[25 * size_x + 5]);
+  EXPECT_TRUE(corridor[25 * size_x + 45]);
+  EXPECT_NE(corridor[45 * size_x + 25], corridor[5 * size_x + 25]);
+
+  // The plan reaches the goal without leaving the corridor
+  const double tolerance = 0.2;
+  auto start = makePose(0.55, 2.55);
+  auto goal = makePose(4.55, 2.55);
+  auto plan = planner->createPlan(start, goal);
+  ASSERT_TRUE(isPlanValid(plan, goal, costmap, tolerance));
+  // Poses are at their continuous grid coordinates, truncated by the search to index nodes
+  for (const auto & pose : plan.poses) {
+    const unsigned int mx = static_cast<unsigned int>(
+      (pose.pose.position.x - costmap->getOriginX()) / costmap->getResolution() - 0.5);
+    const unsigned int my = static_cast<unsigned int>(
+      (pose.pose.position.y - costmap->getOriginY()) / costmap->getResolution() - 0.5);
+    EXPECT_TRUE(corridor[my * size_x + mx]) << "at " << mx << ", " << my;
+  }
+
+  // A gap too narrow for the coarse costmap leaves no coarse path, so the whole costmap is
+  // searched instead, finding the way through the gap
+  for (unsigned int y = 0; y != costmap->getSizeInCellsY(); y++) {
+    for (unsigned int x = 24; x != 27; x++) {
+      costmap->setCost(
+        x, y, y >= 24 && y < 27 ? nav2_costmap_2d::FREE_SPACE : nav2_costmap_2d::LETHAL_OBSTACLE);
+    }
   }
+  EXPECT_FALSE(planner->getCorridor(5, 25, 45, 25, corridor));
+  plan = planner->createPlan(start, goal);
+  ASSERT_TRUE(isPlanValid(plan, goal, costmap, tolerance));
 
   planner->deactivate();
   planner->cleanup();
@@ -59,7 +59,7 @@ TEST(SmootherTest, test_smoother)
   float tolerance = 0.0;
   int it_on_approach = 1000000000;
   int num_it = 0;
-  a_star.initialize(false, max_iterations, it_on_approach);
+  a_star.initialize(false, max_iterations, it_on_approach, false, false);
   a_star.setFootprint(nav2_costmap_2d::Footprint(), true);
   a_star.createGraph(costmap->getSizeInCellsX(), costmap->getSizeInCellsY(), size_theta, costmap);
   a_star.setStart(10u, 10u, 0u);
@@ -102,3 +102,122 @@ TEST(SmootherTest, test_smoother)
 
   delete costmap;
 }
+
+TEST(SmootherTest, test_distance_field)
+{
+  nav2_costmap_2d::Costmap2D * costmap = new nav2_costmap_2d::Costmap2D(20, 20, 0.1, 0, 0, 0);
+  costmap->setCost(10, 10, 254);
+
+  nav2_smac_planner::EuclideanDistanceField field;
+  field.update(costmap, 0, 0, 20, 20);
+  EXPECT_EQ(field.getSizeX(), 20u);
+  EXPECT_EQ(field.getSizeY(), 20u);
+
+  // distances are measured from the boundary of lethal cells, negative inside them
+  EXPECT_NEAR(field.getCellDistance(10, 10), -0.05, 1e-6);
+  EXPECT_NEAR(field.getCellDistance(11, 10), 0.05, 1e-6);
+  EXPECT_NEAR(field.getCellDistance(13, 10), 0.25, 1e-6);
+  EXPECT_NEAR(field.getCellDistance(13, 14), 0.45, 1e-6);
+
+  // interpolated at a cell center is that cell's distance, halfway is their mean
+  double distance = 0.0;
+  Eigen::Vector2d gradient;
+  EXPECT_TRUE(field.getDistance(1.35, 1.05, distance, gradient));
+  EXPECT_NEAR(distance, 0.25, 1e-6);
+  EXPECT_NEAR(gradient[0], 1.0, 1e-6);
+  EXPECT_TRUE(field.getDistance(1.40, 1.05, distance, gradient));
+  EXPECT_NEAR(distance, 0.30, 1e-6);
+  EXPECT_NEAR(gradient[0], 1.0, 1e-6);
+
+  // gradient points away from the obstacle
+  EXPECT_TRUE(field.getDistance(0.7, 0.72, distance, gradient));
+  EXPECT_LT(gradient[0], 0.0);
+  EXPECT_LT(gradient[1], 0.0);
+  EXPECT_FALSE(field.getDistance(-0.1, 1.0, distance, gradient));
+
+  // windows only see obstacles within them
+  field.update(costmap, 0, 0, 5, 5);
+  EXPECT_NEAR(field.getCellDistance(4, 4), 0.5, 1e-6);
+  EXPECT_TRUE(field.getDistance(0.3, 0.3, distance, gradient));
+  EXPECT_FALSE(field.getDistance(1.0, 1.0, distance, gradient));
+
+  // cost function gradient matches its finite differences about an obstacle
+  field.update(costmap, 0, 0, 20, 20);
+  std::vector<Eigen::Vector2d> path = {
+    Eigen::Vector2d(0.62, 0.93), Eigen::Vector2d(0.87, 1.01), Eigen::Vector2d(1.13, 0.83)};
+  nav2_smac_planner::SmootherParams smoother_params;
+  smoother_params.costmap_weight = 1.0;
+  smoother_params.costmap_factor = 10.0;
+  nav2_smac_planner::UnconstrainedSmootherCostFunction cost_function(
+    &path, &field, smoother_params);
+  double parameters[6] = {0.62, 0.93, 0.87, 1.01, 1.13, 0.83};
+  double cost = 0.0, cost_plus = 0.0, cost_minus = 0.0;
+  double analytic_gradient[6], unused_gradient[6];
+  EXPECT_TRUE(cost_function.Evaluate(parameters, &cost, analytic_gradient));
+  EXPECT_GT(cost, 0.0);
+  for (unsigned int i = 2; i != 4; i++) {
+    const double step = 1e-6;
+    parameters[i] += step;
+    cost_function.Evaluate(parameters, &cost_plus, unused_gradient);
+    parameters[i] -= 2.0 * step;
+    cost_function.Evaluate(parameters, &cost_minus, unused_gradient);
+    parameters[i] += step;
+    EXPECT_NEAR(
+      analytic_gradient[i], (cost_plus - cost_minus) / (2.0 * step),
+      1e-4 * std::max(1.0, fabs(analytic_gradient[i])));
+  }
+
+  delete costmap;
+}
+
+TEST(SmootherTest, test_windowed_smoother)
+{
+  nav2_costmap_2d::Costmap2D * costmap = new nav2_costmap_2d::Costmap2D(100, 100, 0.05, 0, 0, 0);
+
+  // a long zig-zagging path
+  std::vector<Eigen::Vector2d> path;
+  for (unsigned int i = 0; i != 500; i++) {
+    path.push_back(Eigen::Vector2d(0.01 * i, i % 2 == 0 ? 0.0 : 0.01));
+  }
+  const std::vector<Eigen::Vector2d> initial_path = path;
+
+  auto roughness = [](const std::vector<Eigen::Vector2d> & pts) -> double
+    {
+      double sum = 0.0;
+      for (unsigned int i = 1; i != pts.size() - 1; i++) {
+        sum += (pts[i + 1] - 2.0 * pts[i] + pts[i - 1]).squaredNorm();
+      }
+      return sum;
+    };
+
+  nav2_smac_planner::OptimizerParams params;
+  params.window_size = 40;
+  params.window_overlap = 10;
+  params.num_threads = 2;
+
+  nav2_smac_planner::SmootherParams smoother_params;
+  smoother_params.smooth_weight = 1.0;
+  smoother_params.max_time = 10.0;
+
+  nav2_smac_planner::Smoother smoother;
+  smoother.initialize(params);
+  EXPECT_TRUE(smoother.smooth(path, costmap, smoother_params));
+
+  // kept at the right size, with its endpoints fixed and smoother throughout
+  EXPECT_EQ(path.size(), initial_path.size());
+  EXPECT_EQ(path.front(), initial_path.front());
+  EXPECT_EQ(path.back(), initial_path.back());
+  EXPECT_LT(roughness(path), 0.1 * roughness(initial_path));
+
+  // no part of the path is left unsmoothed, including where windows meet
+  for (unsigned int i = 1; i != path.size() - 1; i++) {
+    EXPECT_LT(fabs(path[i][1] - 0.005), 0.005) << "at point " << i;
+  }
+
+  // smoothing the same path again reuses the same buffers
+  path = initial_path;
+  EXPECT_TRUE(smoother.smooth(path, costmap, smoother_params));
+  EXPECT_EQ(path.size(), initial_path.size());
+
+  delete costmap;
+}